@@ -13,6 +13,7 @@
 # -----------------------------------------------------------------------------
 option(BUILD_LIBD_TESTS "Build libd Googletest test suite." ON)
 option(BUILD_LIBD_PYTHON "Build libd Googletest test suite." ON)
+option(BUILD_LIBD_BENCHMARKS "Build libd benchmark executable." OFF)
 
 
 #------------------------------------------------------------------------------
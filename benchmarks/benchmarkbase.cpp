@@ -0,0 +1,172 @@
+#include "benchmarkbase.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace {
+std::atomic<std::uint64_t> allocationCounter{0};
+std::atomic<std::uint64_t> allocatedByteCounter{0};
+std::uint64_t scaleFactor = 1;
+
+struct Registration
+{
+  std::string suite;
+  std::string name;
+  LIBD::BENCHMARKS::BenchmarkBase::Body body;
+};
+
+std::vector<Registration>& getRegistry()
+{
+  static std::vector<Registration> registry;
+  return registry;
+}
+
+void* countedAllocation(std::size_t size)
+{
+  allocationCounter.fetch_add(1, std::memory_order_relaxed);
+  allocatedByteCounter.fetch_add(size, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void* countedAlignedAllocation(std::size_t size, std::align_val_t alignment)
+{
+  allocationCounter.fetch_add(1, std::memory_order_relaxed);
+  allocatedByteCounter.fetch_add(size, std::memory_order_relaxed);
+  auto const align = static_cast<std::size_t>(alignment);
+  // std::aligned_alloc requires the size to be a multiple of the alignment
+  std::size_t const rounded = size ? (size + align - 1) / align * align : align;
+  if (void* ptr = std::aligned_alloc(align, rounded))
+    return ptr;
+  throw std::bad_alloc();
+}
+}  // namespace
+
+// Replace the global allocation functions to record heap activity of everything measured.
+void* operator new(std::size_t size)
+{
+  return countedAllocation(size);
+}
+
+void* operator new[](std::size_t size)
+{
+  return countedAllocation(size);
+}
+
+// std::pmr::new_delete_resource allocates through the aligned overloads.
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+  return countedAlignedAllocation(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+  return countedAlignedAllocation(size, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+namespace LIBD {
+namespace BENCHMARKS {
+
+BenchmarkBase::BenchmarkBase(std::string name) :
+    name_(std::move(name))
+{}
+
+bool BenchmarkBase::add(char const* suite, char const* name, Body body)
+{
+  getRegistry().push_back(Registration{suite, name, body});
+  return true;
+}
+
+int BenchmarkBase::runAll(std::string const& filter)
+{
+  int count = 0;
+  for (auto const& r : getRegistry()) {
+    std::string fullName = r.suite + "." + r.name;
+    if (fullName.find(filter) == std::string::npos)
+      continue;
+    std::printf("[ RUN      ] %s\n", fullName.c_str());
+    BenchmarkBase bench(fullName);
+    r.body(bench);
+    std::printf("[     DONE ] %s\n", fullName.c_str());
+    ++count;
+  }
+  return count;
+}
+
+std::uint64_t BenchmarkBase::scale()
+{
+  return scaleFactor;
+}
+
+void BenchmarkBase::setScale(std::uint64_t scale)
+{
+  scaleFactor = scale ? scale : 1;
+}
+
+std::uint64_t BenchmarkBase::allocationCount()
+{
+  return allocationCounter.load(std::memory_order_relaxed);
+}
+
+std::uint64_t BenchmarkBase::allocatedBytes()
+{
+  return allocatedByteCounter.load(std::memory_order_relaxed);
+}
+
+void BenchmarkBase::note(std::string const& label, std::string const& value) const
+{
+  std::printf("  %-56s %s\n", label.c_str(), value.c_str());
+}
+
+void BenchmarkBase::print(std::string const& label, std::uint64_t iterations, double ns,
+                          double allocations, double bytes) const
+{
+  std::printf("  %-56s %10llu it %14.2f ns/it %10.2f allocs/it %12.1f B/it\n", label.c_str(),
+              static_cast<unsigned long long>(iterations), ns, allocations, bytes);
+}
+
+}  // namespace BENCHMARKS
+}  // namespace LIBD
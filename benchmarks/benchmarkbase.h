@@ -0,0 +1,100 @@
+#ifndef LIBD_BENCHMARKS_BENCHMARKBASE_H
+#define LIBD_BENCHMARKS_BENCHMARKBASE_H
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace LIBD {
+namespace BENCHMARKS {
+
+/*! \brief Minimal benchmark harness for the libd_benchmarks executable.
+ *
+ * Benchmarks are registered with the D_BENCHMARK macro below. Every call of 'measure' runs a
+ * callable a given number of times and prints the mean time per iteration together with the
+ * number of heap allocations and allocated bytes per iteration. Heap activity is recorded by
+ * replacing the global operator new, see benchmarkbase.cpp.
+ *
+ * Problem sizes can be scaled from the command line (--scale=N) to get stable numbers on fast
+ * machines or quick runs on slow ones.
+ */
+class BenchmarkBase
+{
+  public:
+  //! Signature of a registered benchmark body.
+  using Body = void (*)(BenchmarkBase&);
+
+  //! Register a benchmark. Used by the D_BENCHMARK macro, the return value is meaningless.
+  static bool add(char const* suite, char const* name, Body body);
+
+  //! Run all benchmarks whose "Suite.Name" contains the filter string, return how many were run.
+  static int runAll(std::string const& filter);
+
+  //! Problem size scaling factor, 1 by default.
+  static std::uint64_t scale();
+  static void setScale(std::uint64_t scale);
+
+  //! Number of heap allocations and allocated bytes since program start.
+  static std::uint64_t allocationCount();
+  static std::uint64_t allocatedBytes();
+
+  /*! \brief Time 'iterations' calls of f and print one result line.
+   *
+   * f is called once before the measurement starts to warm up caches.
+   * Returns the mean time per iteration in nanoseconds.
+   */
+  template <typename F>
+  double measure(std::string const& label, std::uint64_t iterations, F&& f)
+  {
+    f();
+    auto const allocations = allocationCount();
+    auto const bytes = allocatedBytes();
+    auto const start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      f();
+    }
+    auto const stop = std::chrono::steady_clock::now();
+    double const n = iterations ? double(iterations) : 1.0;
+    double const ns = std::chrono::duration<double, std::nano>(stop - start).count() / n;
+    print(label, iterations, ns, double(allocationCount() - allocations) / n,
+          double(allocatedBytes() - bytes) / n);
+    return ns;
+  }
+
+  //! Print a free-form result line, e.g. a memory footprint or a speedup factor.
+  void note(std::string const& label, std::string const& value) const;
+
+  private:
+  explicit BenchmarkBase(std::string name);
+
+  void print(std::string const& label, std::uint64_t iterations, double ns, double allocations,
+             double bytes) const;
+
+  std::string name_;
+};
+
+//! Prevent the compiler from optimizing away the computation of a value.
+template <typename T>
+inline void doNotOptimize(T const& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}  // namespace BENCHMARKS
+}  // namespace LIBD
+
+/*! \brief Define and register a benchmark.
+ *
+ * The benchmark body receives the harness object as 'bench':
+ *
+ * D_BENCHMARK(VariantBenchmarks, copy)
+ * {
+ *   bench.measure("copy", 1000, [&]() { ... });
+ * }
+ */
+#define D_BENCHMARK(SUITE, NAME)                                                             \
+  static void SUITE##_##NAME(LIBD::BENCHMARKS::BenchmarkBase&);                              \
+  [[maybe_unused]] static bool const SUITE##_##NAME##_registered                             \
+      = LIBD::BENCHMARKS::BenchmarkBase::add(#SUITE, #NAME, &SUITE##_##NAME);                \
+  static void SUITE##_##NAME([[maybe_unused]] LIBD::BENCHMARKS::BenchmarkBase& bench)
+
+#endif  // LIBD_BENCHMARKS_BENCHMARKBASE_H
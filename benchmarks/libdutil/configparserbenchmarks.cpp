@@ -0,0 +1,128 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "benchmarks/benchmarkbase.h"
+#include "libdutil/configparser.h"
+
+using namespace DUTIL;
+
+namespace {
+// A simulation config like those loaded at startup: scalar settings, two detector sections and a
+// calibration table of 64 rows.
+std::string makeConfig(std::size_t index)
+{
+  std::string text = "# simulation " + std::to_string(index) + "\n";
+  text += "Solver = CONJUGATE_GRADIENT\nTolerance = 1e-8\nMaximumIterations = 2500\n";
+  text += "Title = \"instrument " + std::to_string(index) + " \\\"reference\\\"\"\n";
+  for (std::size_t i = 0; i < 24; ++i) {
+    text += "SourceParameter" + std::to_string(i) + " = " + std::to_string(0.125 * double(i + index))
+            + "\n";
+  }
+  for (char const* detector : {"Front", "Back"}) {
+    text += std::string("\n[Detector]\nName = ") + detector + "\nGain = 2.5\nChannels = 128\n";
+    text += "@dataset FLOAT64 2 = [\n";
+    for (std::size_t row = 0; row < 64; ++row) {
+      text += "  " + std::to_string(double(row) * 0.01) + ", " + std::to_string(1.0 / double(row + 1))
+              + "\n";
+    }
+    text += "]\n\n[Detector.Pixel]\nThreshold = 0.75\nDeadTime = 1.2e-7\n";
+  }
+  return text;
+}
+
+std::string readWholeFile(std::string const& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+}  // namespace
+
+D_BENCHMARK(ConfigParserBenchmarks, loadConfigs)
+{
+  std::size_t const n = 1000 * bench.scale();
+  auto const directory = std::filesystem::temp_directory_path() / "libd_configparserbenchmarks";
+  std::filesystem::create_directories(directory);
+
+  std::vector<std::string> texts;
+  std::vector<std::string> paths;
+  std::size_t bytes = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    texts.push_back(makeConfig(i));
+    paths.push_back((directory / ("config" + std::to_string(i) + ".ini")).string());
+    std::ofstream(paths.back(), std::ios::binary) << texts.back();
+    bytes += texts.back().size();
+  }
+  double const mb = double(bytes) / 1e6;
+  bench.note("configs per iteration", std::to_string(n));
+  bench.note("bytes per config", std::to_string(bytes / n));
+
+  double const textNs = bench.measure("parse texts", 3, [&]() {
+    for (auto const& text : texts) {
+      auto cd = ConfigParser::parse(text);
+      LIBD::BENCHMARKS::doNotOptimize(cd);
+    }
+  });
+  double const mappedNs = bench.measure("parse files", 3, [&]() {
+    for (auto const& path : paths) {
+      auto cd = ConfigParser::parseFile(path);
+      LIBD::BENCHMARKS::doNotOptimize(cd);
+    }
+  });
+  double const streamNs = bench.measure("read files with ifstream, then parse", 3, [&]() {
+    for (auto const& path : paths) {
+      auto cd = ConfigParser::parse(readWholeFile(path), path);
+      LIBD::BENCHMARKS::doNotOptimize(cd);
+    }
+  });
+  double const arenaNs = bench.measure("parse files into one arena", 3, [&]() {
+    std::pmr::monotonic_buffer_resource arena;
+    std::vector<ConstructionData> configs;
+    configs.reserve(n);
+    for (auto const& path : paths) {
+      configs.push_back(ConfigParser::parseFile(path, &arena));
+    }
+    LIBD::BENCHMARKS::doNotOptimize(configs);
+  });
+
+  bench.note("throughput, texts [MB/s]", std::to_string(mb / (textNs * 1e-9)));
+  bench.note("throughput, files [MB/s]", std::to_string(mb / (mappedNs * 1e-9)));
+  bench.note("throughput, ifstream [MB/s]", std::to_string(mb / (streamNs * 1e-9)));
+  bench.note("throughput, files into arena [MB/s]", std::to_string(mb / (arenaNs * 1e-9)));
+  bench.note("configs per second, files", std::to_string(double(n) / (mappedNs * 1e-9)));
+
+  std::filesystem::remove_all(directory);
+}
+
+D_BENCHMARK(ConfigParserBenchmarks, loadLargeDataset)
+{
+  std::size_t const rows = 100000 * bench.scale();
+  auto const path = (std::filesystem::temp_directory_path() / "libd_configparserbenchmarks.ini").string();
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << "Name = \"calibration table\"\n@dataset FLOAT64 4 = [\n";
+    for (std::size_t row = 0; row < rows; ++row) {
+      file << double(row) * 0.5 << ", " << 1.0 / double(row + 1) << ", " << double(row % 97) << ", "
+           << -1.25e-3 * double(row) << "\n";
+    }
+    file << "]\n";
+  }
+  double const mb = double(std::filesystem::file_size(path)) / 1e6;
+  bench.note("file size [MB]", std::to_string(mb));
+
+  double const mappedNs = bench.measure("parse memory-mapped file", 3, [&]() {
+    auto cd = ConfigParser::parseFile(path);
+    LIBD::BENCHMARKS::doNotOptimize(cd);
+  });
+  double const streamNs = bench.measure("read file with ifstream, then parse", 3, [&]() {
+    auto cd = ConfigParser::parse(readWholeFile(path), path);
+    LIBD::BENCHMARKS::doNotOptimize(cd);
+  });
+  bench.note("throughput, memory-mapped [MB/s]", std::to_string(mb / (mappedNs * 1e-9)));
+  bench.note("throughput, ifstream [MB/s]", std::to_string(mb / (streamNs * 1e-9)));
+
+  std::remove(path.c_str());
+}
@@ -0,0 +1,149 @@
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "benchmarks/benchmarkbase.h"
+#include "libdutil/constructiondata.h"
+
+using namespace DUTIL;
+
+namespace {
+// Build a configuration tree like a simulation batch does: one root with a few subobjects, each
+// holding a handful of numbers and some strings too long to be stored inline.
+std::size_t buildTree(ConstructionData::allocator_type const& alloc)
+{
+  ConstructionData root(alloc);
+  root.s.set("name", std::string("root object of the simulation batch"));
+  root.s.set("iterations", label_t(1000));
+  root.s.set("tolerance", 1.0e-8);
+  for (int i = 0; i < 8; ++i) {
+    ConstructionData sub(alloc);
+    sub.s.set("description", std::string("detector element with a long description"));
+    sub.s.set("unit", std::string("millimeter"));
+    sub.s.set("x", 0.5 * i);
+    sub.s.set("y", 1.5 * i);
+    sub.s.set("index", label_t(i));
+    sub.s.set("active", true);
+    root.subObjectData.emplace("Detector;" + std::to_string(i), std::move(sub));
+  }
+  return root.subObjectData.size();
+}
+
+// Allocates from the global heap like the default resource, but never compares equal to it.
+struct HeapResource : std::pmr::memory_resource
+{
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+  {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+  {
+    return this == &other;
+  }
+};
+}  // namespace
+
+D_BENCHMARK(ConstructionDataBenchmarks, buildAndDestroyTrees)
+{
+  std::uint64_t const iterations = 20000 * bench.scale();
+
+  bench.measure("build and destroy tree (global heap)", iterations, [&]() {
+    auto n = buildTree({});
+    LIBD::BENCHMARKS::doNotOptimize(n);
+  });
+
+  // the arena starts from the same buffer in every cycle, release() drops the whole tree at once
+  std::vector<std::byte> buffer(64 * 1024);
+  std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+  bench.measure("build and destroy tree (monotonic arena)", iterations, [&]() {
+    auto n = buildTree(&arena);
+    LIBD::BENCHMARKS::doNotOptimize(n);
+    arena.release();
+  });
+
+  std::pmr::unsynchronized_pool_resource pool;
+  bench.measure("build and destroy tree (pool resource)", iterations, [&]() {
+    auto n = buildTree(&pool);
+    LIBD::BENCHMARKS::doNotOptimize(n);
+  });
+
+  bench.note("remaining allocations",
+             "string arguments passed by value and the shared buffer of each Dataset");
+}
+
+D_BENCHMARK(ConstructionDataBenchmarks, deepCopies)
+{
+  std::uint64_t const iterations = 20000 * bench.scale();
+
+  // a root with 8 subobjects carrying 50 settings each
+  ConstructionData root;
+  for (int i = 0; i < 8; ++i) {
+    ConstructionData sub;
+    for (int k = 0; k < 50; ++k) {
+      sub.s.set("DetectorElementParameter" + std::to_string(k), 0.5 * k);
+    }
+    sub.s.set("description", std::string("detector element with a long description"));
+    root.subObjectData.emplace("Detector;" + std::to_string(i), std::move(sub));
+  }
+
+  bench.measure("copy tree, settings shared", iterations, [&]() {
+    ConstructionData copy = root;
+    LIBD::BENCHMARKS::doNotOptimize(copy);
+  });
+  bench.measure("copy tree and change one setting per subobject", iterations, [&]() {
+    ConstructionData copy = root;
+    for (auto& sub : copy.subObjectData) {
+      sub.second.s.set("description", 1.0);
+    }
+    LIBD::BENCHMARKS::doNotOptimize(copy);
+  });
+  // entries are never shared across memory resources, so this is a full deep copy
+  HeapResource heap;
+  bench.measure("deep copy of the tree", iterations, [&]() {
+    ConstructionData copy(root, &heap);
+    LIBD::BENCHMARKS::doNotOptimize(copy);
+  });
+  bench.measure("copy one subobject", iterations * 8, [&]() {
+    ConstructionData copy = root.subObjectData.begin()->second;
+    LIBD::BENCHMARKS::doNotOptimize(copy);
+  });
+}
+
+D_BENCHMARK(ConstructionDataBenchmarks, reconfigurationDiff)
+{
+  std::uint64_t const iterations = 2000 * bench.scale();
+
+  // 64 detectors with 32 settings each, the new configuration changes a single value
+  ConstructionData current;
+  for (int i = 0; i < 64; ++i) {
+    ConstructionData detector;
+    for (int k = 0; k < 32; ++k) {
+      detector.s.set("parameter" + std::to_string(k), 0.25 * (i + k));
+    }
+    detector.ds = Dataset(std::vector<double>(256, 0.5 * i));
+    current.subObjectData.emplace("Detector;" + std::to_string(i), std::move(detector));
+  }
+  ConstructionData reloaded(current, {});
+  for (auto& entry : reloaded.subObjectData) {
+    // a reloaded configuration shares nothing with the running one
+    entry.second.s = Settings(entry.second.s, std::pmr::polymorphic_allocator<char>());
+    entry.second.s.set("parameter0", entry.second.s.value("parameter0"));
+    entry.second.ds = Dataset(entry.second.ds.getValues<double>());
+  }
+  reloaded.subObjectData.at("Detector;17").s.set("parameter5", -1.0);
+
+  bench.measure("diff reloaded tree, one value changed", iterations, [&]() {
+    auto diff = current.diff(reloaded);
+    LIBD::BENCHMARKS::doNotOptimize(diff);
+  });
+  ConstructionData patched = current;
+  patched.subObjectData.at("Detector;17").s.set("parameter5", -1.0);
+  bench.measure("diff copy-on-write tree, one value changed", iterations, [&]() {
+    auto diff = current.diff(patched);
+    LIBD::BENCHMARKS::doNotOptimize(diff);
+  });
+  bench.note("objects to rebuild", std::to_string(current.diff(reloaded).changedPaths().size()) + " of 65");
+}
@@ -0,0 +1,96 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "benchmarks/benchmarkbase.h"
+#include "libdutil/conversion.h"
+#include "libdutil/utility.h"
+
+using namespace DUTIL;
+
+namespace {
+// Reproduction of the previous std::stoll/std::stod based string to number conversion.
+template <typename T>
+std::pair<bool, T> legacyFromString(std::string value)
+{
+  Utility::replaceDecimalSeperator(',', '.', value);
+  try {
+    if constexpr (std::is_same_v<T, double>) {
+      return {true, std::stod(value)};
+    } else if constexpr (std::is_unsigned_v<T>) {
+      if (value.front() == '-')
+        value.erase(value.begin());
+      return {true, static_cast<T>(std::stoull(value))};
+    } else {
+      return {true, static_cast<T>(std::stoll(value))};
+    }
+  } catch (std::exception const&) {
+    return {false, T()};
+  }
+}
+
+std::vector<std::string> makeInput(std::size_t n, bool real)
+{
+  std::vector<std::string> input;
+  input.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    input.push_back(real ? std::to_string(double(i) * 1.25 - 1000.0) : std::to_string(i * 7919));
+  }
+  return input;
+}
+
+template <typename T>
+void compareParsers(LIBD::BENCHMARKS::BenchmarkBase& bench, std::string const& typeName,
+                    std::vector<std::string> const& input)
+{
+  double legacyNs = bench.measure("legacy parse " + typeName, 20, [&]() {
+    T sum = 0;
+    for (auto const& str : input)
+      sum += legacyFromString<T>(str).second;
+    LIBD::BENCHMARKS::doNotOptimize(sum);
+  });
+  double newNs = bench.measure("fromChars parse " + typeName, 20, [&]() {
+    T sum = 0;
+    for (auto const& str : input)
+      sum += Conversion::fromChars<T>(str).value;
+    LIBD::BENCHMARKS::doNotOptimize(sum);
+  });
+  std::size_t bytes = 0;
+  for (auto const& str : input)
+    bytes += str.size();
+  double const mb = double(bytes) / 1e6;
+  bench.note("fromChars throughput " + typeName + " [MB/s]", std::to_string(mb / (newNs * 1e-9)));
+  bench.note("speedup " + typeName, std::to_string(legacyNs / newNs));
+}
+}  // namespace
+
+D_BENCHMARK(ConversionBenchmarks, parseThroughputPerType)
+{
+  std::size_t const n = 20000 * bench.scale();
+  auto const integers = makeInput(n, false);
+  auto const reals = makeInput(n, true);
+  bench.note("strings per iteration", std::to_string(n));
+
+  compareParsers<label_t>(bench, "label_t", integers);
+  compareParsers<std::int64_t>(bench, "int64", integers);
+  compareParsers<std::uint64_t>(bench, "uint64", integers);
+  compareParsers<double>(bench, "double", reals);
+}
+
+D_BENCHMARK(ConversionBenchmarks, invalidInput)
+{
+  std::size_t const n = 2000 * bench.scale();
+  std::vector<std::string> const input(n, "not a number");
+
+  bench.measure("legacy parse invalid (exception)", 20, [&]() {
+    std::size_t failures = 0;
+    for (auto const& str : input)
+      failures += !legacyFromString<double>(str).first;
+    LIBD::BENCHMARKS::doNotOptimize(failures);
+  });
+  bench.measure("fromChars parse invalid (error code)", 20, [&]() {
+    std::size_t failures = 0;
+    for (auto const& str : input)
+      failures += !Conversion::fromChars<double>(str).hasValue();
+    LIBD::BENCHMARKS::doNotOptimize(failures);
+  });
+}
@@ -0,0 +1,206 @@
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include "benchmarks/benchmarkbase.h"
+#include "libdutil/dataset.h"
+#include "libdutil/datasetfile.h"
+
+using namespace DUTIL;
+
+D_BENCHMARK(DatasetBenchmarks, constructFromLargeArray)
+{
+  std::size_t const n = 8 * 1000 * 1000 * bench.scale();
+  bench.note("values", std::to_string(n));
+  bench.note("array size [MB]", std::to_string(double(n * sizeof(double)) / 1e6));
+
+  auto const makeTicks = [n]() {
+    std::vector<double> ticks(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      ticks[i] = 100.0 + 0.01 * double(i % 1000);
+    }
+    return ticks;
+  };
+
+  std::vector<double> const ticks = makeTicks();
+  bench.measure("copy vector into Dataset", 5, [&]() {
+    Dataset ds(ticks);
+    LIBD::BENCHMARKS::doNotOptimize(ds);
+  });
+
+  // one vector per call, measure() calls once more to warm up
+  std::vector<std::vector<double>> pool(6, ticks);
+  std::size_t next = 0;
+  bench.measure("move vector into Dataset", 5, [&]() {
+    Dataset ds(std::move(pool[next++]));
+    LIBD::BENCHMARKS::doNotOptimize(ds);
+  });
+
+  auto const owner = std::make_shared<std::vector<double> const>(ticks);
+  bench.measure("wrap external buffer", 5, [&]() {
+    Dataset ds(owner->data(), owner->size(), owner);
+    LIBD::BENCHMARKS::doNotOptimize(ds);
+  });
+}
+
+D_BENCHMARK(DatasetBenchmarks, elementAccess)
+{
+  label_t const rows = 100000 * label_t(bench.scale());
+  label_t const cols = 8;
+  std::vector<float> values(std::size_t(rows * cols));
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    values[i] = float(i % 1000) * 0.5f;
+  }
+  Dataset const ds(std::move(values), cols);
+  bench.note("items", std::to_string(rows * cols));
+
+  double const getValueNs = bench.measure("getValue<float>, matching type", 5, [&]() {
+    float sum = 0;
+    for (label_t i = 0; i < rows; ++i) {
+      for (label_t j = 0; j < cols; ++j) {
+        sum += ds.getValue<float>(i, j);
+      }
+    }
+    LIBD::BENCHMARKS::doNotOptimize(sum);
+  });
+  bench.measure("getValue<double>, converting type", 5, [&]() {
+    double sum = 0;
+    for (label_t i = 0; i < rows; ++i) {
+      for (label_t j = 0; j < cols; ++j) {
+        sum += ds.getValue<double>(i, j);
+      }
+    }
+    LIBD::BENCHMARKS::doNotOptimize(sum);
+  });
+  double const checkedNs = bench.measure("view<float>().at", 5, [&]() {
+    auto const v = ds.view<float>();
+    float sum = 0;
+    for (label_t i = 0; i < v.rows(); ++i) {
+      for (label_t j = 0; j < v.cols(); ++j) {
+        sum += v.at(i, j);
+      }
+    }
+    LIBD::BENCHMARKS::doNotOptimize(sum);
+  });
+  double const uncheckedNs = bench.measure("view<float>() operator()", 5, [&]() {
+    auto const v = ds.view<float>();
+    float sum = 0;
+    for (label_t i = 0; i < v.rows(); ++i) {
+      for (label_t j = 0; j < v.cols(); ++j) {
+        sum += v(i, j);
+      }
+    }
+    LIBD::BENCHMARKS::doNotOptimize(sum);
+  });
+  double const rawNs = bench.measure("raw pointer loop", 5, [&]() {
+    float const* p = ds.getRawData<float>();
+    float sum = 0;
+    for (label_t k = 0; k < rows * cols; ++k) {
+      sum += p[k];
+    }
+    LIBD::BENCHMARKS::doNotOptimize(sum);
+  });
+  bench.note("speedup view over getValue", std::to_string(getValueNs / uncheckedNs));
+  bench.note("view at() / operator()", std::to_string(checkedNs / uncheckedNs));
+  bench.note("view operator() / raw pointer", std::to_string(uncheckedNs / rawNs));
+}
+
+D_BENCHMARK(DatasetBenchmarks, repeatedConversions)
+{
+  std::size_t const n = 1000 * 1000 * bench.scale();
+  std::vector<float> prices(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    prices[i] = 100.0f + 0.01f * float(i % 1000);
+  }
+  Dataset ds(std::move(prices));
+  bench.note("values", std::to_string(n));
+
+  // a model asking for the double values of a float column on each evaluation
+  std::size_t const calls = 20;
+  double const plainNs = bench.measure("20x getPointerToValues<double>", 3, [&]() {
+    for (std::size_t i = 0; i < calls; ++i) {
+      auto values = ds.getPointerToValues<double>();
+      LIBD::BENCHMARKS::doNotOptimize(values);
+    }
+  });
+  double const cachedNs = bench.measure("20x getPointerToValues<double>, cached", 3, [&]() {
+    Dataset cached = ds;
+    cached.enableConversionCache();
+    for (std::size_t i = 0; i < calls; ++i) {
+      auto values = cached.getPointerToValues<double>();
+      LIBD::BENCHMARKS::doNotOptimize(values);
+    }
+  });
+  bench.note("speedup", std::to_string(plainNs / cachedNs));
+}
+
+D_BENCHMARK(DatasetBenchmarks, loadBinaryFile)
+{
+  std::size_t const n = 16 * 1000 * 1000 * bench.scale();
+  std::vector<double> prices(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    prices[i] = 100.0 + 0.01 * double(i % 1000);
+  }
+  Dataset const ds(std::move(prices), 8);
+  auto const path = (std::filesystem::temp_directory_path() / "libd_datasetbenchmarks.dds").string();
+  bench.note("file size [MB]", std::to_string(double(n * sizeof(double)) / 1e6));
+
+  bench.measure("write", 2, [&]() { DatasetFile::write(ds, path); });
+  double const openNs = bench.measure("load, values untouched", 20, [&]() {
+    Dataset loaded = DatasetFile::load(path);
+    LIBD::BENCHMARKS::doNotOptimize(loaded);
+  });
+  bench.measure("load and read one column", 3, [&]() {
+    Dataset loaded = DatasetFile::load(path);
+    auto const column = loaded.view<double>().column(3);
+    double sum = 0;
+    for (label_t i = 0; i < column.rows(); ++i) {
+      sum += column(i, 0);
+    }
+    LIBD::BENCHMARKS::doNotOptimize(sum);
+  });
+  double const verifyNs = bench.measure("load with checksum verification", 3, [&]() {
+    Dataset loaded = DatasetFile::load(path, true);
+    LIBD::BENCHMARKS::doNotOptimize(loaded);
+  });
+  bench.note("open time [us]", std::to_string(openNs * 1e-3));
+  bench.note("checksum throughput [GB/s]", std::to_string(double(n * sizeof(double)) / verifyNs));
+  std::remove(path.c_str());
+}
+
+D_BENCHMARK(DatasetBenchmarks, slidingWindows)
+{
+  // a backtest evaluating the close column over every window of 250 rows, stepping by 5 rows
+  std::size_t const rows = 50 * 1000 * bench.scale();
+  label_t constexpr window = 250;
+  std::vector<double> bars(rows * 4);
+  for (std::size_t i = 0; i < bars.size(); ++i) {
+    bars[i] = 100.0 + 0.01 * double(i % 1000);
+  }
+  Dataset const ds(std::move(bars), 4);
+  label_t const windows = (ds.getRows() - window) / 5;
+  bench.note("windows", std::to_string(windows));
+
+  bench.measure("copy window with getValues", 1, [&]() {
+    double total = 0;
+    for (label_t w = 0; w < windows; ++w) {
+      auto const values = ds.getValues<double>();
+      for (label_t i = 5 * w; i < 5 * w + window; ++i) {
+        total += values[std::size_t(4 * i + 3)];
+      }
+    }
+    LIBD::BENCHMARKS::doNotOptimize(total);
+  });
+  bench.measure("rows and columns selection", 3, [&]() {
+    double total = 0;
+    Dataset const closes = ds.columns({3});
+    for (label_t w = 0; w < windows; ++w) {
+      auto const values = closes.rows(5 * w, 5 * w + window).view<double>();
+      for (label_t i = 0; i < values.rows(); ++i) {
+        total += values(i, 0);
+      }
+    }
+    LIBD::BENCHMARKS::doNotOptimize(total);
+  });
+}
@@ -0,0 +1,84 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "benchmarks/benchmarkbase.h"
+#include "libdutil/datasetcsv.h"
+
+using namespace DUTIL;
+
+namespace {
+//! Prices with two decimals in 'cols' columns, about 7 bytes per value.
+Dataset makePrices(std::size_t rows, label_t cols)
+{
+  std::vector<double> prices(rows * std::size_t(cols));
+  for (std::size_t i = 0; i < prices.size(); ++i) {
+    prices[i] = 100.0 + 0.01 * double(i % 10000);
+  }
+  return Dataset(std::move(prices), cols);
+}
+
+//! Straightforward reader as found in many code bases: getline, stringstream and operator>>.
+std::vector<double> readNaive(std::string const& path)
+{
+  std::vector<double> values;
+  std::ifstream file(path);
+  std::string line;
+  std::string field;
+  while (std::getline(file, line)) {
+    std::stringstream row(line);
+    while (std::getline(row, field, ',')) {
+      std::stringstream(field) >> values.emplace_back();
+    }
+  }
+  return values;
+}
+
+//! Straightforward writer with operator<< on an ofstream.
+void writeNaive(Dataset const& ds, std::string const& path)
+{
+  std::ofstream file(path);
+  file.precision(17);
+  auto const view = ds.view<double>();
+  for (label_t i = 0; i < view.rows(); ++i) {
+    for (label_t j = 0; j < view.cols(); ++j) {
+      file << (j ? "," : "") << view(i, j);
+    }
+    file << '\n';
+  }
+}
+}  // namespace
+
+D_BENCHMARK(DatasetCSVBenchmarks, readAndWrite)
+{
+  std::size_t const rows = 500 * 1000 * bench.scale();
+  Dataset const ds = makePrices(rows, 8);
+  auto const path = (std::filesystem::temp_directory_path() / "libd_datasetcsvbenchmarks.csv").string();
+  DatasetCSV::write(ds, path);
+  double const megabytes = double(std::filesystem::file_size(path)) / 1e6;
+  bench.note("file size [MB]", std::to_string(megabytes));
+
+  double const naiveNs = bench.measure("read, getline and stringstream", 1, [&]() {
+    LIBD::BENCHMARKS::doNotOptimize(readNaive(path));
+  });
+  DatasetCSV::Options options;
+  options.type = Dataset::Type::FLOAT64;
+  options.threads = 1;
+  double const singleNs = bench.measure("read, from_chars on 1 thread", 3, [&]() {
+    LIBD::BENCHMARKS::doNotOptimize(DatasetCSV::read(path, options));
+  });
+  double const inferNs = bench.measure("read, from_chars, type inferred", 3, [&]() {
+    LIBD::BENCHMARKS::doNotOptimize(DatasetCSV::read(path));
+  });
+  bench.note("naive read [MB/s]", std::to_string(megabytes / naiveNs * 1e9));
+  bench.note("single thread read [MB/s]", std::to_string(megabytes / singleNs * 1e9));
+  bench.note("parallel read with inference [MB/s]", std::to_string(megabytes / inferNs * 1e9));
+
+  double const naiveWriteNs = bench.measure("write, ofstream operator<<", 1, [&]() { writeNaive(ds, path); });
+  double const writeNs = bench.measure("write, to_chars and buffer", 3, [&]() { DatasetCSV::write(ds, path); });
+  bench.note("naive write [MB/s]", std::to_string(megabytes / naiveWriteNs * 1e9));
+  bench.note("buffered write [MB/s]", std::to_string(megabytes / writeNs * 1e9));
+  std::remove(path.c_str());
+}
@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include "benchmarks/benchmarkbase.h"
+#include "libdutil/datasetrolling.h"
+
+using namespace DUTIL;
+
+namespace {
+Dataset makePrices(std::size_t rows, label_t cols)
+{
+  std::vector<double> prices(rows * std::size_t(cols));
+  for (std::size_t i = 0; i < prices.size(); ++i) {
+    prices[i] = 100.0 + 0.01 * double((i * 7919) % 10007);
+  }
+  return Dataset(std::move(prices), cols);
+}
+
+//! Recompute mean and max of every window from scratch, O(n * window).
+template <bool MAXIMUM>
+std::vector<double> naiveRolling(Dataset const& ds, label_t window)
+{
+  auto const values = ds.getValues<double>();
+  std::size_t const cols = std::size_t(ds.getCols());
+  std::vector<double> result(values.size(), 0.0);
+  for (std::size_t j = 0; j < cols; ++j) {
+    for (std::size_t i = std::size_t(window) - 1; i < std::size_t(ds.getRows()); ++i) {
+      double value = MAXIMUM ? values[i * cols + j] : 0.0;
+      for (std::size_t k = i + 1 - std::size_t(window); k <= i; ++k) {
+        value = MAXIMUM ? std::max(value, values[k * cols + j]) : value + values[k * cols + j];
+      }
+      result[i * cols + j] = MAXIMUM ? value : value / double(window);
+    }
+  }
+  return result;
+}
+}  // namespace
+
+D_BENCHMARK(DatasetRollingBenchmarks, windowLengths)
+{
+  Dataset const ds = makePrices(1000 * 1000 * bench.scale(), 1);
+  for (label_t window : {20, 250}) {
+    std::string const suffix = ", window " + std::to_string(window);
+    bench.measure("naive mean" + suffix, 1, [&]() { LIBD::BENCHMARKS::doNotOptimize(naiveRolling<false>(ds, window)); });
+    bench.measure("mean" + suffix, 5, [&]() { LIBD::BENCHMARKS::doNotOptimize(DatasetRolling::mean(ds, window)); });
+    bench.measure("naive max" + suffix, 1, [&]() { LIBD::BENCHMARKS::doNotOptimize(naiveRolling<true>(ds, window)); });
+    bench.measure("max" + suffix, 5, [&]() { LIBD::BENCHMARKS::doNotOptimize(DatasetRolling::max(ds, window)); });
+    bench.measure("standard deviation" + suffix, 5, [&]() {
+      LIBD::BENCHMARKS::doNotOptimize(DatasetRolling::standardDeviation(ds, window));
+    });
+  }
+  bench.measure("ema", 5, [&]() { LIBD::BENCHMARKS::doNotOptimize(DatasetRolling::ema(ds, 0.1)); });
+  bench.measure("returns", 5, [&]() { LIBD::BENCHMARKS::doNotOptimize(DatasetRolling::returns(ds)); });
+}
+
+D_BENCHMARK(DatasetRollingBenchmarks, manyColumns)
+{
+  // 64 price columns, one thread against one thread per processor
+  Dataset const ds = makePrices(100 * 1000 * bench.scale(), 64);
+  bench.note("processors", std::to_string(std::max(1u, std::thread::hardware_concurrency())));
+  bench.measure("mean, window 50, 1 thread", 3, [&]() {
+    LIBD::BENCHMARKS::doNotOptimize(DatasetRolling::mean(ds, 50, 1));
+  });
+  bench.measure("mean, window 50, all threads", 3, [&]() {
+    LIBD::BENCHMARKS::doNotOptimize(DatasetRolling::mean(ds, 50));
+  });
+  bench.measure("min, window 50, all threads", 3, [&]() {
+    LIBD::BENCHMARKS::doNotOptimize(DatasetRolling::min(ds, 50));
+  });
+}
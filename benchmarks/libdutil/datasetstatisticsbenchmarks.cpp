@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "benchmarks/benchmarkbase.h"
+#include "libdutil/datasetstatistics.h"
+#include "libdutil/simd.h"
+
+using namespace DUTIL;
+
+namespace {
+template <typename TYPE>
+Dataset makeBars(std::size_t rows, label_t cols)
+{
+  std::vector<TYPE> values(rows * std::size_t(cols));
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<TYPE>(100.0 + 0.01 * double(i % 10007));
+  }
+  return Dataset(std::move(values), cols);
+}
+
+//! The loops found in user code: convert a copy to double, then two passes per column.
+double naiveStatistics(Dataset const& ds)
+{
+  auto const values = ds.getValues<double>();
+  std::size_t const rows = std::size_t(ds.getRows());
+  std::size_t const cols = std::size_t(ds.getCols());
+  double checksum = 0;
+  for (std::size_t j = 0; j < cols; ++j) {
+    double sum = 0;
+    double min = values[j];
+    double max = values[j];
+    for (std::size_t i = 0; i < rows; ++i) {
+      double const x = values[i * cols + j];
+      sum += x;
+      min = std::min(min, x);
+      max = std::max(max, x);
+    }
+    double const mean = sum / double(rows);
+    double m2 = 0;
+    for (std::size_t i = 0; i < rows; ++i) {
+      m2 += (values[i * cols + j] - mean) * (values[i * cols + j] - mean);
+    }
+    checksum += mean + min + max + m2 / double(rows - 1);
+  }
+  return checksum;
+}
+
+void measureStatistics(LIBD::BENCHMARKS::BenchmarkBase& bench, std::string const& name, Dataset const& ds)
+{
+  double const bytes = double(ds.getNumberOfCurrentlyStoredData());
+  double const naiveNs = bench.measure(name + ", naive copy and loops", 3, [&]() {
+    LIBD::BENCHMARKS::doNotOptimize(naiveStatistics(ds));
+  });
+  for (auto summation : {DatasetStatistics::Summation::PLAIN, DatasetStatistics::Summation::PAIRWISE,
+                         DatasetStatistics::Summation::KAHAN}) {
+    double const ns = bench.measure(name + ", " + DatasetStatistics::Summation(summation).toString(), 5, [&]() {
+      LIBD::BENCHMARKS::doNotOptimize(DatasetStatistics::compute(ds, summation));
+    });
+    bench.note(name + ", " + DatasetStatistics::Summation(summation).toString() + " [GB/s]",
+               std::to_string(bytes / ns));
+  }
+  bench.note(name + ", naive [GB/s]", std::to_string(bytes / naiveNs));
+}
+}  // namespace
+
+D_BENCHMARK(DatasetStatisticsBenchmarks, columnStatistics)
+{
+  std::size_t const rows = 2 * 1000 * 1000 * bench.scale();
+  measureStatistics(bench, "1 column double", makeBars<double>(8 * rows, 1));
+  measureStatistics(bench, "8 columns double", makeBars<double>(rows, 8));
+  measureStatistics(bench, "8 columns float", makeBars<float>(rows, 8));
+  measureStatistics(bench, "8 columns int32", makeBars<int32_t>(rows, 8));
+
+  Dataset const ds = makeBars<double>(rows, 8);
+  SIMD::setActiveInstructionSet(SIMD::InstructionSet::SSE2);
+  bench.measure("8 columns double, PAIRWISE, SSE2", 5, [&]() {
+    LIBD::BENCHMARKS::doNotOptimize(DatasetStatistics::compute(ds));
+  });
+  SIMD::setActiveInstructionSet(SIMD::supportedInstructionSet());
+}
+
+D_BENCHMARK(DatasetStatisticsBenchmarks, covariance)
+{
+  std::size_t const rows = 500 * 1000 * bench.scale();
+  Dataset const ds = makeBars<double>(rows, 8);
+  bench.measure("8 x 8 covariance", 3, [&]() {
+    LIBD::BENCHMARKS::doNotOptimize(DatasetStatistics::covariance(ds));
+  });
+}
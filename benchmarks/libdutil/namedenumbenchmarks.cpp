@@ -0,0 +1,79 @@
+#include <string>
+#include "benchmarks/benchmarkbase.h"
+#include "libdutil/constructiondata.h"
+#include "libdutil/constructionvalidator.h"
+#include "libdutil/namedenum.h"
+
+using namespace DUTIL;
+
+namespace {
+D_NAMED_ENUM(LinearSolver, CONJUGATE_GRADIENT, BICONJUGATE_GRADIENT_STABILIZED, GMRES_RESTARTED,
+             DIRECT_LU_DECOMPOSITION)
+D_NAMED_ENUM(Preconditioner, NONE, JACOBI, INCOMPLETE_CHOLESKY, ALGEBRAIC_MULTIGRID)
+D_NAMED_ENUM(TimeIntegration, EXPLICIT_EULER, IMPLICIT_EULER, CRANK_NICOLSON, RUNGE_KUTTA_FOURTH_ORDER)
+D_NAMED_ENUM(BoundaryCondition, DIRICHLET, NEUMANN, ROBIN, PERIODIC_BOUNDARY)
+D_NAMED_ENUM(OutputFormat, PLAIN_TEXT, COMMA_SEPARATED_VALUES, BINARY_LITTLE_ENDIAN, HDF5)
+D_NAMED_ENUM(Interpolation, NEAREST_NEIGHBOUR, LINEAR_INTERPOLATION, CUBIC_SPLINE, AKIMA_SPLINE)
+D_NAMED_ENUM(LogSeverityLevel, TRACE, DEBUG, INFO, WARNING, ERROR, FATAL)
+D_NAMED_ENUM(MeshRefinement, UNIFORM, ADAPTIVE_RESIDUAL_BASED, ADAPTIVE_GRADIENT_BASED)
+
+template <typename... NE>
+ConstructionValidator makeValidator()
+{
+  return ConstructionValidator(
+      {SettingRule::forNamedEnum<NE>(SettingRule::Usage::MANDATORY_NO_DEFAULT, "enum setting")...});
+}
+
+// Store every enum with its last value, either as Type::ENUM or as its name like before.
+template <typename... NE>
+ConstructionData makeData(bool asString)
+{
+  ConstructionData cd;
+  auto store = [&cd, asString](auto ne) {
+    if (asString)
+      cd.s.set(ne.getEnumName(), ne.toString());
+    else
+      cd.setEnum(ne);
+  };
+  (store(NE(static_cast<typename NE::EnumValues>(NE::END_ENTRY - 1))), ...);
+  return cd;
+}
+
+template <typename... NE>
+label_t validateAll(ConstructionValidator const& cv, ConstructionData const& cd)
+{
+  return (label_t(cv.validateNamedEnum<NE>(cd)) + ...);
+}
+
+#define BENCHMARK_ENUMS                                                                          \
+  LinearSolver, Preconditioner, TimeIntegration, BoundaryCondition, OutputFormat, Interpolation, \
+      LogSeverityLevel, MeshRefinement
+}  // namespace
+
+D_BENCHMARK(NamedEnumBenchmarks, constructionDataValidation)
+{
+  ConstructionValidator const cv = makeValidator<BENCHMARK_ENUMS>();
+  std::uint64_t const iterations = 20000 * bench.scale();
+
+  for (bool asString : {true, false}) {
+    std::string const suffix = asString ? " (stored as string)" : " (stored as enum)";
+    ConstructionData const cd = makeData<BENCHMARK_ENUMS>(asString);
+
+    bench.measure("store 8 enums" + suffix, iterations, [&]() {
+      auto data = makeData<BENCHMARK_ENUMS>(asString);
+      LIBD::BENCHMARKS::doNotOptimize(data);
+    });
+    bench.measure("validate 8 enums" + suffix, iterations, [&]() {
+      auto sum = validateAll<BENCHMARK_ENUMS>(cv, cd);
+      LIBD::BENCHMARKS::doNotOptimize(sum);
+    });
+    bench.measure("check construction data" + suffix, iterations, [&]() {
+      auto errors = cv.check(cd);
+      LIBD::BENCHMARKS::doNotOptimize(errors);
+    });
+    bench.measure("copy construction data" + suffix, iterations, [&]() {
+      ConstructionData copy = cd;
+      LIBD::BENCHMARKS::doNotOptimize(copy);
+    });
+  }
+}
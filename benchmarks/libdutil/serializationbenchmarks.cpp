@@ -0,0 +1,71 @@
+#include <string>
+#include "benchmarks/benchmarkbase.h"
+#include "libdutil/serialization.h"
+#include "libdutil/settings.h"
+
+using namespace DUTIL;
+
+namespace {
+Settings makeSettings(std::size_t n)
+{
+  Settings s;
+  for (std::size_t i = 0; i < n; ++i) {
+    std::string key = "key_" + std::to_string(i);
+    switch (i % 4) {
+      case 0:
+        s.set(key, label_t(i));
+        break;
+      case 1:
+        s.set(key, double(i) * 0.25);
+        break;
+      case 2:
+        s.set(key, "value_" + std::to_string(i));
+        break;
+      default:
+        s.set(key, bool(i % 8));
+        break;
+    }
+  }
+  return s;
+}
+
+// Text representation as used so far, one "key=value" line per entry.
+std::string toText(Settings const& s)
+{
+  std::string text;
+  for (auto const& key : s.keys()) {
+    text += key + "=" + s.value(key).toString() + "\n";
+  }
+  return text;
+}
+}  // namespace
+
+D_BENCHMARK(SerializationBenchmarks, settingsRoundTrip)
+{
+  for (std::size_t n : {8u, 64u, 512u}) {
+    Settings const s = makeSettings(n);
+    ByteBuffer buffer;
+    BinaryWriter writer(buffer);
+    s.serialize(writer);
+    std::string const suffix = " (" + std::to_string(n) + " entries)";
+    bench.note("binary size [bytes]" + suffix, std::to_string(buffer.size()));
+    bench.note("text size [bytes]" + suffix, std::to_string(toText(s).size()));
+
+    bench.measure("text serialize" + suffix, 200, [&]() {
+      auto text = toText(s);
+      LIBD::BENCHMARKS::doNotOptimize(text.data());
+    });
+    bench.measure("binary serialize" + suffix, 200, [&]() {
+      ByteBuffer out;
+      out.reserve(buffer.size());
+      BinaryWriter w(out);
+      s.serialize(w);
+      LIBD::BENCHMARKS::doNotOptimize(out.data());
+    });
+    bench.measure("binary deserialize" + suffix, 200, [&]() {
+      BinaryReader reader(buffer);
+      auto result = Settings::deserialize(reader);
+      LIBD::BENCHMARKS::doNotOptimize(result);
+    });
+  }
+}
@@ -0,0 +1,231 @@
+#include <string>
+#include <utility>
+#include <vector>
+#include "benchmarks/benchmarkbase.h"
+#include "libdutil/namedenum.h"
+#include "libdutil/namedparameter.h"
+#include "libdutil/settings.h"
+#include "libdutil/settingsview.h"
+
+using namespace DUTIL;
+
+namespace {
+// Keys look like those of real wares: a common prefix and a varying suffix.
+std::vector<std::string> makeKeys(std::size_t n)
+{
+  std::vector<std::string> keys;
+  keys.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    keys.push_back("DetectorElementParameter" + std::to_string(i));
+  }
+  return keys;
+}
+
+// The former implementation: a vector of entries searched by comparing full strings.
+D_NAMED_REAL(DetectorEfficiencyCorrection)
+D_NAMED_LABEL(NumberOfReadoutChannels)
+D_NAMED_ENUM(ReadoutElectronics, CHARGE_SENSITIVE_AMPLIFIER, TRANSIMPEDANCE_AMPLIFIER)
+
+using LinearMap = std::vector<std::pair<std::string, Variant>>;
+
+Variant linearValue(LinearMap const& map, std::string const key)
+{
+  for (auto const& entry : map) {
+    if (entry.first == key)
+      return entry.second;
+  }
+  return Variant();
+}
+}  // namespace
+
+D_BENCHMARK(SettingsBenchmarks, lookupScaling)
+{
+  for (std::size_t n : {4, 16, 64, 256, 1024}) {
+    auto const keys = makeKeys(n);
+    std::string const suffix = " (" + std::to_string(n) + " keys)";
+    // every iteration looks up all keys, keep the total number of lookups constant
+    std::uint64_t const iterations = (1 << 18) / n * bench.scale();
+
+    LinearMap linear;
+    Settings s;
+    for (std::size_t i = 0; i < n; ++i) {
+      linear.emplace_back(keys[i], Variant(label_t(i)));
+      s.set(keys[i], label_t(i));
+    }
+
+    double const linearTime = bench.measure("lookup all, linear scan" + suffix, iterations, [&]() {
+      label_t sum = 0;
+      for (auto const& key : keys) {
+        sum += linearValue(linear, key).toLabel();
+      }
+      LIBD::BENCHMARKS::doNotOptimize(sum);
+    });
+    double const settingsTime = bench.measure("lookup all, Settings::value" + suffix, iterations, [&]() {
+      label_t sum = 0;
+      for (auto const& key : keys) {
+        sum += s.value(key).toLabel();
+      }
+      LIBD::BENCHMARKS::doNotOptimize(sum);
+    });
+    bench.measure("hasKey for missing keys" + suffix, iterations, [&]() {
+      std::size_t found = 0;
+      for (auto const& key : keys) {
+        found += s.hasKey(key + "_");
+      }
+      LIBD::BENCHMARKS::doNotOptimize(found);
+    });
+    bench.measure("build Settings" + suffix, iterations, [&]() {
+      Settings built;
+      for (std::size_t i = 0; i < n; ++i) {
+        built.set(keys[i], label_t(i));
+      }
+      LIBD::BENCHMARKS::doNotOptimize(built);
+    });
+    bench.note("speedup of lookups" + suffix, std::to_string(linearTime / settingsTime));
+  }
+  bench.note("allocations", "the linear scan copies the key like the former Settings::value");
+}
+
+D_BENCHMARK(SettingsBenchmarks, typedAccessors)
+{
+  std::uint64_t const iterations = 200000 * bench.scale();
+  Settings s;
+  s.setParameter(DetectorEfficiencyCorrection(0.97));
+  s.setParameter(NumberOfReadoutChannels(64));
+  s.setEnum(ReadoutElectronics::TRANSIMPEDANCE_AMPLIFIER);
+
+  bench.measure("getParameter<DetectorEfficiencyCorrection>", iterations, [&]() {
+    auto np = s.getParameter<DetectorEfficiencyCorrection>();
+    LIBD::BENCHMARKS::doNotOptimize(np);
+  });
+  bench.measure("getParameter<NumberOfReadoutChannels>", iterations, [&]() {
+    auto np = s.getParameter<NumberOfReadoutChannels>();
+    LIBD::BENCHMARKS::doNotOptimize(np);
+  });
+  bench.measure("getEnum<ReadoutElectronics>", iterations, [&]() {
+    auto ne = s.getEnum<ReadoutElectronics>();
+    LIBD::BENCHMARKS::doNotOptimize(ne);
+  });
+  bench.measure("value(std::string(name)), former typed access", iterations, [&]() {
+    auto v = s.value(std::string(DetectorEfficiencyCorrection::getParameterName()));
+    LIBD::BENCHMARKS::doNotOptimize(v);
+  });
+}
+
+D_BENCHMARK(SettingsBenchmarks, compileTimeKeyHashes)
+{
+  std::uint64_t const iterations = 200000 * bench.scale();
+  for (std::size_t n : {8, 256}) {
+    std::string const suffix = " (" + std::to_string(n) + " keys)";
+    Settings s;
+    for (auto const& key : makeKeys(n - 1)) {
+      s.set(key, 1.0);
+    }
+    s.setParameter(DetectorEfficiencyCorrection(0.97));
+
+    bench.measure("tryGet(name), hashed at run time" + suffix, iterations, [&]() {
+      auto v = s.tryGet(DetectorEfficiencyCorrection::getParameterName());
+      LIBD::BENCHMARKS::doNotOptimize(v);
+    });
+    bench.measure("tryGet(name, compile time hash)" + suffix, iterations, [&]() {
+      auto v = s.tryGet(DetectorEfficiencyCorrection::getParameterName(),
+                        DetectorEfficiencyCorrection::getParameterNameHash());
+      LIBD::BENCHMARKS::doNotOptimize(v);
+    });
+  }
+}
+
+D_BENCHMARK(SettingsBenchmarks, equalityAndFingerprint)
+{
+  for (std::size_t n : {16, 256}) {
+    std::string const suffix = " (" + std::to_string(n) + " keys)";
+    std::uint64_t const iterations = (1 << 20) / n * bench.scale();
+    auto const keys = makeKeys(n);
+
+    LinearMap linear;
+    Settings s1;
+    Settings reversed;
+    for (std::size_t i = 0; i < n; ++i) {
+      linear.emplace_back(keys[i], Variant(double(i)));
+      s1.set(keys[i], double(i));
+      reversed.set(keys[n - 1 - i], double(n - 1 - i));
+    }
+    Settings const s2 = s1;
+
+    bench.measure("copy and compare entry vectors (former operator==)" + suffix, iterations, [&]() {
+      LinearMap lhs = linear;
+      LinearMap rhs = linear;
+      bool equal = lhs == rhs;
+      LIBD::BENCHMARKS::doNotOptimize(equal);
+    });
+    bench.measure("operator==, same order" + suffix, iterations, [&]() {
+      bool equal = s1 == s2;
+      LIBD::BENCHMARKS::doNotOptimize(equal);
+    });
+    bench.measure("operator==, reversed order" + suffix, iterations, [&]() {
+      bool equal = s1 == reversed;
+      LIBD::BENCHMARKS::doNotOptimize(equal);
+    });
+    bench.measure("fingerprint, computed" + suffix, iterations, [&]() {
+      Settings copy = s1;
+      copy.set(keys[0], 0.0);
+      auto fingerprint = copy.fingerprint();
+      LIBD::BENCHMARKS::doNotOptimize(fingerprint);
+    });
+    bench.measure("copy only, for reference" + suffix, iterations, [&]() {
+      Settings copy = s1;
+      copy.set(keys[0], 0.0);
+      LIBD::BENCHMARKS::doNotOptimize(copy);
+    });
+    s1.fingerprint();
+    bench.measure("fingerprint, cached" + suffix, iterations, [&]() {
+      auto fingerprint = s1.fingerprint();
+      LIBD::BENCHMARKS::doNotOptimize(fingerprint);
+    });
+  }
+}
+
+D_BENCHMARK(SettingsBenchmarks, layeredOverrides)
+{
+  std::size_t const n = 256;
+  std::uint64_t const iterations = 20000 * bench.scale();
+  auto const keys = makeKeys(n);
+
+  Settings defaults;
+  for (std::size_t i = 0; i < n; ++i) {
+    defaults.set(keys[i], double(i));
+  }
+  defaults.setParameter(DetectorEfficiencyCorrection(0.9));
+
+  // one instrument: two overrides on top of the shared defaults
+  bench.measure("copy defaults and set 2 overrides (256 keys)", iterations, [&]() {
+    Settings instrument = defaults;
+    instrument.setParameter(DetectorEfficiencyCorrection(0.75));
+    instrument.setParameter(NumberOfReadoutChannels(128));
+    LIBD::BENCHMARKS::doNotOptimize(instrument);
+  });
+  bench.measure("view with 2 overrides on defaults (256 keys)", iterations, [&]() {
+    Settings overrides;
+    overrides.setParameter(DetectorEfficiencyCorrection(0.75));
+    overrides.setParameter(NumberOfReadoutChannels(128));
+    SettingsView instrument = SettingsView(defaults).overlay(std::move(overrides));
+    LIBD::BENCHMARKS::doNotOptimize(instrument);
+  });
+
+  Settings overrides;
+  overrides.setParameter(DetectorEfficiencyCorrection(0.75));
+  SettingsView const view = SettingsView(defaults).overlay(overrides);
+  Settings const merged = view.materialize();
+  bench.measure("getParameter, merged copy", iterations * 10, [&]() {
+    auto value = merged.getParameter<DetectorEfficiencyCorrection>();
+    LIBD::BENCHMARKS::doNotOptimize(value);
+  });
+  bench.measure("getParameter, view, hit in top layer", iterations * 10, [&]() {
+    auto value = view.getParameter<DetectorEfficiencyCorrection>();
+    LIBD::BENCHMARKS::doNotOptimize(value);
+  });
+  bench.measure("value, view, fall through to defaults", iterations * 10, [&]() {
+    auto value = view.value(keys[n / 2]);
+    LIBD::BENCHMARKS::doNotOptimize(value);
+  });
+}
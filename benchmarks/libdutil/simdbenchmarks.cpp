@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "benchmarks/benchmarkbase.h"
+#include "libdutil/dataset.h"
+#include "libdutil/simd.h"
+
+using namespace DUTIL;
+
+namespace {
+//! Build a Dataset of 'bytes' bytes of the given type with small non-negative values.
+template <typename TYPE>
+Dataset makeDataset(std::size_t bytes)
+{
+  std::vector<TYPE> values(std::max<std::size_t>(bytes / sizeof(TYPE), 1));
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<TYPE>(i % 100);
+  }
+  return Dataset(std::move(values));
+}
+
+Dataset makeDataset(Dataset::Type t, std::size_t bytes)
+{
+  return Dataset::dispatch(t, [bytes](auto tag) { return makeDataset<typename decltype(tag)::type>(bytes); });
+}
+
+//! Convert into the given result type with getPointerToValues.
+void convert(Dataset const& ds, Dataset::Type result)
+{
+  Dataset::dispatch(result, [&ds](auto tag) {
+    LIBD::BENCHMARKS::doNotOptimize(ds.getPointerToValues<typename decltype(tag)::type>());
+  });
+}
+
+std::string formatBytes(std::size_t bytes)
+{
+  if (bytes >= (1u << 30))
+    return std::to_string(bytes >> 30) + " GB";
+  if (bytes >= (1u << 20))
+    return std::to_string(bytes >> 20) + " MB";
+  return std::to_string(bytes >> 10) + " KB";
+}
+
+//! Enough iterations to convert about 256 MB per measurement, at least 2.
+std::uint64_t iterationsFor(std::size_t bytes)
+{
+  return std::max<std::uint64_t>(2, (std::uint64_t(256) << 20) / bytes);
+}
+//! Time SIMD::convert into a preallocated array for all supported instruction sets.
+template <typename RESULT, typename INTERNAL>
+void measureKernels(LIBD::BENCHMARKS::BenchmarkBase& bench, std::string const& pair, std::size_t bytes)
+{
+  std::vector<INTERNAL> src(std::max<std::size_t>(bytes / sizeof(INTERNAL), 1));
+  for (std::size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<INTERNAL>(i % 100);
+  }
+  std::vector<RESULT> dst(src.size());
+
+  double scalarNs = 0;
+  for (label_t set = 0; set <= label_t(SIMD::supportedInstructionSet()); ++set) {
+    SIMD::setActiveInstructionSet(SIMD::InstructionSet(set));
+    double const ns = bench.measure(pair + ", " + formatBytes(bytes) + ", " + SIMD::activeInstructionSet().toString(),
+                                    iterationsFor(bytes), [&]() {
+                                      SIMD::convert(src.data(), dst.data(), src.size());
+                                      LIBD::BENCHMARKS::doNotOptimize(dst);
+                                    });
+    if (set == SIMD::InstructionSet::SCALAR)
+      scalarNs = ns;
+    else
+      bench.note("  speedup over SCALAR", std::to_string(scalarNs / ns));
+  }
+  SIMD::setActiveInstructionSet(SIMD::supportedInstructionSet());
+}
+}  // namespace
+
+D_BENCHMARK(SIMDBenchmarks, conversionMatrix)
+{
+  // all pairs of non-empty types, read through Dataset with the best supported instruction set
+  std::size_t const bytes = std::size_t(1) << 20;
+  bench.note("instruction set", SIMD::activeInstructionSet().toString());
+  bench.note("source size", formatBytes(bytes));
+  for (label_t from = Dataset::Type::INT8; from <= Dataset::Type::FLOAT64; ++from) {
+    Dataset const ds = makeDataset(Dataset::Type(from), bytes);
+    for (label_t to = Dataset::Type::INT8; to <= Dataset::Type::FLOAT64; ++to) {
+      if (to == from)
+        continue;
+      double const ns = bench.measure(Dataset::Type(from).toString() + " -> " + Dataset::Type(to).toString(),
+                                      iterationsFor(bytes), [&]() { convert(ds, Dataset::Type(to)); });
+      bench.note("  values per ns", std::to_string(double(ds.getRows()) / ns));
+    }
+  }
+}
+
+D_BENCHMARK(SIMDBenchmarks, conversionSizes)
+{
+  // the vectorized pairs for each instruction set, from cache-resident sizes to main memory;
+  // --scale=32 raises the largest size to 1 GB
+  std::vector<std::size_t> const sizes = {std::size_t(1) << 10, std::size_t(32) << 10, std::size_t(1) << 20,
+                                          (std::size_t(32) << 20) * bench.scale()};
+  for (std::size_t bytes : sizes) {
+    measureKernels<float, int8_t>(bench, "INT8 -> FLOAT32", bytes);
+    measureKernels<double, uint8_t>(bench, "UINT8 -> FLOAT64", bytes);
+    measureKernels<float, int16_t>(bench, "INT16 -> FLOAT32", bytes);
+    measureKernels<double, int32_t>(bench, "INT32 -> FLOAT64", bytes);
+    measureKernels<double, float>(bench, "FLOAT32 -> FLOAT64", bytes);
+    measureKernels<float, double>(bench, "FLOAT64 -> FLOAT32", bytes);
+    measureKernels<int32_t, double>(bench, "FLOAT64 -> INT32", bytes);
+    measureKernels<double, int64_t>(bench, "INT64 -> FLOAT64", bytes);
+  }
+}
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+#include "benchmarks/benchmarkbase.h"
+#include "libdutil/variant.h"
+#include "libdutil/variantset.h"
+
+using namespace DUTIL;
+
+namespace {
+// Reproduction of the previous Variant layout, a std::variant plus a separate type enum object.
+struct LegacyVariant
+{
+  using Storage = std::variant<std::monostate, label_t, std::int64_t, std::uint64_t, double, bool,
+                               char, std::string>;
+  Storage var;
+  Variant::Type type;
+};
+
+std::string makeString(std::size_t i, std::size_t length)
+{
+  std::string str = "value_" + std::to_string(i);
+  str.resize(length, 'x');
+  return str;
+}
+
+// A mix of values as it is typically found in simulation configurations.
+template <typename V, typename MakeV>
+std::vector<V> makeMixedValues(std::size_t n, MakeV make)
+{
+  std::vector<V> values;
+  values.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    switch (i % 4) {
+      case 0:
+        values.push_back(make(label_t(i)));
+        break;
+      case 1:
+        values.push_back(make(double(i) * 0.5));
+        break;
+      case 2:
+        values.push_back(make(makeString(i, 12)));
+        break;
+      default:
+        values.push_back(make(bool(i % 8)));
+        break;
+    }
+  }
+  return values;
+}
+
+auto makeLegacy = [](auto value) {
+  return LegacyVariant{LegacyVariant::Storage(value), Variant(value).getType()};
+};
+auto makeCompact = [](auto value) { return Variant(value); };
+}  // namespace
+
+D_BENCHMARK(VariantBenchmarks, memoryFootprint)
+{
+  bench.note("sizeof(LegacyVariant) [bytes]", std::to_string(sizeof(LegacyVariant)));
+  bench.note("sizeof(Variant) [bytes]", std::to_string(sizeof(Variant)));
+
+  for (std::size_t length : {8u, 14u, 15u, 32u}) {
+    std::string const str = makeString(0, length);
+    std::string const suffix = " string length " + std::to_string(length);
+    bench.measure("legacy construct" + suffix, 100000, [&]() {
+      LegacyVariant v{LegacyVariant::Storage(str), Variant::Type::STRING};
+      LIBD::BENCHMARKS::doNotOptimize(v);
+    });
+    bench.measure("compact construct" + suffix, 100000, [&]() {
+      Variant v(str);
+      LIBD::BENCHMARKS::doNotOptimize(v);
+    });
+  }
+}
+
+D_BENCHMARK(VariantBenchmarks, copyThroughput)
+{
+  std::size_t const n = 100000 * bench.scale();
+  auto const legacy = makeMixedValues<LegacyVariant>(n, makeLegacy);
+  auto const compact = makeMixedValues<Variant>(n, makeCompact);
+  bench.note("values per copied vector", std::to_string(n));
+  bench.note("legacy vector payload [bytes]", std::to_string(n * sizeof(LegacyVariant)));
+  bench.note("compact vector payload [bytes]", std::to_string(n * sizeof(Variant)));
+
+  double legacyNs = bench.measure("legacy vector copy", 20, [&]() {
+    auto copy = legacy;
+    LIBD::BENCHMARKS::doNotOptimize(copy.data());
+  });
+  double compactNs = bench.measure("compact vector copy", 20, [&]() {
+    auto copy = compact;
+    LIBD::BENCHMARKS::doNotOptimize(copy.data());
+  });
+  bench.note("copy speedup compact vs legacy", std::to_string(legacyNs / compactNs));
+}
+
+D_BENCHMARK(VariantBenchmarks, readThroughput)
+{
+  std::size_t const n = 100000 * bench.scale();
+  auto const legacy = makeMixedValues<LegacyVariant>(n, makeLegacy);
+  auto const compact = makeMixedValues<Variant>(n, makeCompact);
+
+  bench.measure("legacy type check and read", 20, [&]() {
+    double sum = 0;
+    for (auto const& v : legacy) {
+      if (v.type == Variant::Type::DOUBLE)
+        sum += std::get<double>(v.var);
+    }
+    LIBD::BENCHMARKS::doNotOptimize(sum);
+  });
+  bench.measure("compact type check and read", 20, [&]() {
+    double sum = 0;
+    for (auto const& v : compact) {
+      if (v.getType() == Variant::Type::DOUBLE)
+        sum += v.toReal();
+    }
+    LIBD::BENCHMARKS::doNotOptimize(sum);
+  });
+  bench.measure("compact tryGet read", 20, [&]() {
+    double sum = 0;
+    for (auto const& v : compact) {
+      if (double const* d = v.tryGet<double>())
+        sum += *d;
+    }
+    LIBD::BENCHMARKS::doNotOptimize(sum);
+  });
+}
+
+D_BENCHMARK(VariantBenchmarks, stringAccess)
+{
+  std::size_t const n = 100000 * bench.scale();
+  std::vector<Variant> values;
+  values.reserve(n);
+  for (std::size_t i = 0; i < n; ++i)
+    values.emplace_back(makeString(i, i % 2 ? 12 : 40));
+
+  bench.measure("toString length sum", 20, [&]() {
+    std::size_t sum = 0;
+    for (auto const& v : values)
+      sum += v.toString().size();
+    LIBD::BENCHMARKS::doNotOptimize(sum);
+  });
+  bench.measure("asStringView length sum", 20, [&]() {
+    std::size_t sum = 0;
+    for (auto const& v : values)
+      sum += v.asStringView().size();
+    LIBD::BENCHMARKS::doNotOptimize(sum);
+  });
+  bench.measure("visit length sum", 20, [&]() {
+    std::size_t sum = 0;
+    for (auto const& v : values) {
+      sum += v.visit(Overload{[](std::string_view s) { return s.size(); },
+                              [](auto const&) { return std::size_t(0); }});
+    }
+    LIBD::BENCHMARKS::doNotOptimize(sum);
+  });
+}
+
+D_BENCHMARK(VariantBenchmarks, deduplication)
+{
+  // parameter sweep values: every distinct value occurs several times
+  for (std::size_t distinct : {16u, 256u, 2048u}) {
+    std::size_t const n = 8 * distinct * bench.scale();
+    std::vector<Variant> values;
+    values.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      std::size_t k = (i * 7919) % distinct;
+      if (k % 2)
+        values.emplace_back(double(k) * 0.5);
+      else
+        values.emplace_back(makeString(k, 10));
+    }
+    std::string const suffix = " (" + std::to_string(n) + " values, " + std::to_string(distinct)
+                               + " distinct)";
+    std::size_t const iterations = std::max<std::size_t>(1, 200000 / n);
+
+    double linearNs = bench.measure("linear scan" + suffix, iterations, [&]() {
+      std::vector<Variant> unique;
+      for (auto const& v : values) {
+        if (std::find(unique.begin(), unique.end(), v) == unique.end())
+          unique.push_back(v);
+      }
+      LIBD::BENCHMARKS::doNotOptimize(unique.data());
+    });
+    bench.measure("sort and unique" + suffix, iterations, [&]() {
+      std::vector<Variant> unique(values);
+      std::sort(unique.begin(), unique.end());
+      unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+      LIBD::BENCHMARKS::doNotOptimize(unique.data());
+    });
+    bench.measure("std::unordered_set" + suffix, iterations, [&]() {
+      std::unordered_set<Variant> unique;
+      for (auto const& v : values)
+        unique.insert(v);
+      LIBD::BENCHMARKS::doNotOptimize(unique);
+    });
+    double setNs = bench.measure("VariantSet" + suffix, iterations, [&]() {
+      VariantSet unique;
+      for (auto const& v : values)
+        unique.insert(v);
+      LIBD::BENCHMARKS::doNotOptimize(unique);
+    });
+    bench.note("speedup VariantSet vs linear scan" + suffix, std::to_string(linearNs / setNs));
+  }
+}
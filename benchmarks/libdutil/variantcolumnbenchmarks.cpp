@@ -0,0 +1,60 @@
+#include <string>
+#include <vector>
+#include "benchmarks/benchmarkbase.h"
+#include "libdutil/settings.h"
+#include "libdutil/variantcolumn.h"
+
+using namespace DUTIL;
+
+namespace {
+// One Settings object per simulated instrument, holding a few keys each.
+std::vector<Settings> makeInstruments(std::size_t n)
+{
+  std::vector<Settings> instruments(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    instruments[i]
+        .set("name", "instrument_" + std::to_string(i))
+        .set("wavelength", 380.0 + 0.01 * double(i))
+        .set("channel", label_t(i % 64))
+        .set("gain", i % 2 ? Variant(1.5) : Variant("1.5"));
+  }
+  return instruments;
+}
+}  // namespace
+
+D_BENCHMARK(VariantColumnBenchmarks, bulkConversion)
+{
+  std::size_t const n = 100000 * bench.scale();
+  auto const instruments = makeInstruments(n);
+  bench.note("instruments", std::to_string(n));
+
+  for (std::string key : {"wavelength", "channel", "gain"}) {
+    VariantColumn const column = VariantColumn::fromSettings(instruments, key);
+    std::vector<Variant> const& values = column.values();
+    std::string const suffix = " (" + key + (column.isUniform() ? ", uniform)" : ", mixed)");
+
+    double const perValue = bench.measure("toReal per value" + suffix, 20, [&]() {
+      std::vector<double> result;
+      result.reserve(values.size());
+      for (auto const& v : values) {
+        result.push_back(v.toReal());
+      }
+      LIBD::BENCHMARKS::doNotOptimize(result.data());
+    });
+    double const bulk = bench.measure("VariantColumn::toVector<double>" + suffix, 20, [&]() {
+      auto result = column.toVector<double>();
+      LIBD::BENCHMARKS::doNotOptimize(result.data());
+    });
+    bench.note("speedup" + suffix, std::to_string(perValue / bulk));
+  }
+
+  bench.measure("gather wavelength column from settings", 5, [&]() {
+    auto column = VariantColumn::fromSettings(instruments, "wavelength");
+    LIBD::BENCHMARKS::doNotOptimize(column.values().data());
+  });
+  VariantColumn const channels = VariantColumn::fromSettings(instruments, "channel");
+  bench.measure("channel column into Dataset<int32>", 20, [&]() {
+    auto ds = channels.toDataset<std::int32_t>();
+    LIBD::BENCHMARKS::doNotOptimize(ds);
+  });
+}
@@ -0,0 +1,24 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "benchmarkbase.h"
+
+// Usage: libd_benchmarks [--filter=<substring>] [--scale=<factor>]
+int main(int argc, char** argv)
+{
+  std::string filter;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.rfind("--filter=", 0) == 0) {
+      filter = arg.substr(9);
+    } else if (arg.rfind("--scale=", 0) == 0) {
+      LIBD::BENCHMARKS::BenchmarkBase::setScale(std::strtoull(arg.c_str() + 8, nullptr, 10));
+    } else {
+      std::printf("usage: %s [--filter=<substring>] [--scale=<factor>]\n", argv[0]);
+      return 1;
+    }
+  }
+  int count = LIBD::BENCHMARKS::BenchmarkBase::runAll(filter);
+  std::printf("%d benchmark(s) executed.\n", count);
+  return 0;
+}
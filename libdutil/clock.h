@@ -6,7 +6,7 @@
 
 #include <chrono>
 #include <iomanip>
-#include "time.h"
+#include "timeunits.h"
 
 namespace DUTIL {
 class ConstructionValidator;
@@ -0,0 +1,384 @@
+#include "configparser.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include "exception.h"
+#include "mappedfile.h"
+#include "utility.h"
+
+namespace DUTIL {
+
+namespace {
+bool isBlank(char c) noexcept
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+bool isListSeparator(char c) noexcept
+{
+  return isBlank(c) || c == ',' || c == '\n';
+}
+
+//! Return the last instance of the named sub-ConstructionData, create the first one if there is none.
+ConstructionData& lastSubObject(ConstructionData& parent, std::string_view name)
+{
+  std::string const prefix = std::string(name) + ConstructionData::seperator;
+  auto last = parent.subObjectData.end();
+  for (label_t i = 0;; ++i) {
+    auto const next = parent.subObjectData.find(prefix + Utility::toString(i));
+    if (next == parent.subObjectData.end())
+      break;
+    last = next;
+  }
+  if (last == parent.subObjectData.end())
+    last = parent.subObjectData.try_emplace(prefix + "0").first;
+  return last->second;
+}
+}  // namespace
+
+ConstructionData ConfigParser::parse(std::string_view text, std::string_view sourceName,
+                                     allocator_type const& alloc)
+{
+  ConstructionData cd(alloc);
+  ConfigParser(text, sourceName).run(&cd, cd.s);
+  return cd;
+}
+
+ConstructionData ConfigParser::parseFile(std::string const& path, allocator_type const& alloc)
+{
+  MappedFile const file(path);
+  return parse(file.text(), path, alloc);
+}
+
+Settings ConfigParser::parseSettings(std::string_view text, std::string_view sourceName,
+                                     allocator_type const& alloc)
+{
+  Settings s(alloc);
+  ConfigParser(text, sourceName).run(nullptr, s);
+  return s;
+}
+
+Settings ConfigParser::parseSettingsFile(std::string const& path, allocator_type const& alloc)
+{
+  MappedFile const file(path);
+  return parseSettings(file.text(), path, alloc);
+}
+
+ConfigParser::ConfigParser(std::string_view text, std::string_view sourceName) :
+    cur_(text.data()),
+    end_(text.data() + text.size()),
+    line_(1),
+    source_(sourceName),
+    scratch_()
+{}
+
+void ConfigParser::run(ConstructionData* root, Settings& settings)
+{
+  ConstructionData* current = root;
+  Settings* target = &settings;
+  while (cur_ != end_) {
+    skipBlanks();
+    if (cur_ == end_)
+      break;
+    switch (*cur_) {
+      case '\n':
+        ++line_;
+        ++cur_;
+        break;
+      case '#':
+        skipToLineEnd();
+        break;
+      case '[':
+        if (!root)
+          fail("Sections are not allowed in a settings file.");
+        current = &parseSection(*root);
+        target = &current->s;
+        break;
+      case '@':
+        if (!root)
+          fail("Datasets are not allowed in a settings file.");
+        parseDataset(*current);
+        break;
+      default:
+        parseEntry(*target);
+    }
+  }
+}
+
+void ConfigParser::parseEntry(Settings& settings)
+{
+  char const* const keyBegin = cur_;
+  while (cur_ != end_ && *cur_ != '=' && *cur_ != '\n' && *cur_ != '#')
+    ++cur_;
+  std::string_view const key = Utility::trim(std::string_view(keyBegin, std::size_t(cur_ - keyBegin)));
+  if (cur_ == end_ || *cur_ != '=')
+    fail("Expected '=' after key '" + std::string(key) + "'.");
+  if (key.empty())
+    fail("Missing key in front of '='.");
+  ++cur_;
+  skipBlanks();
+
+  if (cur_ != end_ && *cur_ == '"') {
+    parseQuoted();
+    expectLineEnd();
+    settings.setFromVariant(key, Variant(scratch_, settings.get_allocator()));
+    return;
+  }
+
+  // unquoted values end at the line end or at a comment separated by whitespace
+  char const* const valueBegin = cur_;
+  while (cur_ != end_ && *cur_ != '\n') {
+    if (*cur_ == '#' && (cur_ == valueBegin || isBlank(cur_[-1])))
+      break;
+    ++cur_;
+  }
+  std::string_view const value = Utility::trim(std::string_view(valueBegin, std::size_t(cur_ - valueBegin)));
+  skipToLineEnd();
+  settings.setFromVariant(key, typedValue(value, settings.get_allocator()));
+}
+
+ConstructionData& ConfigParser::parseSection(ConstructionData& root)
+{
+  ++cur_;
+  char const* const begin = cur_;
+  while (cur_ != end_ && *cur_ != ']' && *cur_ != '\n')
+    ++cur_;
+  if (cur_ == end_ || *cur_ != ']')
+    fail("Missing ']' at the end of the section header.");
+  std::string_view const header(begin, std::size_t(cur_ - begin));
+  ++cur_;
+  expectLineEnd();
+
+  ConstructionData* parent = &root;
+  std::string_view path = header;
+  while (true) {
+    auto const dot = path.find('.');
+    std::string_view const name = Utility::trim(path.substr(0, dot));
+    if (name.empty())
+      fail("Empty section name in header '[" + std::string(header) + "]'.");
+    if (name.find(ConstructionData::seperator) != std::string_view::npos)
+      fail("Section name '" + std::string(name) + "' must not contain '"
+           + ConstructionData::seperator + "'.");
+    if (dot == std::string_view::npos) {
+      auto key = parent->createSubObjectKeyWithCounter(std::string(name));
+      return parent->subObjectData.try_emplace(std::move(key)).first->second;
+    }
+    parent = &lastSubObject(*parent, name);
+    path.remove_prefix(dot + 1);
+  }
+}
+
+void ConfigParser::parseDataset(ConstructionData& cd)
+{
+  auto word = [this]() {
+    char const* const begin = cur_;
+    while (cur_ != end_ && (std::isalnum(static_cast<unsigned char>(*cur_)) || *cur_ == '_'))
+      ++cur_;
+    return std::string_view(begin, std::size_t(cur_ - begin));
+  };
+
+  ++cur_;
+  if (word() != "dataset")
+    fail("Unknown directive, expected '@dataset'.");
+  skipBlanks();
+  std::string const type(word());
+  StringList const types = Dataset::Type::getAllowedNames();
+  if (std::find(types.cbegin(), types.cend(), type) == types.cend())
+    fail("Unknown dataset type '" + type + "'.");
+
+  skipBlanks();
+  label_t cols = 1;
+  if (cur_ != end_ && *cur_ != '=') {
+    std::string_view const colsText = word();
+    auto const result = std::from_chars(colsText.data(), colsText.data() + colsText.size(), cols);
+    if (colsText.empty() || result.ptr != colsText.data() + colsText.size() || cols < 1)
+      fail("Invalid number of dataset columns '" + std::string(colsText) + "'.");
+    skipBlanks();
+  }
+  if (cur_ == end_ || *cur_ != '=')
+    fail("Expected '=' after the dataset type.");
+  ++cur_;
+  skipBlanks();
+  if (cur_ == end_ || *cur_ != '[')
+    fail("Expected '[' in front of the dataset values.");
+  ++cur_;
+  if (cd.hasDataset())
+    fail("The section already holds a dataset.");
+
+  Dataset::Type const datasetType(type);
+  if (datasetType == Dataset::Type::EMPTY) {
+    if (!nextListToken().empty())
+      fail("A dataset of type EMPTY cannot hold values.");
+    cd.ds = Dataset();
+  } else {
+    cd.ds = Dataset::dispatch(datasetType,
+                              [this, cols](auto tag) { return parseDatasetValues<typename decltype(tag)::type>(cols); });
+  }
+  expectLineEnd();
+}
+
+template <typename T>
+Dataset ConfigParser::parseDatasetValues(label_t cols)
+{
+  std::vector<T> values;
+  for (std::string_view token = nextListToken(); !token.empty(); token = nextListToken()) {
+    // fromChars ignores the minus sign for unsigned types, a negative value is out of range here
+    auto const result = std::is_unsigned_v<T> && token.front() == '-'
+                            ? ConversionResult<T>{T(), ConversionError::OUT_OF_RANGE}
+                            : Conversion::fromChars<T>(token);
+    // floating point values are rounded to the dataset type, integers have to match exactly
+    bool const valid = std::is_floating_point_v<T> ? result.hasValue() : result.ok();
+    if (!valid)
+      fail("Invalid dataset value '" + std::string(token)
+           + "': " + Conversion::errorToString(result.error) + ".");
+    values.push_back(result.value);
+  }
+  if (values.size() % std::size_t(cols))
+    fail("The number of dataset values " + Utility::toString(std::uint64_t(values.size()))
+         + " is not divisible by the number of columns " + Utility::toString(cols) + ".");
+  return Dataset(std::move(values), cols);
+}
+
+void ConfigParser::parseQuoted()
+{
+  scratch_.clear();
+  ++cur_;
+  char const* chunk = cur_;
+  while (true) {
+    if (cur_ == end_ || *cur_ == '\n')
+      fail("Missing closing quote.");
+    if (*cur_ == '"')
+      break;
+    if (*cur_ != '\\') {
+      ++cur_;
+      continue;
+    }
+    scratch_.append(chunk, cur_);
+    if (++cur_ == end_)
+      fail("Missing closing quote.");
+    switch (*cur_) {
+      case 'n':
+        scratch_.push_back('\n');
+        break;
+      case 't':
+        scratch_.push_back('\t');
+        break;
+      case '"':
+      case '\\':
+        scratch_.push_back(*cur_);
+        break;
+      default:
+        fail(std::string("Unknown escape sequence '\\") + *cur_ + "'.");
+    }
+    chunk = ++cur_;
+  }
+  scratch_.append(chunk, cur_);
+  ++cur_;
+}
+
+Variant ConfigParser::typedValue(std::string_view text, allocator_type const& alloc)
+{
+  if (text.empty())
+    return Variant();
+  if (text == "true")
+    return Variant(true);
+  if (text == "false")
+    return Variant(false);
+
+  char const first = text.front();
+  if (std::isdigit(static_cast<unsigned char>(first)) || first == '-' || first == '+' || first == '.') {
+    std::string_view const digits = first == '+' ? text.substr(1) : text;
+    char const* const digitsEnd = digits.data() + digits.size();
+    if (!digits.empty() && digits.front() != '+' && (first != '+' || digits.front() != '-')) {
+      std::int64_t integer = 0;
+      auto const result = std::from_chars(digits.data(), digitsEnd, integer);
+      if (result.ptr == digitsEnd && result.ec == std::errc()) {
+        if (integer >= std::numeric_limits<label_t>::min() && integer <= std::numeric_limits<label_t>::max())
+          return Variant(label_t(integer));
+        return Variant(integer);
+      }
+      if (result.ptr == digitsEnd && result.ec == std::errc::result_out_of_range && digits.front() != '-') {
+        std::uint64_t unsignedInteger = 0;
+        auto const unsignedResult = std::from_chars(digits.data(), digitsEnd, unsignedInteger);
+        if (unsignedResult.ptr == digitsEnd && unsignedResult.ec == std::errc())
+          return Variant(unsignedInteger);
+      }
+      // only the decimal point, unlike Conversion::parseDouble: "1,5" stays a string; "-inf" and
+      // "-nan" stay strings like "inf" and "nan", which never get here
+      double real = 0.0;
+      auto const realResult = std::from_chars(digits.data(), digitsEnd, real);
+      if (realResult.ptr == digitsEnd && realResult.ec == std::errc() && std::isfinite(real))
+        return Variant(real);
+    }
+  }
+
+  scratch_.assign(text);
+  return Variant(scratch_, alloc);
+}
+
+std::string_view ConfigParser::nextListToken()
+{
+  while (true) {
+    if (cur_ == end_)
+      fail("Missing ']' at the end of the dataset values.");
+    if (*cur_ == '#') {
+      skipToLineEnd();
+    } else if (isListSeparator(*cur_)) {
+      if (*cur_ == '\n')
+        ++line_;
+      ++cur_;
+    } else {
+      break;
+    }
+  }
+  if (*cur_ == ']') {
+    ++cur_;
+    return {};
+  }
+  char const* const begin = cur_;
+  while (cur_ != end_ && !isListSeparator(*cur_) && *cur_ != ']' && *cur_ != '#')
+    ++cur_;
+  return std::string_view(begin, std::size_t(cur_ - begin));
+}
+
+void ConfigParser::skipBlanks() noexcept
+{
+  while (cur_ != end_ && isBlank(*cur_))
+    ++cur_;
+}
+
+void ConfigParser::skipToLineEnd() noexcept
+{
+  if (cur_ == end_)
+    return;
+  auto const* newline = static_cast<char const*>(std::memchr(cur_, '\n', std::size_t(end_ - cur_)));
+  cur_ = newline ? newline : end_;
+}
+
+void ConfigParser::expectLineEnd()
+{
+  skipBlanks();
+  if (cur_ != end_ && *cur_ == '#')
+    skipToLineEnd();
+  if (!atLineEnd()) {
+    char const* const begin = cur_;
+    skipToLineEnd();
+    fail("Unexpected text '" + std::string(Utility::trim(std::string_view(begin, std::size_t(cur_ - begin))))
+         + "' at the end of the line.");
+  }
+}
+
+bool ConfigParser::atLineEnd() const noexcept
+{
+  return cur_ == end_ || *cur_ == '\n';
+}
+
+void ConfigParser::fail(std::string const& message) const
+{
+  D_THROW(std::string(source_) + ":" + Utility::toString(line_) + ": " + message);
+}
+
+}  // namespace DUTIL
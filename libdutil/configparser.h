@@ -0,0 +1,107 @@
+#ifndef DUTIL_CONFIGPARSER_H
+#define DUTIL_CONFIGPARSER_H
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "constructiondata.h"
+#include "settings.h"
+
+namespace DUTIL {
+
+/*! \brief Single pass parser for Settings and ConstructionData text files.
+ *
+ * The format is line based and INI-like:
+ *
+ * # comment
+ * Solver = CONJUGATE_GRADIENT          # unquoted text, e.g. the name of a named enum
+ * Tolerance = 1e-8
+ * Comment = "quoted text, with \"escapes\" and # signs"
+ *
+ * [Detector]                           # sub-ConstructionData of the root object
+ * Gain = 2.5
+ * @dataset FLOAT64 2 = [ 0.1, 0.2,     # dataset of the section: type, number of columns, values
+ *                        0.3, 0.4 ]
+ *
+ * [Detector.Pixel]                     # sub-ConstructionData of the last [Detector]
+ * Channels = 64
+ *
+ * Key-value pairs are stored in the Settings member 's' of the current section. Values are typed by
+ * their spelling: integers become label_t, or int64/uint64 if they do not fit, numbers with a
+ * fraction or exponent become double, true and false become bool, quoted and all other text becomes
+ * a string and an empty value an empty variant. Numbers use the decimal point, so 1,5 is a string,
+ * and are finite: inf, -inf, nan and -nan all stay strings. Setting a key twice keeps the last value.
+ *
+ * A section header [A.B.C] adds a new sub-ConstructionData 'C' to the last 'B' inside the last 'A'
+ * of the root object, sections which do not exist yet are created on the way. The keys in
+ * 'subObjectData' follow ConstructionData::createSubObjectKeyWithCounter, i.e. repeating a
+ * header adds the next instance. Section names must not contain ConstructionData::seperator.
+ *
+ * A '@dataset TYPE COLUMNS = [...]' line fills the Dataset member of the current section, TYPE is
+ * one of the Dataset::Type names and COLUMNS defaults to 1. The values are separated by whitespace,
+ * commas or line breaks and may contain comments. Each value has to be exactly representable in
+ * the dataset type, FLOAT32 values are rounded.
+ *
+ * The parser reads the text front to back exactly once and builds the result on the fly, there is
+ * no intermediate representation. Files are memory-mapped instead of being read into a buffer, see
+ * MappedFile. All objects of the result allocate from the given allocator's memory resource, see
+ * ConstructionData::allocator_type. Syntax errors throw an exception naming the source and line.
+ */
+class ConfigParser
+{
+  public:
+  using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+  //! Parse a complete ConstructionData tree, 'sourceName' is only used for error messages.
+  static ConstructionData parse(std::string_view text, std::string_view sourceName = "<text>",
+                                allocator_type const& alloc = {});
+
+  //! Map the file and parse a complete ConstructionData tree.
+  static ConstructionData parseFile(std::string const& path, allocator_type const& alloc = {});
+
+  //! Parse key-value pairs only, section headers and datasets are rejected.
+  static Settings parseSettings(std::string_view text, std::string_view sourceName = "<text>",
+                                allocator_type const& alloc = {});
+
+  //! Map the file and parse key-value pairs only.
+  static Settings parseSettingsFile(std::string const& path, allocator_type const& alloc = {});
+
+  private:
+  ConfigParser(std::string_view text, std::string_view sourceName);
+
+  //! Parse the whole text into 'root', whose Settings member is 's' unless sections are rejected.
+  void run(ConstructionData* root, Settings& settings);
+
+  void parseEntry(Settings& settings);
+  ConstructionData& parseSection(ConstructionData& root);
+  void parseDataset(ConstructionData& cd);
+
+  template <typename T>
+  Dataset parseDatasetValues(label_t cols);
+
+  //! Parse a quoted string into scratch_, the current character is the opening quote.
+  void parseQuoted();
+
+  //! Return a variant holding the typed value of unquoted text.
+  Variant typedValue(std::string_view text, allocator_type const& alloc);
+
+  //! Return the next token of a dataset value list or an empty view at the closing bracket.
+  std::string_view nextListToken();
+
+  void skipBlanks() noexcept;
+  void skipToLineEnd() noexcept;
+  void expectLineEnd();
+  bool atLineEnd() const noexcept;
+
+  [[noreturn]] void fail(std::string const& message) const;
+
+  char const* cur_;
+  char const* end_;
+  std::uint64_t line_;
+  std::string_view source_;
+  std::string scratch_;
+};
+
+}  // namespace DUTIL
+#endif  // DUTIL_CONFIGPARSER_H
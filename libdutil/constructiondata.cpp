@@ -11,6 +11,122 @@ ConstructionData::ConstructionData(Usage u) :
     usage_(u)
 {}
 
+ConstructionData::ConstructionData(allocator_type const& alloc) :
+    ConstructionData(Usage::REAL, alloc)
+{}
+
+ConstructionData::ConstructionData(Usage u, allocator_type const& alloc) :
+    s(alloc),
+    wareSettings(alloc),
+    subObjectData(alloc),
+    sharedWares(alloc),
+    usage_(u)
+{}
+
+ConstructionData::ConstructionData(ConstructionData const& other, allocator_type const& alloc) :
+    s(other.s, alloc),
+    wareSettings(other.wareSettings, alloc),
+    ds(other.ds),
+    subObjectData(other.subObjectData, alloc),
+    sharedWares(other.sharedWares, alloc),
+    usage_(other.usage_)
+{}
+
+ConstructionData::ConstructionData(ConstructionData&& other, allocator_type const& alloc) :
+    s(std::move(other.s), alloc),
+    wareSettings(std::move(other.wareSettings), alloc),
+    ds(std::move(other.ds)),
+    subObjectData(std::move(other.subObjectData), alloc),
+    sharedWares(std::move(other.sharedWares), alloc),
+    usage_(other.usage_)
+{}
+
+ConstructionData::allocator_type ConstructionData::get_allocator() const noexcept
+{
+  return s.get_allocator();
+}
+
+namespace {
+//! Merge two maps sorted by key, calling the given functions for keys only in a, only in b and in both.
+template <typename Map, typename OnlyA, typename OnlyB, typename Both>
+void mergeByKey(Map const& a, Map const& b, OnlyA onlyA, OnlyB onlyB, Both both)
+{
+  auto i = a.cbegin();
+  auto j = b.cbegin();
+  while (i != a.cend() || j != b.cend()) {
+    if (j == b.cend() || (i != a.cend() && i->first < j->first)) {
+      onlyA(*i++);
+    } else if (i == a.cend() || j->first < i->first) {
+      onlyB(*j++);
+    } else {
+      both(*i++, *j++);
+    }
+  }
+}
+
+void collectChangedPaths(ConstructionData::Diff const& diff, std::string const& path, StringList& paths)
+{
+  // an object whose set of subobjects changed has to be rebuilt to create or drop them
+  if (diff.ownMembersChanged() || !diff.addedSubObjects.empty() || !diff.removedSubObjects.empty())
+    paths.push_back(path);
+  std::string const prefix = path.empty() ? path : path + '/';
+  for (auto const& key : diff.addedSubObjects) {
+    paths.push_back(prefix + key);
+  }
+  for (auto const& child : diff.changedSubObjects) {
+    collectChangedPaths(child.second, prefix + child.first, paths);
+  }
+}
+}  // namespace
+
+ConstructionData::Diff ConstructionData::diff(ConstructionData const& other) const
+{
+  Diff result;
+  result.settings = s.diff(other.s);
+  result.wareSettings = wareSettings.diff(other.wareSettings);
+  result.usageChanged = usage_ != other.usage_;
+  result.datasetChanged = ds != other.ds;
+
+  auto const sharedWareChanged = [&result](auto const& entry) {
+    result.changedSharedWares.push_back(entry.first);
+  };
+  mergeByKey(sharedWares, other.sharedWares, sharedWareChanged, sharedWareChanged,
+             [&result](auto const& a, auto const& b) {
+               if (a.second != b.second)
+                 result.changedSharedWares.push_back(a.first);
+             });
+
+  mergeByKey(
+      subObjectData, other.subObjectData,
+      [&result](auto const& a) { result.removedSubObjects.push_back(a.first); },
+      [&result](auto const& b) { result.addedSubObjects.push_back(b.first); },
+      [&result](auto const& a, auto const& b) {
+        Diff child = a.second.diff(b.second);
+        if (!child.empty())
+          result.changedSubObjects.emplace_back(a.first, std::move(child));
+      });
+  return result;
+}
+
+bool ConstructionData::Diff::empty() const
+{
+  return !ownMembersChanged() && addedSubObjects.empty() && removedSubObjects.empty()
+         && changedSubObjects.empty();
+}
+
+bool ConstructionData::Diff::ownMembersChanged() const
+{
+  return !settings.empty() || !wareSettings.empty() || usageChanged || datasetChanged
+         || !changedSharedWares.empty();
+}
+
+StringList ConstructionData::Diff::changedPaths() const
+{
+  StringList paths;
+  collectChangedPaths(*this, std::string(), paths);
+  return paths;
+}
+
 bool ConstructionData::isProxy() const
 {
   if (usage_ == Usage::PROXY)
@@ -65,7 +181,7 @@ std::string ConstructionData::createSharedWareKeyWithCounter(
       // input 'sharedWarePtr' does return the already exsiting key and overwrite the sharedWare entry.
       break;
     }
-    if (iter.first.substr(0, prefix.size()) == prefix) {
+    if (std::string_view(iter.first).substr(0, prefix.size()) == prefix) {
       ++count;
     }
   }
@@ -81,24 +197,22 @@ std::string ConstructionData::createSubObjectKeyWithCounter(std::string key) con
   label_t count = 0;
   std::string prefix = key + seperator;
   std::for_each(subObjectData.cbegin(), subObjectData.cend(), [&](auto const& iter) {
-    if (iter.first.substr(0, prefix.size()) == prefix)
+    if (std::string_view(iter.first).substr(0, prefix.size()) == prefix)
       ++count;
   });
   return prefix + Utility::toString(count);
 }
 
-std::map<std::string, ConstructionData>::const_iterator ConstructionData::getSubObjectWithCounter(
+ConstructionData::SubObjectMap::const_iterator ConstructionData::getSubObjectWithCounter(
     std::string key, label_t index) const
 {
-  return std::map<std::string, ConstructionData>::const_iterator()
-         = subObjectData.find(key + seperator + Utility::toString(index));
+  return subObjectData.find(key + seperator + Utility::toString(index));
 }
 
-std::map<std::string, std::shared_ptr<const Ware>>::const_iterator
-ConstructionData::getSharedWareWithCounter(std::string key, label_t i) const
+ConstructionData::SharedWareMap::const_iterator ConstructionData::getSharedWareWithCounter(
+    std::string key, label_t i) const
 {
-  return std::map<std::string, std::shared_ptr<const Ware>>::const_iterator()
-         = sharedWares.find(key + seperator + Utility::toString(i));
+  return sharedWares.find(key + seperator + Utility::toString(i));
 }
 
 }  // namespace DUTIL
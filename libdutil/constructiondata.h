@@ -1,6 +1,11 @@
 #ifndef DUTIL_CONSTRUCTIONDATA_H
 #define DUTIL_CONSTRUCTIONDATA_H
+#include <map>
 #include <memory>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
 #include "dataset.h"
 #include "settings.h"
 
@@ -15,6 +20,10 @@ namespace DUTIL {
  * A ConstructionData structure also provides the ability to store sub-ConstructionData
  * structures, i.e. nested ConstructionData structs.
  *
+ * Settings and map nodes are allocated from the memory resource given at construction, see allocator_type.
+ * Nested ConstructionData objects added to the maps use the same resource. Hence, a complete tree can be
+ * built inside a std::pmr::monotonic_buffer_resource and released at once. Datasets and map keys which do
+ * not fit into the small string buffer of std::string keep using the global heap.
  */
 
 struct ConstructionData
@@ -26,6 +35,13 @@ struct ConstructionData
   //! Define a seperator character used to differentiate a subobject key name and a count value.
   static constexpr char seperator = ';';
 
+  //! Allocator type, follows the same rules as Settings::allocator_type.
+  using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+  //! Map types, keys stay std::string objects to keep the maps' interfaces unchanged.
+  using SubObjectMap = std::pmr::map<std::string, ConstructionData, std::less<>>;
+  using SharedWareMap = std::pmr::map<std::string, std::shared_ptr<const Ware>, std::less<>>;
+
   //! Settings class enables a keyword - value dictionary for basic, scalar data.
   Settings s;
   Settings wareSettings;
@@ -34,10 +50,10 @@ struct ConstructionData
   Dataset ds;
 
   //! A std::map for recursevily storing other ConstructionData objects.
-  std::map<std::string, ConstructionData> subObjectData;
+  SubObjectMap subObjectData;
 
   //! A std::mop containing shared pointers to objects needed for construction.
-  std::map<std::string, std::shared_ptr<const Ware>> sharedWares;
+  SharedWareMap sharedWares;
 
   //! Forward a whole Settings object
   ConstructionData& set(Settings sNew) &;
@@ -51,6 +67,33 @@ struct ConstructionData
   ConstructionData(Usage u);
   ConstructionData();
 
+  //! Constructors allocating from the given allocator's memory resource.
+  explicit ConstructionData(allocator_type const& alloc);
+  ConstructionData(Usage u, allocator_type const& alloc);
+  ConstructionData(ConstructionData const& other, allocator_type const& alloc);
+  ConstructionData(ConstructionData&& other, allocator_type const& alloc);
+
+  ConstructionData(ConstructionData const& other) = default;
+  ConstructionData(ConstructionData&& other) = default;
+  ConstructionData& operator=(ConstructionData const& other) = default;
+  ConstructionData& operator=(ConstructionData&& other) = default;
+
+  //! Return the allocator whose memory resource is used for all members but the dataset.
+  allocator_type get_allocator() const noexcept;
+
+  //! Differences between two ConstructionData trees, see diff.
+  struct Diff;
+
+  /*! \brief Compare this tree with 'other' and return what differs.
+     *
+     * Sub-ConstructionData objects are matched by their keys in 'subObjectData' and compared
+     * recursively, subtrees which are equal do not show up in the result. Hence, a caller
+     * reconfiguring a running simulation only has to rebuild the objects listed by
+     * Diff::changedPaths. Shared wares are compared by the identity of the objects pointed to.
+     * Settings and Datasets which share their data with the other tree are compared in constant time.
+     */
+  Diff diff(ConstructionData const& other) const;
+
   //! Tell if this ConstructionData instance serves as a proxy.
   bool isProxy() const;
 
@@ -108,11 +151,8 @@ struct ConstructionData
   std::string createSubObjectKeyWithCounter(std::string key) const;
 
   //! Helper function to get back sub-ConstructionData structs  or shared wares stored in 'subObjectData' and 'sharedWares', respectively.
-  std::map<std::string, std::shared_ptr<const Ware>>::const_iterator getSharedWareWithCounter(
-      std::string key, label_t i) const;
-  std::map<std::string, ConstructionData>::const_iterator getSubObjectWithCounter(std::string key,
-                                                                                  label_t index
-                                                                                  = 0) const;
+  SharedWareMap::const_iterator getSharedWareWithCounter(std::string key, label_t i) const;
+  SubObjectMap::const_iterator getSubObjectWithCounter(std::string key, label_t index = 0) const;
 
   template <typename NR>
   ConstructionData& addSharedWare(NR const& nr = NR("")) &
@@ -122,7 +162,7 @@ struct ConstructionData
     // Next step is crucial for adding shared wares which refer to interface types!
     // s.set(key, nr.getId());
     wareSettings.set(key, nr.getId());
-    sharedWares.emplace(std::make_pair(key, nr.ptr()));
+    sharedWares.emplace(key, nr.ptr());
     return *this;
   }
 
@@ -134,7 +174,7 @@ struct ConstructionData
     // Next step is crucial for adding shared wares which refer to interface types!
     // s.set(key, nr.getId());
     wareSettings.set(key, nr.getId());
-    sharedWares.emplace(std::make_pair(key, nr.ptr()));
+    sharedWares.emplace(key, nr.ptr());
     return std::move(*this);
   }
 
@@ -147,16 +187,14 @@ struct ConstructionData
   template <typename NR>
   ConstructionData& addSubobject(ConstructionData const& cd = ConstructionData()) &
   {
-    subObjectData.emplace(
-        std::make_pair(createSubObjectKeyWithCounter(NR::getReferenceName()), cd));
+    subObjectData.emplace(createSubObjectKeyWithCounter(NR::getReferenceName()), cd);
     return *this;
   }
 
   template <typename NR>
   ConstructionData&& addSubobject(ConstructionData const& cd = ConstructionData()) &&
   {
-    subObjectData.emplace(
-        std::make_pair(createSubObjectKeyWithCounter(NR::getReferenceName()), cd));
+    subObjectData.emplace(createSubObjectKeyWithCounter(NR::getReferenceName()), cd);
     return std::move(*this);
   }
 
@@ -182,6 +220,46 @@ struct ConstructionData
   Usage usage_;
 };
 
+/*! \brief Differences between two ConstructionData trees, see ConstructionData::diff.
+ *
+ * The members describe how to turn the first tree into the second one. The diffs of
+ * sub-ConstructionData objects present in both trees are nested the same way as the trees.
+ */
+struct ConstructionData::Diff
+{
+  //! Patches turning the Settings members of the first object into those of the second one.
+  Settings::Patch settings;
+  Settings::Patch wareSettings;
+
+  bool usageChanged = false;
+  bool datasetChanged = false;
+
+  //! Keys of shared wares which are added, removed or refer to another object.
+  StringList changedSharedWares;
+
+  //! Keys in 'subObjectData' which only exist in the second or the first tree, respectively.
+  StringList addedSubObjects;
+  StringList removedSubObjects;
+
+  //! Diffs of sub-ConstructionData objects present in both trees which differ, ordered by key.
+  std::vector<std::pair<std::string, Diff>> changedSubObjects;
+
+  //! Tell if both trees are equal.
+  bool empty() const;
+
+  //! Tell if the compared objects themselves differ, not taking sub-ConstructionData objects into account.
+  bool ownMembersChanged() const;
+
+  /*! \brief Return the paths of all objects of the second tree which have to be rebuilt.
+     *
+     * These are added sub-ConstructionData objects, all objects whose own members changed and
+     * all objects which gained or lost sub-ConstructionData objects. A path joins the
+     * 'subObjectData' keys from the root down with '/', the root itself has an empty path.
+     * Objects are listed parents first.
+     */
+  StringList changedPaths() const;
+};
+
 }  // namespace DUTIL
 
 #endif  // DUTIL_CONSTRUCTIONDATA_H
@@ -7,6 +7,23 @@
 namespace DUTIL {
 
 namespace {
+//! Value checked for keys missing in construction data.
+Variant const noValue;
+
+/*! \brief Check A <= B for values of type T.
+ *
+ * Values already holding type T are compared in place, all others are converted first.
+ */
+template <typename T>
+bool checkNotGreater(Variant const& A, Variant const& B)
+{
+  T const* a = A.tryGet<T>();
+  T const* b = B.tryGet<T>();
+  if (a && b)
+    return !(*a > *b);
+  return !(A.getAs<T>() > B.getAs<T>());
+}
+
 bool checkASmallerThanB(Variant::Type type, Variant const& A, Variant const& B)
 {
   if (A.isMonostate() || B.isMonostate()) {
@@ -18,23 +35,23 @@ bool checkASmallerThanB(Variant::Type type, Variant const& A, Variant const& B)
 
   using T = Variant::Type;
   if (type == T::INT64) {
-    if (A.getAs<std::int64_t>() > B.getAs<std::int64_t>())
+    if (!checkNotGreater<std::int64_t>(A, B))
       return false;
   }
   if (type == T::LABEL) {
-    if (A.getAs<label_t>() > B.getAs<label_t>())
+    if (!checkNotGreater<label_t>(A, B))
       return false;
   } else if (type == T::DOUBLE) {
-    if (A.getAs<double>() > B.getAs<double>())
+    if (!checkNotGreater<double>(A, B))
       return false;
   } else if (type == T::UINT64) {
-    if (A.getAs<std::uint64_t>() > B.getAs<std::uint64_t>())
+    if (!checkNotGreater<std::uint64_t>(A, B))
       return false;
   }
   return true;
 }
 
-bool checkPresenceInListOfAllowedValues(StringList const& haystack, std::string const& needle)
+bool checkPresenceInListOfAllowedValues(StringList const& haystack, std::string_view needle)
 {
   if (haystack.empty())
     return false;
@@ -52,7 +69,8 @@ SettingRule checkSettingRule(SettingRule sr)
   D_ASSERT(!sr.key.empty());
   D_ASSERT(sr.defaultValue.isValid() || sr.usage != SettingRule::Usage::MANDATORY_WITH_DEFAULT);
   D_ASSERT(sr.defaultValue.isMonostate() || sr.usage != SettingRule::Usage::MANDATORY_NO_DEFAULT);
-  D_ASSERT(sr.listOfPossibleValues.empty() || sr.type == Variant::Type::STRING);
+  D_ASSERT(sr.listOfPossibleValues.empty() || sr.type == Variant::Type::STRING
+           || sr.type == Variant::Type::ENUM);
 
   if (sr.minimalValue.isValid()) {
     D_ASSERT(Variant::isNumeric(sr.type));
@@ -221,6 +239,16 @@ std::string ConstructionValidator::check(ConstructionData const& cd) const
     return check_(*this, cd);
 }
 
+std::string ConstructionValidator::checkSettings(SettingsView const& settings) const
+{
+  for (auto const& iter : settingRules_) {
+    auto errors = checkSettingRuleKeyAndReturnErrors(settings.tryGet(iter.first), iter.first);
+    if (!errors.empty())
+      return errors;
+  }
+  return {};
+}
+
 bool ConstructionValidator::hasSettingRule(std::string const& key) const
 {
   if (settingRules_.find(key) == settingRules_.end())
@@ -235,7 +263,7 @@ bool ConstructionValidator::hasWarelistRule(std::string const& key) const
   return true;
 }
 
-SettingRule ConstructionValidator::getSettingRule(std::string const& key) const
+SettingRule const& ConstructionValidator::getSettingRule(std::string const& key) const
 {
   auto rule = settingRules_.find(key);
   if (rule == settingRules_.end()) {
@@ -278,11 +306,11 @@ std::string ConstructionValidator::checkDataset(ConstructionData const& cd) cons
   return {};
 }
 
-Variant ConstructionValidator::checkSettingRuleKeyAndReturnValue(Variant const value,
-                                                                 std::string const& key,
+Variant ConstructionValidator::checkSettingRuleKeyAndReturnValue(Variant const& value,
+                                                                 SettingRule const& sr,
                                                                  std::string& error) const
 {
-  auto sr = getSettingRule(key);
+  std::string const& key = sr.key;
 
   // clang-format off
     if (sr.usage == SettingRule::Usage::MANDATORY_NO_DEFAULT && value.isMonostate()) {
@@ -308,8 +336,11 @@ Variant ConstructionValidator::checkSettingRuleKeyAndReturnValue(Variant const v
         return sr.defaultValue;
     }
 
-    // ckeck Variant type
-    if (value.getType() != sr.type && value.isValid()) {
+    // ckeck Variant type, named enums may also be given by their name, e.g. when read from text,
+    // and STRING rules, e.g. written by hand for an enum, accept named enums by their name
+    bool const isEnumName = (sr.type == Variant::Type::ENUM && value.isString())
+                            || (sr.type == Variant::Type::STRING && value.isEnum());
+    if (value.getType() != sr.type && value.isValid() && !isEnumName) {
         error = "Setting rule for key '" + key + "' and value: " + value.toString()
                 + "defines a different type for the parameter";
         return Variant();
@@ -317,7 +348,7 @@ Variant ConstructionValidator::checkSettingRuleKeyAndReturnValue(Variant const v
 
     // check list of possible values
     if (!sr.listOfPossibleValues.empty() && value.isValid()
-        && !checkPresenceInListOfAllowedValues(sr.listOfPossibleValues, value.toString())) {
+        && !checkPresenceInListOfAllowedValues(sr.listOfPossibleValues, value.asStringView())) {
         error = "Setting rule for key '"
                 + key + "' allows the following values: ";
         for (auto const &it : sr.listOfPossibleValues) {
@@ -342,7 +373,7 @@ Variant ConstructionValidator::checkSettingRuleKeyAndReturnValue(Variant const v
     }
 
     // check max string length
-    if (sr.type == Variant::Type::STRING && label_t(value.toString().size()) < sr.minimalStringLength) {
+    if ((value.isString() || value.isEnum()) && label_t(value.asStringView().size()) < sr.minimalStringLength) {
         error = "Setting for key '"
                 + key + "' and value: '" + value.toString()
                 + "' requires a min string length of "
@@ -592,17 +623,19 @@ std::string checkSubobjectListRecursevilyAndReturnErrors(
 
 std::string ConstructionValidator::checkSettingRuleKeyAndReturnErrors(ConstructionData const& cd,
                                                                       std::string const& key) const
+{
+  return checkSettingRuleKeyAndReturnErrors(cd.s.tryGet(key), key);
+}
+
+std::string ConstructionValidator::checkSettingRuleKeyAndReturnErrors(Variant const* value,
+                                                                      std::string const& key) const
 {
   std::string error;
-  auto keyList = cd.s.keys();
-  auto cdKey = std::find(keyList.cbegin(), keyList.cend(), key);
-  if (cdKey != keyList.cend()) {
-    if (cd.s.value(key).isValid() && !hasSettingRule(key)) {
-      return error
-             = "Construction data settings key '" + key + "' does not match any SettingRule key.";
-    }
+  if (value && value->isValid() && !hasSettingRule(key)) {
+    return error
+           = "Construction data settings key '" + key + "' does not match any SettingRule key.";
   }
-  checkSettingRuleKeyAndReturnValue(cd.s.value(key), key, error);
+  checkSettingRuleKeyAndReturnValue(value ? *value : noValue, getSettingRule(key), error);
   return error;
 }
 
@@ -688,10 +721,21 @@ std::string ConstructionValidator::checkSharedWareListAndReturnErrors(
 }
 
 Variant ConstructionValidator::validateSettingRuleKeyAndReturnValue(ConstructionData const& cd,
-                                                                    std::string const key) const
+                                                                    std::string_view key,
+                                                                    std::uint64_t keyHash) const
 {
+  return validateSettingRuleKeyAndReturnValue(cd.s.tryGet(key, keyHash), key);
+}
+
+Variant ConstructionValidator::validateSettingRuleKeyAndReturnValue(Variant const* stored,
+                                                                    std::string_view key) const
+{
+  auto const rule = settingRules_.find(key);
+  if (rule == settingRules_.end())
+    D_THROW("No SettingRule found for given key '" + std::string(key) + "'.");
+
   std::string error;
-  Variant value = checkSettingRuleKeyAndReturnValue(cd.s.value(key), key, error);
+  Variant value = checkSettingRuleKeyAndReturnValue(stored ? *stored : noValue, rule->second, error);
   if (!error.empty())
     D_THROW(error);
   return value;
@@ -7,6 +7,7 @@
 #include "constructiondata.h"
 #include "datasetrule.h"
 #include "settingrule.h"
+#include "settingsview.h"
 #include "warelistrule.h"
 
 #include <iostream>
@@ -73,7 +74,7 @@ class ConstructionValidator
   bool hasWarelistRule(std::string const& key) const;
 
   //! Return SettingRule object specified by key. If no rule is found, an exception is thrown.
-  SettingRule getSettingRule(std::string const& key) const;
+  SettingRule const& getSettingRule(std::string const& key) const;
 
   //! Return all setting rule keys. If there are no setting rules, the list will be empty.
   StringList getListOfSettingRuleKeys() const;
@@ -86,15 +87,39 @@ class ConstructionValidator
   template <typename NE, std::enable_if_t<std::is_enum_v<typename NE::EnumValues>, bool> = false>
   NE validateNamedEnum(ConstructionData const& cd) const
   {
-    return NE(validateSettingRuleKeyAndReturnValue(cd, NE::getEnumName()));
+    return NE(validateSettingRuleKeyAndReturnValue(cd, NE::getTypeInfo().name, NE::getEnumNameHash()));
   }
 
   template <typename NP>
   NP validateNamedParameter(ConstructionData const& cd) const
   {
-    return NP(validateSettingRuleKeyAndReturnValue(cd, NP::getParameterName()));
+    return NP(validateSettingRuleKeyAndReturnValue(cd, NP::getParameterName(),
+                                                   NP::getParameterNameHash()));
   }
 
+  /*! \brief Validation of layered settings, e.g. shared defaults with per-instrument overrides.
+   *
+   * The values are looked up through all layers of the view, see SettingsView, and checked
+   * against the setting rules like values given by construction data.
+   */
+  template <typename NE, std::enable_if_t<std::is_enum_v<typename NE::EnumValues>, bool> = false>
+  NE validateNamedEnum(SettingsView const& settings) const
+  {
+    return NE(validateSettingRuleKeyAndReturnValue(
+        settings.tryGet(NE::getTypeInfo().name, NE::getEnumNameHash()), NE::getTypeInfo().name));
+  }
+
+  template <typename NP>
+  NP validateNamedParameter(SettingsView const& settings) const
+  {
+    return NP(validateSettingRuleKeyAndReturnValue(
+        settings.tryGet(NP::getParameterName(), NP::getParameterNameHash()),
+        NP::getParameterName()));
+  }
+
+  //! Check all setting rules against layered settings, an empty string implies that no errors were found.
+  std::string checkSettings(SettingsView const& settings) const;
+
   template <typename NR>
   NR validateNamedReference(ConstructionData const& cd) const
   {
@@ -221,7 +246,7 @@ class ConstructionValidator
    * a DUTIL::Variant.
    * If a setting rule check fails, an MONOSTATE variant object will be returned.
    */
-  Variant checkSettingRuleKeyAndReturnValue(Variant const value, std::string const& key,
+  Variant checkSettingRuleKeyAndReturnValue(Variant const& value, SettingRule const& sr,
                                             std::string& error) const;
 
   /*! \brief Check functions.
@@ -232,6 +257,7 @@ class ConstructionValidator
    */
   std::string checkSettingRuleKeyAndReturnErrors(ConstructionData const& cd,
                                                  std::string const& key) const;
+  std::string checkSettingRuleKeyAndReturnErrors(Variant const* value, std::string const& key) const;
   std::string checkSubObjectAndReturnErrors(ConstructionData const& cd,
                                             std::string const& key) const;
   std::string checkSubObjectListAndReturnErrors(ConstructionData const& cd,
@@ -248,9 +274,12 @@ class ConstructionValidator
    * - calls the corresponding ckeck... function to test if the parameter fulfills the setting or warelist rule and
    * - crates a DUTIL::Variant containing the parameter value extracted from construction data structure or a whole
    *   ConstructionData struct itself to build subobjects.
+   *
+   * Settings values are looked up by the key hash computed at compile time, see Settings::tryGet.
    */
-  Variant validateSettingRuleKeyAndReturnValue(ConstructionData const& cd,
-                                               std::string const key) const;
+  Variant validateSettingRuleKeyAndReturnValue(ConstructionData const& cd, std::string_view key,
+                                               std::uint64_t keyHash) const;
+  Variant validateSettingRuleKeyAndReturnValue(Variant const* value, std::string_view key) const;
   ConstructionData const& validateAndReturnSubObjectCD(ConstructionData const& cd,
                                                        std::string const key) const;
   std::vector<ConstructionData const*> validateAndReturnSubobjectCDs(ConstructionData const& cd,
@@ -287,7 +316,7 @@ class ConstructionValidator
   };
 
   //! Members
-  std::map<std::string, SettingRule> settingRules_;
+  std::map<std::string, SettingRule, std::less<>> settingRules_;
   std::map<std::string, WarelistRule> warelistRules_;
   DatasetRule datasetRule_;
   CheckFunction check_;
@@ -0,0 +1,54 @@
+#include "conversion.h"
+#include <array>
+#include <system_error>
+
+namespace DUTIL {
+namespace Conversion {
+
+char const* errorToString(ConversionError error) noexcept
+{
+  switch (error) {
+    case ConversionError::NONE:
+      return "no error";
+    case ConversionError::INVALID:
+      return "invalid number";
+    case ConversionError::OUT_OF_RANGE:
+      return "number out of range";
+    case ConversionError::PRECISION_LOSS:
+      return "loss of precision";
+  }
+  return "unknown error";
+}
+
+ConversionResult<double> parseDouble(std::string_view str) noexcept
+{
+  str = Utility::trim(str);
+  if (!str.empty() && str.front() == '+') {
+    str.remove_prefix(1);
+    if (!str.empty() && str.front() == '-')
+      return {0.0, ConversionError::INVALID};
+  }
+
+  // std::from_chars only knows the decimal point, copy numbers with a decimal comma to a
+  // local buffer. Numbers do not need more characters than the buffer size.
+  std::array<char, 128> buffer;
+  auto const comma = str.find(',');
+  if (comma != std::string_view::npos) {
+    if (str.size() > buffer.size() || str.find_first_of(",.", comma + 1) != std::string_view::npos)
+      return {0.0, ConversionError::INVALID};
+    str.copy(buffer.data(), str.size());
+    buffer[comma] = '.';
+    str = std::string_view(buffer.data(), str.size());
+  }
+
+  double value = 0.0;
+  auto const [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+  if (ec == std::errc::result_out_of_range)
+    return {0.0, ConversionError::OUT_OF_RANGE};
+  if (ec != std::errc() || ptr != str.data() + str.size())
+    return {0.0, ConversionError::INVALID};
+  return {value, ConversionError::NONE};
+}
+
+}  // namespace Conversion
+}  // namespace DUTIL
@@ -0,0 +1,171 @@
+#ifndef DUTIL_CONVERSION_H
+#define DUTIL_CONVERSION_H
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include "trim.h"
+
+namespace DUTIL {
+
+//! Error codes reported by the numeric conversion functions below.
+enum class ConversionError : std::uint8_t {
+  NONE = 0,       //!< Conversion was exact.
+  INVALID,        //!< Input is not a number or the target type is not supported.
+  OUT_OF_RANGE,   //!< Value overflows the target type.
+  PRECISION_LOSS  //!< Value was converted but truncated or rounded, e.g. "2.5" into an integer.
+};
+
+/*! \brief Result of a numeric conversion.
+ *
+ * In case of ConversionError::PRECISION_LOSS, value holds the truncated or rounded result,
+ * in all other error cases value is default constructed.
+ */
+template <typename T>
+struct ConversionResult
+{
+  T value;
+  ConversionError error;
+
+  //! Tell if the conversion was exact.
+  bool ok() const noexcept { return error == ConversionError::NONE; }
+
+  //! Tell if a usable value is available, possibly with a loss of precision.
+  bool hasValue() const noexcept
+  {
+    return error == ConversionError::NONE || error == ConversionError::PRECISION_LOSS;
+  }
+};
+
+/*! \brief Exception-free, locale independent conversion between strings and numbers.
+ *
+ * All functions are based on std::from_chars and report errors by ConversionError codes.
+ * They never throw and never allocate.
+ */
+namespace Conversion {
+
+//! Return a short human readable description of an error code.
+char const* errorToString(ConversionError error) noexcept;
+
+/*! \brief Parse a floating point number.
+ *
+ * Accepts an optional leading '+' and a decimal comma instead of a decimal point.
+ * The whole input (apart from surrounding whitespace) has to be a number.
+ */
+ConversionResult<double> parseDouble(std::string_view str) noexcept;
+
+/*! \brief Convert an arithmetic value into another arithmetic type with range checking.
+ *
+ * Integral results of floating point input are truncated towards zero, which is reported as
+ * PRECISION_LOSS if the input has a fractional part. Integer input which is not exactly
+ * representable as double is reported as PRECISION_LOSS as well.
+ * Conversion into bool is always exact and yields value != 0.
+ */
+template <typename T, typename S>
+ConversionResult<T> numericCast(S value) noexcept
+{
+  static_assert(std::is_arithmetic_v<T> && std::is_arithmetic_v<S>);
+  using L = std::numeric_limits<T>;
+  if constexpr (std::is_same_v<T, S>) {
+    return {value, ConversionError::NONE};
+  } else if constexpr (std::is_same_v<T, bool>) {
+    return {value != 0, ConversionError::NONE};
+  } else if constexpr (std::is_floating_point_v<S> && std::is_integral_v<T>) {
+    if (value != value)
+      return {T(), ConversionError::INVALID};
+    // 2^digits is exactly representable and the first value which does not fit into T anymore.
+    S const upper = S(std::uint64_t(1) << (L::digits - 1)) * S(2);
+    bool const inRange = std::is_signed_v<T> ? (value >= -upper && value < upper)
+                                             : (value > S(-1) && value < upper);
+    if (!inRange)
+      return {T(), ConversionError::OUT_OF_RANGE};
+    T const result = static_cast<T>(value);
+    return {result, S(result) == value ? ConversionError::NONE : ConversionError::PRECISION_LOSS};
+  } else if constexpr (std::is_integral_v<S> && std::is_floating_point_v<T>) {
+    T const result = static_cast<T>(value);
+    // An integer is exact as floating point number if its significant bits fit into the mantissa.
+    std::uint64_t bits = std::uint64_t(value);
+    if constexpr (std::is_signed_v<S>) {
+      if (value < 0)
+        bits = std::uint64_t(0) - bits;
+    }
+    while (bits != 0 && (bits & 1u) == 0)
+      bits >>= 1;
+    bool const exact = bits < (std::uint64_t(1) << std::numeric_limits<T>::digits);
+    return {result, exact ? ConversionError::NONE : ConversionError::PRECISION_LOSS};
+  } else if constexpr (std::is_floating_point_v<S> && std::is_floating_point_v<T>) {
+    if (value == value && (value > S(L::max()) || value < S(L::lowest())))
+      return {T(), ConversionError::OUT_OF_RANGE};
+    T const result = static_cast<T>(value);
+    return {result, S(result) == value || value != value ? ConversionError::NONE
+                                                         : ConversionError::PRECISION_LOSS};
+  } else {
+    // integral to integral, negative values are compared as signed and all others as unsigned
+    if constexpr (std::is_signed_v<S>) {
+      if (value < 0) {
+        if (!std::is_signed_v<T> || std::intmax_t(value) < std::intmax_t(L::min()))
+          return {T(), ConversionError::OUT_OF_RANGE};
+        return {static_cast<T>(value), ConversionError::NONE};
+      }
+    }
+    if (std::uintmax_t(value) > std::uintmax_t(L::max()))
+      return {T(), ConversionError::OUT_OF_RANGE};
+    return {static_cast<T>(value), ConversionError::NONE};
+  }
+}
+
+/*! \brief Parse an arithmetic value of type T from a string.
+ *
+ * Surrounding whitespace is ignored.
+ * 1. Integers:
+ *    Parsed with std::from_chars. Numbers in decimal or exponent notation are accepted and
+ *    truncated, which is reported as PRECISION_LOSS if they have a fractional part.
+ *    For unsigned target types a minus sign is ignored and the absolute value is returned.
+ *    At most one leading sign is accepted.
+ * 2. Floating point numbers:
+ *    See parseDouble.
+ * 3. bool:
+ *    Any non-empty string is true, an empty string is false.
+ * 4. char:
+ *    A string consisting of exactly one character.
+ */
+template <typename T>
+ConversionResult<T> fromChars(std::string_view str) noexcept
+{
+  static_assert(std::is_arithmetic_v<T>);
+  str = Utility::trim(str);
+  if constexpr (std::is_same_v<T, bool>) {
+    return {!str.empty(), ConversionError::NONE};
+  } else if constexpr (std::is_same_v<T, char>) {
+    if (str.size() == 1)
+      return {str.front(), ConversionError::NONE};
+    return {char(), ConversionError::INVALID};
+  } else if constexpr (std::is_floating_point_v<T>) {
+    auto const result = parseDouble(str);
+    if (!result.hasValue())
+      return {T(), result.error};
+    return numericCast<T>(result.value);
+  } else {
+    auto const isSign = [](char c) { return c == '+' || c == '-'; };
+    if (str.size() > 1 && isSign(str[0]) && isSign(str[1]))
+      return {T(), ConversionError::INVALID};
+    if (!str.empty() && (str.front() == '+' || (std::is_unsigned_v<T> && str.front() == '-')))
+      str.remove_prefix(1);
+    T value{};
+    auto const [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (ec == std::errc() && ptr == str.data() + str.size())
+      return {value, ConversionError::NONE};
+    if (ec == std::errc::result_out_of_range)
+      return {T(), ConversionError::OUT_OF_RANGE};
+    // decimal or exponent notation, e.g. "12.5" or "1e3"
+    auto const real = parseDouble(str);
+    if (!real.hasValue())
+      return {T(), real.error};
+    return numericCast<T>(real.value);
+  }
+}
+
+}  // namespace Conversion
+}  // namespace DUTIL
+#endif  // DUTIL_CONVERSION_H
@@ -1,27 +1,41 @@
 #include "dataset.h"
 #include <limits.h>  // for CHAR_BIT
 #include <algorithm>
+#include <array>
 #include <climits>
 #include <cstring>
 #include <limits>
+#include <mutex>
+#include <numeric>
+#include <tuple>
+#include <utility>
 #include "constructiondata.h"
 #include "exception.h"
+#include "simd.h"
 
 namespace DUTIL {
 
 Dataset::Dataset() :
+    t_(Type::EMPTY),
     cols_(1),
     size_(0),
-    values_(std::make_shared<std::vector<int>>())
+    values_(),
+    data_(nullptr),
+    external_(false),
+    externalBytes_(0),
+    sliced_(false),
+    rowStride_(1),
+    colStride_(1),
+    cache_()
 {}
 
 Dataset::Dataset(char const* buffer, label_t length, label_t nCols) :
     t_(Type::UINT8),
-    size_(length),
-    values_(std::make_shared<std::vector<uint8_t>>(length))
+    size_(length)
 {
-  std::memcpy(std::static_pointer_cast<std::vector<uint8_t>>(values_)->data(), buffer,
-              std::size_t(length));
+  std::vector<uint8_t> bytes(static_cast<std::size_t>(length));
+  std::memcpy(bytes.data(), buffer, std::size_t(length));
+  setVector(std::move(bytes));
   setCols(nCols);
 }
 
@@ -49,6 +63,21 @@ void Dataset::setCols(label_t cols)
   if (getType() == Type::EMPTY)
     cols = 1;
   cols_ = cols;
+  rowStride_ = cols;
+  colStride_ = 1;
+}
+
+void Dataset::checkType(Type requested) const
+{
+  if (t_ != requested)
+    D_THROW("Dataset holds values of type " + t_.toString() + ", requested type is "
+            + requested.toString() + ".");
+}
+
+void Dataset::checkContiguous() const
+{
+  if (!isContiguous())
+    D_THROW("Dataset values are not contiguous, use view() or contiguous().");
 }
 
 label_t Dataset::translateIndex(label_t i, label_t j) const
@@ -56,11 +85,63 @@ label_t Dataset::translateIndex(label_t i, label_t j) const
   if (j < 0 || j >= cols_)
     D_THROW(std::string("illegal column index ") + Utility::toString(j)
             + ", number of columns is currently " + Utility::toString(cols_));
-  label_t index = i * cols_ + j;
-  if (index < 0 || index >= size_)
+  if (i < 0 || i >= getRows())
     D_THROW(std::string("illegal row index ") + Utility::toString(i)
-            + ", number of rows is currently " + Utility::toString(size_ / cols_));
-  return index;
+            + ", number of rows is currently " + Utility::toString(getRows()));
+  return label_t(i * rowStride_ + j * colStride_);
+}
+
+bool Dataset::isContiguous() const noexcept
+{
+  return (colStride_ == 1 || cols_ <= 1) && (rowStride_ == cols_ || getRows() <= 1);
+}
+
+Dataset Dataset::slice(std::ptrdiff_t offset, label_t rows, label_t cols, std::ptrdiff_t rowStride,
+                       std::ptrdiff_t colStride) const
+{
+  Dataset result(*this);
+  // a selection without rows keeps type and columns; its offset may point past the values
+  if (rows > 0)
+    result.data_ = static_cast<char const*>(data_) + offset * std::ptrdiff_t(getElementSize(t_));
+  result.size_ = rows * cols;
+  result.cols_ = cols;
+  result.rowStride_ = rowStride;
+  result.colStride_ = cols > 1 ? colStride : 1;
+  result.sliced_ = true;
+  result.cache_.reset();
+  return result;
+}
+
+Dataset Dataset::rows(label_t begin, label_t end) const
+{
+  if (begin < 0 || end < begin || end > getRows())
+    D_THROW("illegal row range [" + Utility::toString(begin) + ", " + Utility::toString(end)
+            + "), number of rows is currently " + Utility::toString(getRows()));
+  if (begin == 0 && end == getRows())
+    return *this;
+  return slice(begin * rowStride_, end - begin, cols_, rowStride_, colStride_);
+}
+
+Dataset Dataset::columns(label_t first, label_t count, label_t step) const
+{
+  auto const exists = [this](label_t j) { return j >= 0 && j < cols_; };
+  if (count < 1 || !exists(first) || !exists(first + (count - 1) * step))
+    D_THROW("illegal selection of " + Utility::toString(count) + " columns from column "
+            + Utility::toString(first) + " with step " + Utility::toString(step)
+            + ", number of columns is currently " + Utility::toString(cols_));
+  if (first == 0 && count == cols_ && step == 1)
+    return *this;
+  return slice(first * colStride_, getRows(), count, rowStride_, step * colStride_);
+}
+
+Dataset Dataset::columns(std::initializer_list<label_t> indices) const
+{
+  return selectColumns(indices.begin(), indices.size());
+}
+
+Dataset Dataset::columns(std::vector<label_t> const& indices) const
+{
+  return selectColumns(indices.data(), indices.size());
 }
 
 namespace {
@@ -72,120 +153,218 @@ void checkSize(label_t expectedSize, label_t actualSize)
 }
 
 template <typename RESULT_TYPE, typename INTERNAL_TYPE>
-std::shared_ptr<std::vector<RESULT_TYPE>> convertValues(std::shared_ptr<void> values)
-{
-  if (std::is_same<RESULT_TYPE, INTERNAL_TYPE>())
-    return std::static_pointer_cast<std::vector<RESULT_TYPE>>(values);
-  auto actualValues = std::static_pointer_cast<std::vector<INTERNAL_TYPE>>(values);
-  size_t size = actualValues->size();
-  auto convertedValues = std::make_shared<std::vector<RESULT_TYPE>>(size);
-  for (size_t i = 0; i < size; i++)
-    (*convertedValues)[i] = static_cast<RESULT_TYPE>((*actualValues)[i]);
+std::shared_ptr<const std::vector<RESULT_TYPE>> convertValues(DatasetView<INTERNAL_TYPE> const& values,
+                                                              std::shared_ptr<void const> const& vector)
+{
+  if constexpr (std::is_same_v<RESULT_TYPE, INTERNAL_TYPE>) {
+    // a vector of the requested type is shared instead of copied
+    if (vector)
+      return std::static_pointer_cast<const std::vector<RESULT_TYPE>>(vector);
+  }
+  auto convertedValues = std::make_shared<std::vector<RESULT_TYPE>>(values.size());
+  if (values.isContiguous()) {
+    SIMD::convert(values.data(), convertedValues->data(), values.size());
+    return convertedValues;
+  }
+
+  // selections are gathered row by row, adjacent columns are still converted as a block
+  RESULT_TYPE* row = convertedValues->data();
+  for (label_t i = 0; i < values.rows(); ++i, row += values.cols()) {
+    if (values.colStride() == 1) {
+      SIMD::convert(&values(i, 0), row, std::size_t(values.cols()));
+      continue;
+    }
+    for (label_t j = 0; j < values.cols(); ++j) {
+      row[j] = static_cast<RESULT_TYPE>(values(i, j));
+    }
+  }
   return convertedValues;
 }
 
+template <typename INTERNAL_TYPE>
+bool equalValues(DatasetView<INTERNAL_TYPE> const& lhs, DatasetView<INTERNAL_TYPE> const& rhs)
+{
+  if (lhs.isContiguous() && rhs.isContiguous())
+    return std::equal(lhs.data(), lhs.data() + lhs.size(), rhs.data());
+  for (label_t i = 0; i < lhs.rows(); ++i) {
+    for (label_t j = 0; j < lhs.cols(); ++j) {
+      if (lhs(i, j) != rhs(i, j))
+        return false;
+    }
+  }
+  return true;
+}
+
+//! Copy the given columns of all rows into a new Dataset.
+template <typename INTERNAL_TYPE>
+Dataset gatherColumns(DatasetView<INTERNAL_TYPE> const& values, label_t const* indices, std::size_t count)
+{
+  std::vector<INTERNAL_TYPE> gathered;
+  gathered.reserve(std::size_t(values.rows()) * count);
+  for (label_t i = 0; i < values.rows(); ++i) {
+    for (std::size_t k = 0; k < count; ++k) {
+      gathered.push_back(values(i, indices[k]));
+    }
+  }
+  return Dataset(std::move(gathered), label_t(count));
+}
+
 static_assert(CHAR_BIT == 8, "This code assumes that char is an 8-bit type.");
 static_assert(sizeof(float) == 4, "This code assumes that float is a 32-bit type.");
 static_assert(sizeof(double) == 8, "This code assumes that double is a 64-bit type.");
 
 template <typename RESULT_TYPE>
-std::shared_ptr<std::vector<RESULT_TYPE>> convertValues(Dataset::Type t,
-                                                        std::shared_ptr<void> values)
-{
-  switch (t) {
-    case Dataset::Type::EMPTY:
-      return std::make_shared<std::vector<RESULT_TYPE>>();
-    case Dataset::Type::INT8:
-      return convertValues<RESULT_TYPE, int8_t>(values);
-    case Dataset::Type::UINT8:
-      return convertValues<RESULT_TYPE, uint8_t>(values);
-    case Dataset::Type::INT16:
-      return convertValues<RESULT_TYPE, int16_t>(values);
-    case Dataset::Type::UINT16:
-      return convertValues<RESULT_TYPE, uint16_t>(values);
-    case Dataset::Type::INT32:
-      return convertValues<RESULT_TYPE, int32_t>(values);
-    case Dataset::Type::UINT32:
-      return convertValues<RESULT_TYPE, uint32_t>(values);
-    case Dataset::Type::INT64:
-      return convertValues<RESULT_TYPE, int64_t>(values);
-    case Dataset::Type::UINT64:
-      return convertValues<RESULT_TYPE, uint64_t>(values);
-    case Dataset::Type::FLOAT32:
-      return convertValues<RESULT_TYPE, float>(values);
-    case Dataset::Type::FLOAT64:
-      return convertValues<RESULT_TYPE, double>(values);
-  }
-  return nullptr;
+std::shared_ptr<const std::vector<RESULT_TYPE>> convertValues(Dataset const& ds,
+                                                              std::shared_ptr<void const> const& vector)
+{
+  if (ds.getType() == Dataset::Type::EMPTY)
+    return std::make_shared<std::vector<RESULT_TYPE>>();
+  return ds.visit([&vector](auto const& values) { return convertValues<RESULT_TYPE>(values, vector); });
+}
+
+Dataset gatherColumns(Dataset const& ds, label_t const* indices, std::size_t count)
+{
+  if (ds.getType() == Dataset::Type::EMPTY)
+    return Dataset();
+  return ds.visit([indices, count](auto const& values) { return gatherColumns(values, indices, count); });
+}
+template <typename TYPE, typename TYPES, std::size_t... I>
+constexpr int cacheSlot(std::index_sequence<I...>)
+{
+  int slot = -1;
+  ((slot = std::is_same_v<TYPE, std::tuple_element_t<I, TYPES>> ? int(I) : slot), ...);
+  return slot;
+}
+
+//! Slot of TYPE in the conversion cache, -1 for types that are not cached.
+template <typename TYPE>
+constexpr int cacheSlot()
+{
+  using Types = std::tuple<int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, uint64_t,
+                           float, double>;
+  return cacheSlot<TYPE, Types>(std::make_index_sequence<std::tuple_size_v<Types>>());
 }
 }  // end anonymous namespace
 
-std::shared_ptr<std::vector<int8_t>> Dataset::getValuesINT8(label_t expectedSize) const
+Dataset Dataset::selectColumns(label_t const* indices, std::size_t count) const
 {
-  checkSize(expectedSize, size_);
-  return convertValues<int8_t>(t_, values_);
+  if (count == 0)
+    D_THROW("no columns selected");
+  label_t const step = count > 1 ? indices[1] - indices[0] : 1;
+  bool evenlySpaced = true;
+  for (std::size_t k = 1; k < count; ++k) {
+    evenlySpaced = evenlySpaced && indices[k] - indices[k - 1] == step;
+  }
+  if (evenlySpaced)
+    return columns(indices[0], label_t(count), step);
+
+  for (std::size_t k = 0; k < count; ++k) {
+    if (indices[k] < 0 || indices[k] >= cols_)
+      D_THROW(std::string("illegal column index ") + Utility::toString(indices[k])
+              + ", number of columns is currently " + Utility::toString(cols_));
+  }
+  return gatherColumns(*this, indices, count);
 }
 
-std::shared_ptr<std::vector<uint8_t>> Dataset::getValuesUINT8(label_t expectedSize) const
+Dataset Dataset::contiguous() const
 {
-  checkSize(expectedSize, size_);
-  return convertValues<uint8_t>(t_, values_);
+  if (isContiguous())
+    return *this;
+  std::vector<label_t> indices(std::size_t(cols_), 0);
+  std::iota(indices.begin(), indices.end(), 0);
+  return gatherColumns(*this, indices.data(), indices.size());
 }
 
-std::shared_ptr<std::vector<int16_t>> Dataset::getValuesINT16(label_t expectedSize) const
+//! Converted values per result type, shared by all copies of a Dataset.
+struct Dataset::ConversionCache
 {
-  checkSize(expectedSize, size_);
-  return convertValues<int16_t>(t_, values_);
+  std::mutex mutex;
+  std::array<std::shared_ptr<void const>, 10> vectors;
+  std::size_t bytes = 0;
+};
+
+void Dataset::enableConversionCache()
+{
+  if (!cache_)
+    cache_ = std::make_shared<ConversionCache>();
 }
 
-std::shared_ptr<std::vector<uint16_t>> Dataset::getValuesUINT16(label_t expectedSize) const
+template <typename TYPE>
+std::shared_ptr<const std::vector<TYPE>> Dataset::convertedValues(label_t expectedSize) const
 {
   checkSize(expectedSize, size_);
-  return convertValues<uint16_t>(t_, values_);
+  constexpr int slot = cacheSlot<TYPE>();
+  bool const converts = external_ || sliced_ || (t_ != Type::EMPTY && slot != int(t_) - 1);
+  if (slot < 0 || !cache_ || !converts)
+    return convertValues<TYPE>(*this, external_ || sliced_ ? nullptr : values_);
+
+  // Datasets are immutable, so each conversion is done once and never invalidated. Converting under
+  // the lock keeps concurrent first calls from converting the same values twice.
+  std::lock_guard<std::mutex> lock(cache_->mutex);
+  auto& cached = cache_->vectors[std::size_t(slot)];
+  if (!cached) {
+    auto values = convertValues<TYPE>(*this, nullptr);
+    cache_->bytes += sizeof(TYPE) * values->capacity();
+    cached = std::move(values);
+  }
+  return std::static_pointer_cast<const std::vector<TYPE>>(cached);
 }
 
-std::shared_ptr<std::vector<int32_t>> Dataset::getValuesINT32(label_t expectedSize) const
+std::shared_ptr<const std::vector<int8_t>> Dataset::getValuesINT8(label_t expectedSize) const
 {
-  checkSize(expectedSize, size_);
-  return convertValues<int32_t>(t_, values_);
+  return convertedValues<int8_t>(expectedSize);
 }
 
-std::shared_ptr<std::vector<uint32_t>> Dataset::getValuesUINT32(label_t expectedSize) const
+std::shared_ptr<const std::vector<uint8_t>> Dataset::getValuesUINT8(label_t expectedSize) const
 {
-  checkSize(expectedSize, size_);
-  return convertValues<uint32_t>(t_, values_);
+  return convertedValues<uint8_t>(expectedSize);
 }
 
-std::shared_ptr<std::vector<int64_t>> Dataset::getValuesINT64(label_t expectedSize) const
+std::shared_ptr<const std::vector<int16_t>> Dataset::getValuesINT16(label_t expectedSize) const
 {
-  checkSize(expectedSize, size_);
-  return convertValues<int64_t>(t_, values_);
+  return convertedValues<int16_t>(expectedSize);
 }
 
-std::shared_ptr<std::vector<uint64_t>> Dataset::getValuesUINT64(label_t expectedSize) const
+std::shared_ptr<const std::vector<uint16_t>> Dataset::getValuesUINT16(label_t expectedSize) const
 {
-  checkSize(expectedSize, size_);
-  return convertValues<uint64_t>(t_, values_);
+  return convertedValues<uint16_t>(expectedSize);
+}
+
+std::shared_ptr<const std::vector<int32_t>> Dataset::getValuesINT32(label_t expectedSize) const
+{
+  return convertedValues<int32_t>(expectedSize);
+}
+
+std::shared_ptr<const std::vector<uint32_t>> Dataset::getValuesUINT32(label_t expectedSize) const
+{
+  return convertedValues<uint32_t>(expectedSize);
+}
+
+std::shared_ptr<const std::vector<int64_t>> Dataset::getValuesINT64(label_t expectedSize) const
+{
+  return convertedValues<int64_t>(expectedSize);
+}
+
+std::shared_ptr<const std::vector<uint64_t>> Dataset::getValuesUINT64(label_t expectedSize) const
+{
+  return convertedValues<uint64_t>(expectedSize);
 }
 
 #if defined(D_MINGW_MXE) || defined(D_MINGW_NATIVE) || defined(D_MSVC)
-std::shared_ptr<std::vector<long>> Dataset::getValuesLONG(label_t expectedSize) const
+std::shared_ptr<const std::vector<long>> Dataset::getValuesLONG(label_t expectedSize) const
 {
-  checkSize(expectedSize, size_);
-  return convertValues<long>(t_, values_);
+  return convertedValues<long>(expectedSize);
 }
 #endif
 
-std::shared_ptr<std::vector<float>> Dataset::getValuesFLOAT(label_t expectedSize) const
+std::shared_ptr<const std::vector<float>> Dataset::getValuesFLOAT(label_t expectedSize) const
 {
-  checkSize(expectedSize, size_);
-  return convertValues<float>(t_, values_);
+  return convertedValues<float>(expectedSize);
 }
 
-std::shared_ptr<std::vector<double>> Dataset::getValuesDOUBLE(label_t expectedSize) const
+std::shared_ptr<const std::vector<double>> Dataset::getValuesDOUBLE(label_t expectedSize) const
 {
-  checkSize(expectedSize, size_);
-  return convertValues<double>(t_, values_);
+  return convertedValues<double>(expectedSize);
 }
 
 template <>
@@ -338,6 +517,13 @@ std::shared_ptr<const std::vector<long>> Dataset::getPointerToValues<long>(
 }
 #endif
 
+std::size_t Dataset::getElementSize(Type t)
+{
+  if (t == Type::EMPTY)
+    return 0;
+  return dispatch(t, [](auto tag) { return sizeof(typename decltype(tag)::type); });
+}
+
 label_t Dataset::getUseCount() const
 {
   return values_.use_count();
@@ -345,63 +531,33 @@ label_t Dataset::getUseCount() const
 
 size_t Dataset::getAllocatedSize() const
 {
-  // Since the vector is never reallocated, we expect capacity to equal size.
-  // No guarantee for this though.
-  switch (t_) {
-    case Type::INT8:
-      return sizeof(int8_t) * std::static_pointer_cast<std::vector<int8_t>>(values_)->capacity();
-    case Type::UINT8:
-      return sizeof(uint8_t) * std::static_pointer_cast<std::vector<uint8_t>>(values_)->capacity();
-    case Type::INT16:
-      return sizeof(int16_t) * std::static_pointer_cast<std::vector<int16_t>>(values_)->capacity();
-    case Type::UINT16:
-      return sizeof(uint16_t)
-             * std::static_pointer_cast<std::vector<uint16_t>>(values_)->capacity();
-    case Type::INT32:
-      return sizeof(int32_t) * std::static_pointer_cast<std::vector<int32_t>>(values_)->capacity();
-    case Type::UINT32:
-      return sizeof(uint32_t)
-             * std::static_pointer_cast<std::vector<uint32_t>>(values_)->capacity();
-    case Type::INT64:
-      return sizeof(int64_t) * std::static_pointer_cast<std::vector<int64_t>>(values_)->capacity();
-    case Type::UINT64:
-      return sizeof(uint64_t)
-             * std::static_pointer_cast<std::vector<uint64_t>>(values_)->capacity();
-    case Type::FLOAT32:
-      return sizeof(float) * std::static_pointer_cast<std::vector<float>>(values_)->capacity();
-    case Type::FLOAT64:
-      return sizeof(double) * std::static_pointer_cast<std::vector<double>>(values_)->capacity();
+  std::size_t cached = 0;
+  if (cache_) {
+    std::lock_guard<std::mutex> lock(cache_->mutex);
+    cached = cache_->bytes;
   }
+  return cached + getValuesSize();
+}
+
+size_t Dataset::getValuesSize() const
+{
+  if (external_)
+    return externalBytes_;
 
-  return 0;  // for EMPTY
+  if (t_ == Type::EMPTY)
+    return 0;
+
+  // Since the vector is never reallocated, we expect capacity to equal size.
+  // No guarantee for this though.
+  return dispatch(t_, [this](auto tag) {
+    using TYPE = typename decltype(tag)::type;
+    return sizeof(TYPE) * std::static_pointer_cast<const std::vector<TYPE>>(values_)->capacity();
+  });
 }
 
 size_t Dataset::getNumberOfCurrentlyStoredData() const
 {
-  switch (t_) {
-    case Type::INT8:
-      return sizeof(int8_t) * std::static_pointer_cast<std::vector<int8_t>>(values_)->size();
-    case Type::UINT8:
-      return sizeof(uint8_t) * std::static_pointer_cast<std::vector<uint8_t>>(values_)->size();
-    case Type::INT16:
-      return sizeof(int16_t) * std::static_pointer_cast<std::vector<int16_t>>(values_)->size();
-    case Type::UINT16:
-      return sizeof(uint16_t) * std::static_pointer_cast<std::vector<uint16_t>>(values_)->size();
-    case Type::INT32:
-      return sizeof(int32_t) * std::static_pointer_cast<std::vector<int32_t>>(values_)->size();
-    case Type::UINT32:
-      return sizeof(uint32_t) * std::static_pointer_cast<std::vector<uint32_t>>(values_)->size();
-    case Type::INT64:
-      return sizeof(int64_t) * std::static_pointer_cast<std::vector<int64_t>>(values_)->size();
-    case Type::UINT64:
-      return sizeof(uint64_t) * std::static_pointer_cast<std::vector<uint64_t>>(values_)->size();
-    case Type::FLOAT32:
-      return sizeof(float) * std::static_pointer_cast<std::vector<float>>(values_)->size();
-    case Type::FLOAT64:
-      return sizeof(double) * std::static_pointer_cast<std::vector<double>>(values_)->size();
-  }
-
-  return 0;  // for EMPTY
+  return getElementSize(t_) * std::size_t(size_);
 }
 
 bool Dataset::operator==(Dataset const& other) const
@@ -413,45 +569,14 @@ bool Dataset::operator==(Dataset const& other) const
   if (size_ != other.size_)
     return false;
 
-  if (values_ == other.values_)
+  if (data_ == other.data_ && rowStride_ == other.rowStride_ && colStride_ == other.colStride_)
     return true;
 
-  switch (t_) {
-    case Type::EMPTY:
-      return true;
-    case Type::INT8:
-      return *std::static_pointer_cast<std::vector<int8_t>>(values_)
-             == *std::static_pointer_cast<std::vector<int8_t>>(other.values_);
-    case Type::UINT8:
-      return *std::static_pointer_cast<std::vector<uint8_t>>(values_)
-             == *std::static_pointer_cast<std::vector<uint8_t>>(other.values_);
-    case Type::INT16:
-      return *std::static_pointer_cast<std::vector<int16_t>>(values_)
-             == *std::static_pointer_cast<std::vector<int16_t>>(other.values_);
-    case Type::UINT16:
-      return *std::static_pointer_cast<std::vector<uint16_t>>(values_)
-             == *std::static_pointer_cast<std::vector<uint16_t>>(other.values_);
-    case Type::INT32:
-      return *std::static_pointer_cast<std::vector<int32_t>>(values_)
-             == *std::static_pointer_cast<std::vector<int32_t>>(other.values_);
-    case Type::UINT32:
-      return *std::static_pointer_cast<std::vector<uint32_t>>(values_)
-             == *std::static_pointer_cast<std::vector<uint32_t>>(other.values_);
-    case Type::INT64:
-      return *std::static_pointer_cast<std::vector<int64_t>>(values_)
-             == *std::static_pointer_cast<std::vector<int64_t>>(other.values_);
-    case Type::UINT64:
-      return *std::static_pointer_cast<std::vector<uint64_t>>(values_)
-             == *std::static_pointer_cast<std::vector<uint64_t>>(other.values_);
-    case Type::FLOAT32:
-      return *std::static_pointer_cast<std::vector<float>>(values_)
-             == *std::static_pointer_cast<std::vector<float>>(other.values_);
-    case Type::FLOAT64:
-      return *std::static_pointer_cast<std::vector<double>>(values_)
-             == *std::static_pointer_cast<std::vector<double>>(other.values_);
-  }
-
-  return false;
+  if (t_ == Type::EMPTY)
+    return true;
+  return visit([&other](auto const& values) {
+    return equalValues(values, other.view<typename std::decay_t<decltype(values)>::value_type>());
+  });
 }
 
 bool Dataset::operator!=(Dataset const& other) const
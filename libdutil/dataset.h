@@ -1,8 +1,10 @@
 #ifndef DUTIL_DATASET_H
 #define DUTIL_DATASET_H
 #include <complex>
+#include <initializer_list>
 #include <memory>
 #include <vector>
+#include "datasetview.h"
 #include "namedenum.h"
 
 namespace DUTIL {
@@ -19,8 +21,16 @@ namespace DUTIL {
  *
  * Dataset objects act as a bridge between the low-level storage of numerical data and the high-level definition
  * of parameterized physical quantities, such as permittivity as a
- * function of wavelength. Datasets can be read from or written to CSV files or stored in Database objects. Conversion
+ * function of wavelength. Datasets can be read from or written to CSV files, binary files (see DatasetFile) or stored
+ * in Database objects. Conversion
  * functionality exists in order to interpret the data as vectors of given type.
+ *
+ * rows() and columns() select a part of the values without copying them. The selection is a
+ * Dataset of its own which shares the values with the original one and describes its part by the
+ * position of the first value and the distances between rows and columns:
+ *
+ * Dataset const year = prices.rows(first, last);
+ * Dataset const closes = year.columns({3});
  */
 
 class Dataset
@@ -38,6 +48,36 @@ class Dataset
   template <typename RESULT_TYPE>
   static Type TypeMap();
 
+  //! Return the size of a single value of the given type in bytes, 0 for EMPTY.
+  static std::size_t getElementSize(Type t);
+
+  //! Names a C++ type, passed to the functor of dispatch().
+  template <typename TYPE>
+  struct TypeTag
+  {
+    using type = TYPE;
+  };
+
+  /*! \brief Call f(TypeTag<TYPE>()) with the C++ type TYPE of 't' and return the result.
+     *
+     * This is the one place mapping data types to C++ types, code handling all of them uses it or
+     * visit() instead of a switch of its own:
+     *
+     * return Dataset::dispatch(type, [&](auto tag) { return parse<typename decltype(tag)::type>(text); });
+     *
+     * EMPTY has no C++ type and throws an exception.
+     */
+  template <typename F>
+  static decltype(auto) dispatch(Type t, F&& f);
+
+  /*! \brief Call f with the typed view() of the values and return the result.
+     *
+     * f has to accept a DatasetView of every data type, a generic lambda does. EMPTY datasets
+     * throw an exception, check getType() first.
+     */
+  template <typename F>
+  decltype(auto) visit(F&& f) const;
+
   /*! \brief Create an empty Dataset
      *
      * By default, the number of columns is set to 1 and the type to EMPTY.
@@ -54,6 +94,10 @@ class Dataset
      *
      * Note that the Dataset type is set to EMPTY if the vector has size 0.
      *
+     * The vector is moved into the Dataset, pass an rvalue to store the values without copying them:
+     *
+     * Dataset ds(std::move(ticks));
+     *
      * nCols must be a positive integer, otherwise trigger fatal error.
      * The size of the raw data array must also be divisible by this number,
      * otherwise trigger fatal error.
@@ -79,9 +123,27 @@ class Dataset
   template <typename TYPE>
   explicit Dataset(std::vector<std::complex<TYPE>> values);
 
-  //! Store "length" raw bytes as uint8_t in the table.
+  //! Store "length" raw bytes as uint8_t in the table. The bytes are copied.
   Dataset(char const* buffer, label_t length, label_t nCols = 1);
 
+  /*! \brief Wrap 'size' values owned by somebody else without copying them.
+     *
+     * The values have to stay valid and unchanged as long as 'owner' is alive. The Dataset and all
+     * of its copies hold a reference to 'owner', the memory is released together with the last of
+     * them. Use the deleter or aliasing constructors of std::shared_ptr to pass the ownership on:
+     *
+     * double* ticks = allocateTicks(n);
+     * Dataset ds(ticks, n, std::shared_ptr<void const>(ticks, &freeTicks));
+     *
+     * std::shared_ptr<TickStore> store = ...;
+     * Dataset ds(store->prices(), store->size(), store);
+     *
+     * nCols follows the rules of the vector constructor. getValues and getPointerToValues return
+     * copies of external values, use getRawData to access them in place.
+     */
+  template <typename TYPE>
+  Dataset(TYPE const* data, std::size_t size, std::shared_ptr<void const> owner, label_t nCols = 1);
+
   //! \brief Return the data type.
   Type getType() const;
 
@@ -103,11 +165,53 @@ class Dataset
      *
      * Passing illegal values of i and j will trigger an exception.
      * If the desired type does not precisely match the internal type, attempt
-     * a conversion.
+     * a conversion of the single item.
+     *
+     * Loops over many items should use view() instead.
      */
   template <typename TYPE>
   TYPE getValue(label_t i, label_t j) const;
 
+  /*! \brief Return a typed 2D view of the values without copying them.
+     *
+     * TYPE has to match the data type, otherwise an exception is thrown. Nothing is converted,
+     * use getValues or getPointerToValues for conversions. An EMPTY dataset returns an empty view
+     * for any TYPE.
+     *
+     * The view is valid as long as this Dataset or one of its copies exists, see DatasetView.
+     */
+  template <typename TYPE>
+  DatasetView<TYPE> view() const;
+
+  /*! \brief Return the rows [begin, end) without copying them.
+     *
+     * The result shares the values with this Dataset and keeps them alive like a copy, nothing is
+     * allocated. Throws if the range is not within the rows. An empty range returns a Dataset of
+     * the same type and columns without rows.
+     */
+  Dataset rows(label_t begin, label_t end) const;
+
+  /*! \brief Return 'count' columns starting at column 'first' and 'step' columns apart.
+     *
+     * The values are shared as for rows(). The step may be negative to reverse the order of the
+     * columns. Throws if a selected column does not exist.
+     */
+  Dataset columns(label_t first, label_t count, label_t step = 1) const;
+
+  /*! \brief Return the given columns in the given order.
+     *
+     * Evenly spaced columns, such as {2} or {4, 2, 0}, are selected without copying like
+     * columns(first, count, step). Other selections are copied into a new Dataset.
+     */
+  Dataset columns(std::initializer_list<label_t> indices) const;
+  Dataset columns(std::vector<label_t> const& indices) const;
+
+  //! Tell if the values are stored row by row without gaps, which is false for some selections.
+  bool isContiguous() const noexcept;
+
+  //! Return this Dataset if its values are contiguous, a contiguous copy of them otherwise.
+  Dataset contiguous() const;
+
   /*! \brief Return a copy of the data row-by-row as a flat array.
      *
      * If the desired data type does not match the internal type, attempt
@@ -137,10 +241,43 @@ class Dataset
   template <typename TYPE>
   std::shared_ptr<const std::vector<TYPE>> getPointerToValues(label_t expectedSize = -1) const;
 
+  /*! \brief Return a pointer to the stored values, which are neither copied nor converted.
+     *
+     * TYPE has to match the data type and the values have to be contiguous, otherwise an exception
+     * is thrown, see isContiguous(). An EMPTY dataset returns nullptr. The pointer stays valid as
+     * long as this Dataset or one of its copies exists.
+     */
+  template <typename TYPE>
+  TYPE const* getRawData() const;
+
+  //! Tell if the values are held in an external buffer, see Dataset(TYPE const*, std::size_t, ...).
+  bool isExternal() const noexcept { return external_; }
+
+  /*! \brief Keep the results of type conversions for later calls.
+     *
+     * By default, every call of getValues or getPointerToValues with a type different from the
+     * data type converts all values again. With the cache enabled, the first conversion into a
+     * type is stored and getPointerToValues returns it for all later calls, getValues copies it.
+     * Copies of external values are cached as well.
+     *
+     * Datasets are immutable, so cached conversions never become outdated. Copies of the Dataset
+     * created after this call share the cache, it may be used from several threads concurrently.
+     * Selections of rows or columns start without cache.
+     * The cached vectors are included in getAllocatedSize().
+     */
+  void enableConversionCache();
+
+  //! Tell if conversions are cached, see enableConversionCache().
+  bool hasConversionCache() const noexcept { return bool(cache_); }
+
   //! \brief Return the use count of the underlying shared_ptr
   label_t getUseCount() const;
 
-  //! \brief Return the allocated size in bytes of the wrapped std::vector
+  /*! \brief Return the allocated size in bytes of the wrapped std::vector or the size of an external buffer.
+     *
+     * Selections report the size of the whole vector or buffer they keep alive. Cached conversions
+     * are included, see enableConversionCache().
+     */
   size_t getAllocatedSize() const;
 
   //! \brief Return the current size of the wrapped std::vector.
@@ -154,19 +291,62 @@ class Dataset
   Type t_;
   label_t cols_;
   label_t size_;
-  std::shared_ptr<void> values_;
-
-  std::shared_ptr<std::vector<int8_t>> getValuesINT8(label_t expectedSize) const;
-  std::shared_ptr<std::vector<uint8_t>> getValuesUINT8(label_t expectedSize) const;
-  std::shared_ptr<std::vector<int16_t>> getValuesINT16(label_t expectedSize) const;
-  std::shared_ptr<std::vector<uint16_t>> getValuesUINT16(label_t expectedSize) const;
-  std::shared_ptr<std::vector<int32_t>> getValuesINT32(label_t expectedSize) const;
-  std::shared_ptr<std::vector<uint32_t>> getValuesUINT32(label_t expectedSize) const;
-  std::shared_ptr<std::vector<int64_t>> getValuesINT64(label_t expectedSize) const;
-  std::shared_ptr<std::vector<uint64_t>> getValuesUINT64(label_t expectedSize) const;
-  std::shared_ptr<std::vector<long>> getValuesLONG(label_t expectedSize) const;
-  std::shared_ptr<std::vector<float>> getValuesFLOAT(label_t expectedSize) const;
-  std::shared_ptr<std::vector<double>> getValuesDOUBLE(label_t expectedSize) const;
+  //! Keeps the values alive: a std::vector of the data type or the owner of an external buffer.
+  std::shared_ptr<void const> values_;
+  //! Points to the first value, nullptr for EMPTY datasets.
+  void const* data_;
+  bool external_;
+  //! Size in bytes of the whole external buffer, selections of it keep the whole buffer alive.
+  std::size_t externalBytes_;
+  //! Set for selections of rows() and columns(), which use only a part of values_.
+  bool sliced_;
+  //! Distances between rows and between columns in elements.
+  std::ptrdiff_t rowStride_;
+  std::ptrdiff_t colStride_;
+
+  struct ConversionCache;
+  std::shared_ptr<ConversionCache> cache_;
+
+  std::shared_ptr<const std::vector<int8_t>> getValuesINT8(label_t expectedSize) const;
+  std::shared_ptr<const std::vector<uint8_t>> getValuesUINT8(label_t expectedSize) const;
+  std::shared_ptr<const std::vector<int16_t>> getValuesINT16(label_t expectedSize) const;
+  std::shared_ptr<const std::vector<uint16_t>> getValuesUINT16(label_t expectedSize) const;
+  std::shared_ptr<const std::vector<int32_t>> getValuesINT32(label_t expectedSize) const;
+  std::shared_ptr<const std::vector<uint32_t>> getValuesUINT32(label_t expectedSize) const;
+  std::shared_ptr<const std::vector<int64_t>> getValuesINT64(label_t expectedSize) const;
+  std::shared_ptr<const std::vector<uint64_t>> getValuesUINT64(label_t expectedSize) const;
+  std::shared_ptr<const std::vector<long>> getValuesLONG(label_t expectedSize) const;
+  std::shared_ptr<const std::vector<float>> getValuesFLOAT(label_t expectedSize) const;
+  std::shared_ptr<const std::vector<double>> getValuesDOUBLE(label_t expectedSize) const;
+
+  //! Return the values converted into TYPE, the stored vector itself if no conversion is needed.
+  template <typename TYPE>
+  std::shared_ptr<const std::vector<TYPE>> convertedValues(label_t expectedSize) const;
+
+  //! Store a vector of values, which is moved into a shared vector.
+  template <typename TYPE>
+  void setVector(std::vector<TYPE>&& values);
+
+  //! Return the allocated size of the values without cached conversions.
+  size_t getValuesSize() const;
+
+  //! Throw if the data type is not the requested one.
+  void checkType(Type requested) const;
+
+  //! Throw if the values are not contiguous.
+  void checkContiguous() const;
+
+  //! Return a selection of this Dataset with the given layout, see rows() and columns().
+  Dataset slice(std::ptrdiff_t offset, label_t rows, label_t cols, std::ptrdiff_t rowStride,
+                std::ptrdiff_t colStride) const;
+
+  //! Select columns by index, see columns().
+  Dataset selectColumns(label_t const* indices, std::size_t count) const;
+
+  //! Return item 'index' converted into TYPE.
+  template <typename TYPE>
+  TYPE convertedValue(label_t index) const;
+
   label_t translateIndex(label_t i, label_t j) const;
   void setCols(label_t cols);
 };
@@ -194,12 +374,23 @@ Dataset::Type Dataset::TypeMap<float>();
 template <>
 Dataset::Type Dataset::TypeMap<double>();
 
+template <typename TYPE>
+void Dataset::setVector(std::vector<TYPE>&& values)
+{
+  auto vector = std::make_shared<std::vector<TYPE> const>(std::move(values));
+  data_ = vector->empty() ? nullptr : vector->data();
+  values_ = std::move(vector);
+  external_ = false;
+  externalBytes_ = 0;
+  sliced_ = false;
+}
+
 template <typename TYPE>
 Dataset::Dataset(std::vector<TYPE> values, label_t nCols) :
     t_(values.size() ? Dataset::TypeMap<TYPE>() : Type::EMPTY),
-    size_(d_size(values)),
-    values_(std::make_shared<std::vector<TYPE>>(values))
+    size_(d_size(values))
 {
+  setVector(std::move(values));
   setCols(nCols);
 }
 
@@ -208,8 +399,24 @@ Dataset::Dataset(TYPE value) :
     t_(Dataset::TypeMap<TYPE>()),
     cols_(1),
     size_(1),
-    values_(std::make_shared<std::vector<TYPE>>(1, value))
-{}
+    rowStride_(1),
+    colStride_(1)
+{
+  setVector(std::vector<TYPE>(1, value));
+}
+
+template <typename TYPE>
+Dataset::Dataset(TYPE const* data, std::size_t size, std::shared_ptr<void const> owner, label_t nCols) :
+    t_(size ? Dataset::TypeMap<TYPE>() : Type::EMPTY),
+    size_((d_check_size(size), label_t(size))),
+    values_(size ? std::move(owner) : nullptr),
+    data_(size ? data : nullptr),
+    external_(size != 0),
+    externalBytes_(sizeof(TYPE) * size),
+    sliced_(false)
+{
+  setCols(nCols);
+}
 
 template <typename TYPE>
 Dataset::Dataset(std::vector<std::complex<TYPE>> values) :
@@ -222,7 +429,7 @@ Dataset::Dataset(std::vector<std::complex<TYPE>> values) :
     newValues.push_back(v.real());
     newValues.push_back(v.imag());
   }
-  values_ = std::make_shared<std::vector<TYPE>>(std::move(newValues));
+  setVector(std::move(newValues));
   setCols(2);
 }
 
@@ -260,6 +467,16 @@ template <>
 std::shared_ptr<const std::vector<double>> Dataset::getPointerToValues<double>(
     label_t expectedSize) const;
 
+template <typename TYPE>
+TYPE const* Dataset::getRawData() const
+{
+  if (t_ == Type::EMPTY)
+    return nullptr;
+  checkType(TypeMap<TYPE>());
+  checkContiguous();
+  return static_cast<TYPE const*>(data_);
+}
+
 template <typename TYPE>
 std::vector<TYPE> Dataset::getValues(label_t expectedSize) const
 {
@@ -267,11 +484,65 @@ std::vector<TYPE> Dataset::getValues(label_t expectedSize) const
   return *ptr;
 }
 
+template <typename TYPE>
+DatasetView<TYPE> Dataset::view() const
+{
+  if (t_ == Type::EMPTY)
+    return DatasetView<TYPE>();
+  checkType(TypeMap<TYPE>());
+  return DatasetView<TYPE>(static_cast<TYPE const*>(data_), size_ / cols_, cols_, rowStride_, colStride_);
+}
+
+template <typename F>
+decltype(auto) Dataset::dispatch(Type t, F&& f)
+{
+  switch (t) {
+    case Type::INT8:
+      return f(TypeTag<int8_t>());
+    case Type::UINT8:
+      return f(TypeTag<uint8_t>());
+    case Type::INT16:
+      return f(TypeTag<int16_t>());
+    case Type::UINT16:
+      return f(TypeTag<uint16_t>());
+    case Type::INT32:
+      return f(TypeTag<int32_t>());
+    case Type::UINT32:
+      return f(TypeTag<uint32_t>());
+    case Type::INT64:
+      return f(TypeTag<int64_t>());
+    case Type::UINT64:
+      return f(TypeTag<uint64_t>());
+    case Type::FLOAT32:
+      return f(TypeTag<float>());
+    case Type::FLOAT64:
+      return f(TypeTag<double>());
+    case Type::EMPTY:
+      break;
+  }
+  D_THROW("Dataset type " + t.toString() + " has no value type.");
+}
+
+template <typename F>
+decltype(auto) Dataset::visit(F&& f) const
+{
+  return dispatch(t_, [&](auto tag) -> decltype(auto) { return f(view<typename decltype(tag)::type>()); });
+}
+
+template <typename TYPE>
+TYPE Dataset::convertedValue(label_t index) const
+{
+  if (t_ == Type::EMPTY)
+    return TYPE();
+  return dispatch(t_, [this, index](auto tag) {
+    return static_cast<TYPE>(static_cast<typename decltype(tag)::type const*>(data_)[index]);
+  });
+}
+
 template <typename TYPE>
 TYPE Dataset::getValue(label_t i, label_t j) const
 {
-  auto ptr = getPointerToValues<TYPE>(-1);
-  return ptr->operator[](translateIndex(i, j));
+  return convertedValue<TYPE>(translateIndex(i, j));
 }
 
 }  // namespace DUTIL
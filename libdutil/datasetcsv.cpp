@@ -0,0 +1,343 @@
+#include "datasetcsv.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "exception.h"
+#include "mappedfile.h"
+#include "parallel.h"
+#include "simd.h"
+#include "utility.h"
+
+namespace DUTIL {
+
+namespace {
+//! Result of parsing one piece of the text, which starts and ends at line boundaries.
+struct Chunk
+{
+  std::string_view text;
+  //! Number of lines, the first line of the next chunk follows.
+  std::size_t lines = 0;
+  //! Values per row, 0 if the chunk holds no rows.
+  label_t cols = 0;
+  //! Line of the first row, counted from the start of the chunk.
+  std::size_t firstRowLine = 0;
+  //! Line and message of the first error, the chunk is not parsed any further.
+  std::size_t errorLine = 0;
+  std::string error;
+};
+
+template <typename TYPE>
+struct TypedChunk : Chunk
+{
+  std::vector<TYPE> values;
+};
+
+//! Chunk without given type, integers are kept until the first value that is no integer.
+struct InferredChunk : Chunk
+{
+  std::vector<int64_t> integers;
+  std::vector<double> reals;
+  bool real = false;
+};
+
+template <typename TYPE>
+bool parseValue(char const* first, char const* last, TYPE& value)
+{
+  // std::from_chars does not accept a leading plus sign
+  if (last - first > 1 && *first == '+' && first[1] != '-')
+    ++first;
+  auto const [ptr, error] = std::from_chars(first, last, value);
+  return error == std::errc() && ptr == last && first != last;
+}
+
+template <typename TYPE>
+bool storeValue(TypedChunk<TYPE>& chunk, char const* first, char const* last)
+{
+  TYPE value;
+  if (!parseValue(first, last, value))
+    return false;
+  chunk.values.push_back(value);
+  return true;
+}
+
+bool storeValue(InferredChunk& chunk, char const* first, char const* last)
+{
+  if (!chunk.real) {
+    int64_t integer;
+    if (parseValue(first, last, integer)) {
+      chunk.integers.push_back(integer);
+      return true;
+    }
+    chunk.reals.resize(chunk.integers.size());
+    SIMD::convert(chunk.integers.data(), chunk.reals.data(), chunk.integers.size());
+    chunk.integers = std::vector<int64_t>();
+    chunk.real = true;
+  }
+  double real;
+  if (!parseValue(first, last, real))
+    return false;
+  chunk.reals.push_back(real);
+  return true;
+}
+
+template <typename CHUNK>
+void parseChunk(CHUNK& chunk, char delimiter)
+{
+  auto const isBlank = [delimiter](char c) { return (c == ' ' || c == '\t') && c != delimiter; };
+  char const* p = chunk.text.data();
+  char const* const end = p + chunk.text.size();
+  std::size_t line = 0;
+  for (; p < end; ++line) {
+    auto const* eol = static_cast<char const*>(std::memchr(p, '\n', std::size_t(end - p)));
+    if (!eol)
+      eol = end;
+    char const* last = eol;
+    if (last > p && last[-1] == '\r')
+      --last;
+    while (p < last && isBlank(*p))
+      ++p;
+
+    if (p < last && *p != '#') {
+      label_t count = 0;
+      while (true) {
+        auto const* separator = static_cast<char const*>(std::memchr(p, delimiter, std::size_t(last - p)));
+        if (!separator)
+          separator = last;
+        char const* fieldEnd = separator;
+        while (fieldEnd > p && isBlank(fieldEnd[-1]))
+          --fieldEnd;
+        if (!storeValue(chunk, p, fieldEnd)) {
+          chunk.errorLine = line;
+          chunk.error = "Invalid value '" + std::string(p, fieldEnd) + "'.";
+          return;
+        }
+        ++count;
+        if (separator == last)
+          break;
+        p = separator + 1;
+        while (p < last && isBlank(*p))
+          ++p;
+      }
+      if (chunk.cols == 0) {
+        chunk.cols = count;
+        chunk.firstRowLine = line;
+      } else if (count != chunk.cols) {
+        chunk.errorLine = line;
+        chunk.error = "Expected " + Utility::toString(chunk.cols) + " values, found " + Utility::toString(count) + ".";
+        return;
+      }
+    }
+    p = eol < end ? eol + 1 : end;
+  }
+  chunk.lines = line;
+}
+
+//! Split the text into chunks of about chunkSize bytes that end after a line break.
+template <typename CHUNK>
+std::vector<CHUNK> splitText(std::string_view text, std::size_t chunkSize)
+{
+  std::vector<CHUNK> chunks;
+  std::size_t start = 0;
+  while (start < text.size()) {
+    std::size_t stop = std::min(text.size(), start + std::max<std::size_t>(chunkSize, 1));
+    if (stop < text.size()) {
+      std::size_t const lineBreak = text.find('\n', stop - 1);
+      stop = lineBreak == std::string_view::npos ? text.size() : lineBreak + 1;
+    }
+    chunks.emplace_back();
+    chunks.back().text = text.substr(start, stop - start);
+    start = stop;
+  }
+  return chunks;
+}
+
+//! Parse all chunks, each thread takes the next unparsed chunk until none is left.
+template <typename CHUNK>
+void parseChunks(std::vector<CHUNK>& chunks, DatasetCSV::Options const& options)
+{
+  parallelRanges(chunks.size(), options.threads,
+                 [&chunks, &options](std::size_t i) { parseChunk(chunks[i], options.delimiter); });
+}
+
+//! Throw the first error of the chunks in text order and return the number of values per row.
+template <typename CHUNK>
+label_t checkChunks(std::vector<CHUNK> const& chunks, std::size_t firstLine, std::string const& sourceName)
+{
+  label_t cols = 0;
+  std::size_t line = firstLine;
+  for (auto const& chunk : chunks) {
+    if (!chunk.error.empty())
+      D_THROW(sourceName + ":" + Utility::toString(line + chunk.errorLine) + ": " + chunk.error);
+    if (chunk.cols && cols && chunk.cols != cols)
+      D_THROW(sourceName + ":" + Utility::toString(line + chunk.firstRowLine) + ": Expected " + Utility::toString(cols)
+              + " values, found " + Utility::toString(chunk.cols) + ".");
+    if (chunk.cols)
+      cols = chunk.cols;
+    line += chunk.lines;
+  }
+  return cols;
+}
+
+template <typename TYPE>
+std::vector<TYPE> stitch(std::vector<std::vector<TYPE>*> const& pieces)
+{
+  if (pieces.size() == 1)
+    return std::move(*pieces.front());
+  std::size_t total = 0;
+  for (auto const* piece : pieces) {
+    total += piece->size();
+  }
+  std::vector<TYPE> values;
+  values.reserve(total);
+  for (auto* piece : pieces) {
+    values.insert(values.end(), piece->begin(), piece->end());
+    *piece = std::vector<TYPE>();
+  }
+  return values;
+}
+
+template <typename TYPE>
+Dataset parseTyped(std::string_view text, DatasetCSV::Options const& options, std::size_t firstLine,
+                   std::string const& sourceName)
+{
+  auto chunks = splitText<TypedChunk<TYPE>>(text, options.chunkSize);
+  parseChunks(chunks, options);
+  label_t const cols = checkChunks(chunks, firstLine, sourceName);
+
+  std::vector<std::vector<TYPE>*> pieces;
+  for (auto& chunk : chunks) {
+    pieces.push_back(&chunk.values);
+  }
+  std::vector<TYPE> values = stitch(pieces);
+  d_check_size(values.size());
+  return values.empty() ? Dataset() : Dataset(std::move(values), cols);
+}
+
+Dataset parseInferred(std::string_view text, DatasetCSV::Options const& options, std::size_t firstLine,
+                      std::string const& sourceName)
+{
+  auto chunks = splitText<InferredChunk>(text, options.chunkSize);
+  parseChunks(chunks, options);
+  label_t const cols = checkChunks(chunks, firstLine, sourceName);
+
+  bool const real = std::any_of(chunks.begin(), chunks.end(), [](auto const& chunk) { return chunk.real; });
+  if (!real) {
+    std::vector<std::vector<int64_t>*> pieces;
+    for (auto& chunk : chunks) {
+      pieces.push_back(&chunk.integers);
+    }
+    std::vector<int64_t> values = stitch(pieces);
+    d_check_size(values.size());
+    return values.empty() ? Dataset() : Dataset(std::move(values), cols);
+  }
+
+  for (auto& chunk : chunks) {
+    if (!chunk.real) {
+      chunk.reals.resize(chunk.integers.size());
+      SIMD::convert(chunk.integers.data(), chunk.reals.data(), chunk.integers.size());
+    }
+  }
+  std::vector<std::vector<double>*> pieces;
+  for (auto& chunk : chunks) {
+    pieces.push_back(&chunk.reals);
+  }
+  std::vector<double> values = stitch(pieces);
+  d_check_size(values.size());
+  return Dataset(std::move(values), cols);
+}
+
+//! Size of the text buffer passed to the stream at once.
+constexpr std::size_t writeBufferSize = std::size_t(1) << 20;
+
+template <typename TYPE>
+void writeValues(DatasetView<TYPE> const& values, std::ostream& stream, char delimiter)
+{
+  std::string buffer;
+  buffer.reserve(writeBufferSize + 64);
+  char number[64];
+  for (label_t i = 0; i < values.rows(); ++i) {
+    for (label_t j = 0; j < values.cols(); ++j) {
+      if (j)
+        buffer.push_back(delimiter);
+      auto const result = std::to_chars(number, number + sizeof(number), values(i, j));
+      buffer.append(number, result.ptr);
+    }
+    buffer.push_back('\n');
+    if (buffer.size() >= writeBufferSize) {
+      stream.write(buffer.data(), std::streamsize(buffer.size()));
+      buffer.clear();
+    }
+  }
+  stream.write(buffer.data(), std::streamsize(buffer.size()));
+}
+}  // namespace
+
+Dataset DatasetCSV::parse(std::string_view text)
+{
+  return parse(text, Options());
+}
+
+Dataset DatasetCSV::parse(std::string_view text, Options const& options, std::string const& sourceName)
+{
+  std::size_t firstLine = 1;
+  if (options.skipHeader) {
+    std::size_t const lineBreak = text.find('\n');
+    text.remove_prefix(lineBreak == std::string_view::npos ? text.size() : lineBreak + 1);
+    ++firstLine;
+  }
+
+  if (options.type == Dataset::Type::EMPTY)
+    return parseInferred(text, options, firstLine, sourceName);
+  return Dataset::dispatch(options.type, [&](auto tag) {
+    return parseTyped<typename decltype(tag)::type>(text, options, firstLine, sourceName);
+  });
+}
+
+Dataset DatasetCSV::read(std::string const& path)
+{
+  return read(path, Options());
+}
+
+Dataset DatasetCSV::read(std::string const& path, Options const& options)
+{
+  MappedFile const file(path);
+  return parse(file.text(), options, path);
+}
+
+void DatasetCSV::write(Dataset const& ds, std::ostream& stream)
+{
+  write(ds, stream, Options());
+}
+
+void DatasetCSV::write(Dataset const& ds, std::ostream& stream, Options const& options)
+{
+  for (std::size_t i = 0; i < options.header.size(); ++i) {
+    if (i)
+      stream.put(options.delimiter);
+    stream << options.header[i];
+  }
+  if (!options.header.empty())
+    stream.put('\n');
+
+  if (ds.getType() != Dataset::Type::EMPTY)
+    ds.visit([&](auto const& values) { writeValues(values, stream, options.delimiter); });
+}
+
+void DatasetCSV::write(Dataset const& ds, std::string const& path)
+{
+  write(ds, path, Options());
+}
+
+void DatasetCSV::write(Dataset const& ds, std::string const& path, Options const& options)
+{
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (file)
+    write(ds, file, options);
+  file.close();
+  if (!file)
+    D_THROW("Cannot write CSV file '" + path + "'.");
+}
+
+}  // namespace DUTIL
@@ -0,0 +1,73 @@
+#ifndef DUTIL_DATASETCSV_H
+#define DUTIL_DATASETCSV_H
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "dataset.h"
+
+namespace DUTIL {
+
+/*! \brief Read and write Datasets as CSV text.
+ *
+ * Every non-empty line holds one row, values are separated by the delimiter and may be surrounded
+ * by blanks. All rows must have the same number of values. Lines starting with '#' are comments,
+ * Windows line endings are accepted. Quoted fields are not supported, all fields are numbers.
+ *
+ * Reading splits the text into chunks at line boundaries and parses the chunks on several threads
+ * with std::from_chars, each into a buffer of its own. The buffers are stitched into a single
+ * Dataset afterwards. Files are mapped into memory, see MappedFile.
+ *
+ * The data type is either given in the options or inferred: INT64 if all values are integers
+ * within the range of int64_t, FLOAT64 otherwise. Values outside the range of a given type throw.
+ *
+ * Errors name the source and the line, like ConfigParser: "prices.csv:12: Expected 4 values".
+ */
+class DatasetCSV
+{
+  public:
+  struct Options
+  {
+    //! Separator between the values of a row.
+    char delimiter = ',';
+
+    //! Data type of the values, EMPTY to infer it from the text.
+    Dataset::Type type = Dataset::Type::EMPTY;
+
+    //! Reading: skip the first line, e.g. column names.
+    bool skipHeader = false;
+
+    //! Writing: column names written as first line, nothing if empty.
+    StringList header;
+
+    //! Number of threads used for reading, 0 for one per processor.
+    unsigned threads = 0;
+
+    //! Approximate number of bytes parsed by a thread in one piece.
+    std::size_t chunkSize = std::size_t(1) << 20;
+  };
+
+  //! Parse CSV text. sourceName is used in error messages.
+  static Dataset parse(std::string_view text);
+  static Dataset parse(std::string_view text, Options const& options, std::string const& sourceName = "<text>");
+
+  //! Map a CSV file and parse it.
+  static Dataset read(std::string const& path);
+  static Dataset read(std::string const& path, Options const& options);
+
+  /*! \brief Write the Dataset as CSV to a stream.
+     *
+     * Numbers are formatted with std::to_chars in their shortest form that reads back to the same
+     * value, the text is collected in a buffer and passed to the stream in large pieces. The type
+     * and threads options are not used.
+     */
+  static void write(Dataset const& ds, std::ostream& stream);
+  static void write(Dataset const& ds, std::ostream& stream, Options const& options);
+
+  //! Write the Dataset as CSV file, throw if the file cannot be written.
+  static void write(Dataset const& ds, std::string const& path);
+  static void write(Dataset const& ds, std::string const& path, Options const& options);
+};
+
+}  // namespace DUTIL
+#endif  // DUTIL_DATASETCSV_H
@@ -0,0 +1,285 @@
+#include "datasetfile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <fcntl.h>
+#if defined(D_MINGW_MXE) || defined(D_MINGW_NATIVE) || defined(D_MSVC)
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
+#include "exception.h"
+#include "hash.h"
+#include "mappedfile.h"
+#include "utility.h"
+
+namespace DUTIL {
+
+namespace {
+constexpr char magic[8] = {'L', 'I', 'B', 'D', 'D', 'S', 'E', 'T'};
+constexpr std::uint32_t byteOrderMark = 0x01020304;
+
+template <typename T>
+void putField(char* header, std::size_t offset, T value)
+{
+  std::memcpy(header + offset, &value, sizeof(T));
+}
+
+template <typename T>
+T getField(char const* header, std::size_t offset)
+{
+  T value;
+  std::memcpy(&value, header + offset, sizeof(T));
+  return value;
+}
+
+//! Check the header bytes of a file of the given size and return its fields.
+DatasetFile::Header parseHeader(char const* bytes, std::uint64_t fileSize, std::string const& path)
+{
+  std::string const where = "Dataset file '" + path + "'";
+  if (fileSize < DatasetFile::headerSize || std::memcmp(bytes, magic, sizeof(magic)) != 0)
+    D_THROW(where + " is not a Dataset file.");
+  if (getField<std::uint32_t>(bytes, 12) != byteOrderMark)
+    D_THROW(where + " was written on a machine with a different byte order.");
+  auto const fileVersion = getField<std::uint32_t>(bytes, 8);
+  if (fileVersion != DatasetFile::version)
+    D_THROW(where + " has version " + Utility::toString(fileVersion) + ", supported is version "
+            + Utility::toString(DatasetFile::version) + ".");
+
+  auto const type = getField<std::uint32_t>(bytes, 16);
+  if (type > std::uint32_t(Dataset::Type::FLOAT64))
+    D_THROW(where + " has the unknown data type " + Utility::toString(type) + ".");
+
+  DatasetFile::Header header;
+  header.type = Dataset::Type(label_t(type));
+  header.alignment = getField<std::uint32_t>(bytes, 20);
+  header.rows = getField<std::uint64_t>(bytes, 24);
+  header.cols = getField<std::uint64_t>(bytes, 32);
+  header.dataOffset = getField<std::uint64_t>(bytes, 40);
+  header.dataSize = getField<std::uint64_t>(bytes, 48);
+  header.checksum = getField<std::uint64_t>(bytes, 56);
+
+  if (header.alignment == 0 || (header.alignment & (header.alignment - 1)) != 0
+      || header.dataOffset % header.alignment != 0 || header.dataOffset < DatasetFile::headerSize)
+    D_THROW(where + " has an invalid data offset or alignment.");
+  if (header.cols == 0 || header.rows > std::uint64_t(std::numeric_limits<label_t>::max()) / header.cols)
+    D_THROW(where + " has an invalid number of rows or columns.");
+  if (header.rows * header.cols * Dataset::getElementSize(header.type) != header.dataSize)
+    D_THROW(where + " has a data size that does not match its rows, columns and type.");
+  if (header.dataOffset > fileSize || header.dataSize > fileSize - header.dataOffset)
+    D_THROW(where + " is truncated.");
+  return header;
+}
+
+//! Return the values of a Dataset as bytes.
+char const* rawBytes(Dataset const& ds)
+{
+  if (ds.getType() == Dataset::Type::EMPTY)
+    return nullptr;
+  return Dataset::dispatch(ds.getType(), [&ds](auto tag) {
+    return reinterpret_cast<char const*>(ds.getRawData<typename decltype(tag)::type>());
+  });
+}
+
+/*! \brief Create a new file next to 'path' with a unique name, return its descriptor.
+ *
+ * Like mkstemp, but the file gets the usual permissions of new files instead of 0600.
+ */
+int createTemporaryFile(std::string const& path, std::string& temporaryPath)
+{
+  std::random_device random;
+  for (int attempt = 0; attempt < 100; ++attempt) {
+    char suffix[24];
+    std::snprintf(suffix, sizeof(suffix), ".%08x%08x.tmp", random(), random());
+    temporaryPath = path + suffix;
+#if defined(D_MINGW_MXE) || defined(D_MINGW_NATIVE) || defined(D_MSVC)
+    int const fd = ::_open(temporaryPath.c_str(), _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY,
+                           _S_IREAD | _S_IWRITE);
+#else
+    int const fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+#endif
+    if (fd >= 0)
+      return fd;
+    if (errno != EEXIST)
+      D_THROW("Cannot write Dataset file '" + path + "': " + std::strerror(errno) + ".");
+  }
+  D_THROW("Cannot write Dataset file '" + path + "': no unique temporary file name found.");
+}
+
+//! Write all bytes, return 0 or the errno of the failure.
+int writeAll(int fd, char const* data, std::size_t size)
+{
+  while (size) {
+#if defined(D_MINGW_MXE) || defined(D_MINGW_NATIVE) || defined(D_MSVC)
+    // _write takes an unsigned int count
+    int const n = ::_write(fd, data, static_cast<unsigned>(std::min<std::size_t>(size, 1u << 30)));
+#else
+    ssize_t const n = ::write(fd, data, size);
+#endif
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return n < 0 ? errno : EIO;
+    data += n;
+    size -= std::size_t(n);
+  }
+  return 0;
+}
+
+//! Flush the file to disk and close it, return 0 or the errno of the first failure.
+int syncAndClose(int fd)
+{
+#if defined(D_MINGW_MXE) || defined(D_MINGW_NATIVE) || defined(D_MSVC)
+  int error = ::_commit(fd) != 0 ? errno : 0;
+  if (::_close(fd) != 0 && !error)
+    error = errno;
+#else
+  int error = ::fsync(fd) != 0 ? errno : 0;
+  if (::close(fd) != 0 && !error)
+    error = errno;
+#endif
+  return error;
+}
+
+//! Flush the directory holding 'path' to disk, which makes a rename into it durable.
+int syncDirectory(std::string const& path)
+{
+#if defined(D_MINGW_MXE) || defined(D_MINGW_NATIVE) || defined(D_MSVC)
+  // the C runtime cannot open directories, the rename is left to the file system's journal
+  (void)path;
+  return 0;
+#else
+  auto directory = std::filesystem::path(path).parent_path();
+  if (directory.empty())
+    directory = ".";
+  int const fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0)
+    return errno;
+  int error = ::fsync(fd) != 0 ? errno : 0;
+  ::close(fd);
+  // some file systems cannot sync directories, there is nothing more to do for them
+  return error == EINVAL ? 0 : error;
+#endif
+}
+
+//! Wrap the values of a mapped file, which is kept alive by the Dataset.
+template <typename TYPE>
+Dataset wrapValues(std::shared_ptr<MappedFile const> const& file, DatasetFile::Header const& header)
+{
+  auto const* values = reinterpret_cast<TYPE const*>(file->data() + header.dataOffset);
+  return Dataset(values, std::size_t(header.rows * header.cols), file, label_t(header.cols));
+}
+}  // namespace
+
+void DatasetFile::write(Dataset const& selection, std::string const& path)
+{
+  Dataset const ds = selection.contiguous();
+  constexpr std::uint64_t dataOffset = (headerSize + dataAlignment - 1) / dataAlignment * dataAlignment;
+  std::uint64_t const dataSize = ds.getNumberOfCurrentlyStoredData();
+  char const* data = rawBytes(ds);
+
+  char header[dataOffset] = {};
+  std::memcpy(header, magic, sizeof(magic));
+  putField(header, 8, version);
+  putField(header, 12, byteOrderMark);
+  putField(header, 16, std::uint32_t(label_t(ds.getType())));
+  putField(header, 20, dataAlignment);
+  putField(header, 24, std::uint64_t(ds.getRows()));
+  putField(header, 32, std::uint64_t(ds.getCols()));
+  putField(header, 40, dataOffset);
+  putField(header, 48, dataSize);
+  putField(header, 56, checksum(data, dataSize));
+
+  // a unique temporary file keeps the replacement atomic for concurrent writers of the same path
+  // and after interrupted runs, which may leave their temporary file behind
+  std::string temporaryPath;
+  int const fd = createTemporaryFile(path, temporaryPath);
+  int writeError = writeAll(fd, header, dataOffset);
+  if (!writeError)
+    writeError = writeAll(fd, data, dataSize);
+  // the content has to be on disk before the rename, a crash must not leave a truncated file under 'path'
+  int const syncError = syncAndClose(fd);
+  if (!writeError)
+    writeError = syncError;
+  if (writeError) {
+    std::remove(temporaryPath.c_str());
+    D_THROW("Cannot write Dataset file '" + path + "': " + std::strerror(writeError) + ".");
+  }
+  std::error_code error;
+  std::filesystem::rename(temporaryPath, path, error);
+  if (error) {
+    std::remove(temporaryPath.c_str());
+    D_THROW("Cannot write Dataset file '" + path + "': " + error.message() + ".");
+  }
+  if (int const syncError = syncDirectory(path))
+    D_THROW("Cannot write Dataset file '" + path + "': " + std::strerror(syncError) + ".");
+}
+
+Dataset DatasetFile::load(std::string const& path, bool verifyChecksum)
+{
+  auto file = std::make_shared<MappedFile const>(path, MappedFile::Access::NORMAL);
+  Header const header = parseHeader(file->data(), file->size(), path);
+  if (verifyChecksum && checksum(file->data() + header.dataOffset, header.dataSize) != header.checksum)
+    D_THROW("Dataset file '" + path + "' is corrupted, the checksum does not match.");
+
+  if (header.type == Dataset::Type::EMPTY)
+    return Dataset();
+  return Dataset::dispatch(header.type,
+                           [&](auto tag) { return wrapValues<typename decltype(tag)::type>(file, header); });
+}
+
+DatasetFile::Header DatasetFile::readHeader(std::string const& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+    D_THROW("Cannot open file '" + path + "'.");
+  char bytes[headerSize] = {};
+  file.read(bytes, std::streamsize(headerSize));
+  std::error_code error;
+  auto const fileSize = std::filesystem::file_size(path, error);
+  return parseHeader(bytes, error ? 0 : fileSize, path);
+}
+
+bool DatasetFile::verify(std::string const& path)
+{
+  MappedFile const file(path);
+  Header const header = parseHeader(file.data(), file.size(), path);
+  return checksum(file.data() + header.dataOffset, header.dataSize) == header.checksum;
+}
+
+std::uint64_t DatasetFile::checksum(void const* data, std::size_t size) noexcept
+{
+  // Four independent lanes over 8 byte words keep several multiplications in flight, which makes
+  // the checksum fast enough to verify files at memory bandwidth. The words are read with memcpy
+  // since the range need not be aligned.
+  constexpr std::uint64_t prime1 = 0x9e3779b185ebca87ull;
+  constexpr std::uint64_t prime2 = 0xc2b2ae3d27d4eb4full;
+  auto const* bytes = static_cast<char const*>(data);
+  std::uint64_t lanes[4] = {prime1, prime2, ~prime1, ~prime2};
+  std::size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    for (std::size_t lane = 0; lane < 4; ++lane) {
+      std::uint64_t word;
+      std::memcpy(&word, bytes + i + 8 * lane, sizeof(word));
+      std::uint64_t const value = lanes[lane] + word * prime2;
+      lanes[lane] = ((value << 31) | (value >> 33)) * prime1;
+    }
+  }
+  std::uint64_t hash = Hash::mix(size);
+  for (std::uint64_t lane : lanes) {
+    hash = Hash::combine(hash, lane);
+  }
+  for (; i < size; ++i) {
+    hash = Hash::combine(hash, static_cast<std::uint8_t>(bytes[i]));
+  }
+  return hash;
+}
+
+}  // namespace DUTIL
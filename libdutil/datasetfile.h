@@ -0,0 +1,85 @@
+#ifndef DUTIL_DATASETFILE_H
+#define DUTIL_DATASETFILE_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "dataset.h"
+
+namespace DUTIL {
+
+/*! \brief Binary file format for a single Dataset, loaded by mapping the file into memory.
+ *
+ * A file starts with a header of 64 bytes, followed by padding up to the data offset and the raw
+ * values row by row. Header fields and values are stored in the byte order of the writing
+ * machine, readers with a different byte order reject the file:
+ *
+ * offset  size  field
+ *      0     8  magic "LIBDDSET"
+ *      8     4  format version, currently 1
+ *     12     4  byte order mark 0x01020304, written in the byte order of the values
+ *     16     4  data type, the value of Dataset::Type
+ *     20     4  alignment of the data offset in bytes, a power of two
+ *     24     8  number of rows
+ *     32     8  number of columns
+ *     40     8  data offset in bytes from the start of the file
+ *     48     8  data size in bytes
+ *     56     8  checksum of the data, see checksum()
+ *
+ * load() maps the file and wraps the mapping as external Dataset without copying the values.
+ * Pages are read by the operating system when the values are accessed first, so opening even
+ * very large files only reads the header. The mapping is released with the last copy of the
+ * Dataset. The file must not be changed while it is mapped.
+ */
+class DatasetFile
+{
+  public:
+  //! Size of the header in bytes.
+  static constexpr std::size_t headerSize = 64;
+
+  //! Alignment of the data offset used by write(), a cache line.
+  static constexpr std::uint32_t dataAlignment = 64;
+
+  //! Current format version.
+  static constexpr std::uint32_t version = 1;
+
+  //! Header fields of a file.
+  struct Header
+  {
+    Dataset::Type type = Dataset::Type::EMPTY;
+    std::uint32_t alignment = dataAlignment;
+    std::uint64_t rows = 0;
+    std::uint64_t cols = 1;
+    std::uint64_t dataOffset = 0;
+    std::uint64_t dataSize = 0;
+    std::uint64_t checksum = 0;
+  };
+
+  /*! \brief Write the Dataset to a file.
+     *
+     * The file is written under a unique temporary name in the same directory first and renamed
+     * when complete, so readers never see partially written files, even with several writers of
+     * the same path. The file and its directory are flushed to disk around the rename, so a crash
+     * leaves either the old or the complete new file under 'path'. Throws if the file cannot be written.
+     */
+  static void write(Dataset const& ds, std::string const& path);
+
+  /*! \brief Map a file written by write() and return its values as Dataset.
+     *
+     * Only the header is checked by default. With verifyChecksum set, all values are read once to
+     * compare the checksum, which defeats lazy loading. Throws if the file cannot be read or is not
+     * a valid Dataset file.
+     */
+  static Dataset load(std::string const& path, bool verifyChecksum = false);
+
+  //! Read and check the header of a file without mapping the values.
+  static Header readHeader(std::string const& path);
+
+  //! Return true if the checksum of the values matches the header.
+  static bool verify(std::string const& path);
+
+  //! Checksum of a byte range as stored in the header.
+  static std::uint64_t checksum(void const* data, std::size_t size) noexcept;
+};
+
+}  // namespace DUTIL
+#endif  // DUTIL_DATASETFILE_H
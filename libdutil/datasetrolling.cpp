@@ -0,0 +1,394 @@
+#include "datasetrolling.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include "exception.h"
+#include "parallel.h"
+#include "utility.h"
+
+namespace DUTIL {
+
+namespace {
+//! Values a group of columns must hold before it is worth a thread of its own.
+constexpr std::size_t valuesPerThread = std::size_t(1) << 16;
+
+//! Columns are given to threads in groups that fill a cache line of the result.
+constexpr std::size_t columnGroup = 8;
+
+constexpr double notANumber = std::numeric_limits<double>::quiet_NaN();
+
+void checkWindow(label_t window, char const* name)
+{
+  if (window < 1)
+    D_THROW(std::string(name) + " must be positive, got " + Utility::toString(window) + ".");
+}
+
+//! Add x to a sum with Neumaier's compensation, which also covers |x| > |sum|.
+inline void addCompensated(double& sum, double& compensation, double x)
+{
+  double const t = sum + x;
+  if (std::abs(sum) >= std::abs(x))
+    compensation += (sum - t) + x;
+  else
+    compensation += (x - t) + sum;
+  sum = t;
+}
+
+/*! \brief Kernels process the rows of a group of columns one after the other.
+ *
+ * step() gets the values of row i, the values of row i - lag() if it exists and nullptr otherwise,
+ * and writes the results of row i.
+ */
+class Mean
+{
+  public:
+  Mean(label_t window, std::size_t cols) :
+      window_(window),
+      sum_(cols, 0.0),
+      compensation_(cols, 0.0),
+      notANumbers_(cols, 0),
+      positiveInfinities_(cols, 0),
+      negativeInfinities_(cols, 0)
+  {}
+
+  label_t lag() const { return window_; }
+
+  void step(label_t i, double const* x, double const* leaving, double* y)
+  {
+    bool const complete = i + 1 >= window_;
+    for (std::size_t j = 0; j < sum_.size(); ++j) {
+      add(j, x[j], 1);
+      if (leaving)
+        add(j, leaving[j], -1);
+      if (!complete || notANumbers_[j] || (positiveInfinities_[j] && negativeInfinities_[j]))
+        y[j] = notANumber;
+      else if (positiveInfinities_[j])
+        y[j] = std::numeric_limits<double>::infinity();
+      else if (negativeInfinities_[j])
+        y[j] = -std::numeric_limits<double>::infinity();
+      else
+        y[j] = (sum_[j] + compensation_[j]) / double(window_);
+    }
+  }
+
+  private:
+  //! Add (sign 1) or remove (sign -1) a value; non-finite values are counted instead of summed.
+  void add(std::size_t j, double x, int sign)
+  {
+    if (std::isnan(x))
+      notANumbers_[j] += sign;
+    else if (std::isinf(x))
+      (x > 0 ? positiveInfinities_[j] : negativeInfinities_[j]) += sign;
+    else
+      addCompensated(sum_[j], compensation_[j], sign * x);
+  }
+
+  label_t window_;
+  std::vector<double> sum_;
+  std::vector<double> compensation_;
+  //! Non-finite values in the window, they decide the mean while they are in the window.
+  std::vector<label_t> notANumbers_;
+  std::vector<label_t> positiveInfinities_;
+  std::vector<label_t> negativeInfinities_;
+};
+
+/*! \brief Rolling variance with Welford's updates.
+ *
+ * Rounding errors of the updates add up over long series, so mean and squared deviations are
+ * recomputed from the values of the window once every window rows, which keeps the cost constant
+ * per row. While a NaN or infinite value is in the window the result is NaN and the updates stop;
+ * once the last of them has left, the state is recomputed from the window.
+ */
+class StandardDeviation
+{
+  public:
+  StandardDeviation(label_t window, label_t rows, std::size_t cols) :
+      window_(window),
+      capacity_(std::size_t(std::min(window, rows))),
+      mean_(cols, 0.0),
+      m2_(cols, 0.0),
+      nonFinite_(cols, 0),
+      history_(capacity_ * cols)
+  {}
+
+  label_t lag() const { return window_; }
+
+  void step(label_t i, double const* x, double const* leaving, double* y)
+  {
+    bool const complete = i + 1 >= window_;
+    for (std::size_t j = 0; j < mean_.size(); ++j) {
+      double* history = history_.data() + j * capacity_;
+      history[std::size_t(i) % capacity_] = x[j];
+      bool const stale = nonFinite_[j] > 0;
+      nonFinite_[j] += !std::isfinite(x[j]);
+      if (leaving)
+        nonFinite_[j] -= !std::isfinite(leaving[j]);
+      if (nonFinite_[j]) {
+        y[j] = notANumber;
+        continue;
+      }
+
+      if (stale) {
+        recompute(history, std::min(i + 1, window_), mean_[j], m2_[j]);
+      } else if (leaving) {
+        // replace the leaving value, the number of values stays at window_
+        double const delta = x[j] - leaving[j];
+        double const mean = mean_[j] + delta / double(window_);
+        m2_[j] += delta * (x[j] - mean + leaving[j] - mean_[j]);
+        mean_[j] = mean;
+        if ((i + 1) % window_ == 0)
+          recompute(history, window_, mean_[j], m2_[j]);
+      } else {
+        double const delta = x[j] - mean_[j];
+        mean_[j] += delta / double(i + 1);
+        m2_[j] += delta * (x[j] - mean_[j]);
+      }
+      y[j] = complete ? std::sqrt(std::max(m2_[j], 0.0) / double(window_ - 1)) : notANumber;
+    }
+  }
+
+  private:
+  //! Mean and squared deviations of the first n values of the history.
+  static void recompute(double const* history, label_t n, double& mean, double& m2)
+  {
+    double sum = 0;
+    for (label_t k = 0; k < n; ++k) {
+      sum += history[k];
+    }
+    mean = sum / double(n);
+    m2 = 0;
+    for (label_t k = 0; k < n; ++k) {
+      m2 += (history[k] - mean) * (history[k] - mean);
+    }
+  }
+
+  label_t window_;
+  //! Entries of the ring buffers, a window longer than the series never fills more than its rows.
+  std::size_t capacity_;
+  std::vector<double> mean_;
+  std::vector<double> m2_;
+  //! Number of NaN or infinite values in the window.
+  std::vector<label_t> nonFinite_;
+  //! The values of the window, a ring buffer per column.
+  std::vector<double> history_;
+};
+
+/*! \brief Minimum or maximum with a monotonic queue per column.
+ *
+ * The queue holds the rows of the window that may still become the extreme, their values ordered
+ * from the extreme at the front. A new value removes all values behind which it beats, every row
+ * enters and leaves the queue once. The queues are ring buffers of window entries, or of one entry
+ * per row if the window is longer than the series. NaN values are
+ * counted instead of queued, the result is NaN while one of them is in the window.
+ */
+template <bool MAXIMUM>
+class Extreme
+{
+  public:
+  Extreme(label_t window, label_t rows, std::size_t cols) :
+      window_(window),
+      capacity_(std::size_t(std::min(window, rows))),
+      rows_(capacity_ * cols),
+      values_(capacity_ * cols),
+      front_(cols, 0),
+      size_(cols, 0),
+      notANumbers_(cols, 0)
+  {}
+
+  label_t lag() const { return window_; }
+
+  void step(label_t i, double const* x, double const* leaving, double* y)
+  {
+    std::size_t const window = capacity_;
+    for (std::size_t j = 0; j < front_.size(); ++j) {
+      label_t* rows = rows_.data() + j * window;
+      double* values = values_.data() + j * window;
+      std::size_t& front = front_[j];
+      std::size_t& size = size_[j];
+      if (size && rows[front] <= i - window_) {
+        front = (front + 1) % window;
+        --size;
+      }
+      if (leaving && std::isnan(leaving[j]))
+        --notANumbers_[j];
+      if (std::isnan(x[j])) {
+        ++notANumbers_[j];
+      } else {
+        while (size && !beats(values[(front + size - 1) % window], x[j])) {
+          --size;
+        }
+        rows[(front + size) % window] = i;
+        values[(front + size) % window] = x[j];
+        ++size;
+      }
+      y[j] = i + 1 >= window_ && !notANumbers_[j] ? values[front] : notANumber;
+    }
+  }
+
+  private:
+  //! Tell if a value in the queue stays in front of a new value.
+  static bool beats(double queued, double value) { return MAXIMUM ? queued > value : queued < value; }
+
+  label_t window_;
+  std::size_t capacity_;
+  std::vector<label_t> rows_;
+  std::vector<double> values_;
+  std::vector<std::size_t> front_;
+  std::vector<std::size_t> size_;
+  //! Number of NaN values in the window.
+  std::vector<label_t> notANumbers_;
+};
+
+class ExponentialMean
+{
+  public:
+  ExponentialMean(double alpha, std::size_t cols) :
+      alpha_(alpha),
+      mean_(cols, 0.0)
+  {}
+
+  label_t lag() const { return 0; }
+
+  void step(label_t i, double const* x, double const*, double* y)
+  {
+    for (std::size_t j = 0; j < mean_.size(); ++j) {
+      mean_[j] = i ? mean_[j] + alpha_ * (x[j] - mean_[j]) : x[j];
+      y[j] = mean_[j];
+    }
+  }
+
+  private:
+  double alpha_;
+  std::vector<double> mean_;
+};
+
+template <bool LOGARITHMIC>
+class Returns
+{
+  public:
+  Returns(label_t lag, std::size_t cols) :
+      lag_(lag),
+      cols_(cols)
+  {}
+
+  label_t lag() const { return lag_; }
+
+  void step(label_t, double const* x, double const* previous, double* y)
+  {
+    for (std::size_t j = 0; j < cols_; ++j) {
+      if (!previous)
+        y[j] = notANumber;
+      else if (LOGARITHMIC)
+        y[j] = std::log(x[j] / previous[j]);
+      else
+        y[j] = x[j] / previous[j] - 1.0;
+    }
+  }
+
+  private:
+  label_t lag_;
+  std::size_t cols_;
+};
+
+template <typename TYPE>
+void loadRow(DatasetView<TYPE> const& values, label_t i, label_t firstCol, std::vector<double>& row)
+{
+  for (std::size_t j = 0; j < row.size(); ++j) {
+    row[j] = static_cast<double>(values(i, firstCol + label_t(j)));
+  }
+}
+
+//! Run a kernel over all rows of the columns [firstCol, lastCol), writing rows of result.
+template <typename TYPE, typename KERNEL>
+void rollColumns(DatasetView<TYPE> const& values, label_t firstCol, label_t lastCol, KERNEL kernel,
+                 double* result)
+{
+  std::vector<double> current(std::size_t(lastCol - firstCol));
+  std::vector<double> previous(kernel.lag() ? current.size() : 0);
+  for (label_t i = 0; i < values.rows(); ++i) {
+    loadRow(values, i, firstCol, current);
+    bool const hasPrevious = kernel.lag() && i >= kernel.lag();
+    if (hasPrevious)
+      loadRow(values, i - kernel.lag(), firstCol, previous);
+    kernel.step(i, current.data(), hasPrevious ? previous.data() : nullptr,
+                result + std::ptrdiff_t(i) * values.cols() + firstCol);
+  }
+}
+
+//! Split the columns into groups, run a kernel created by makeKernel(cols) on each group in parallel.
+template <typename TYPE, typename FACTORY>
+Dataset roll(DatasetView<TYPE> const& values, unsigned threads, FACTORY const& makeKernel)
+{
+  // a selection without rows keeps its columns, like Dataset::rows
+  if (values.rows() == 0)
+    return Dataset(std::vector<double>(std::size_t(values.cols())), values.cols()).rows(0, 0);
+  std::vector<double> result(values.size());
+  std::size_t const groups = (std::size_t(values.cols()) + columnGroup - 1) / columnGroup;
+  std::size_t const ranges
+      = std::max<std::size_t>(1, std::min({threadCount(threads), groups, values.size() / valuesPerThread}));
+  parallelRanges(ranges, unsigned(ranges), [&](std::size_t r) {
+    label_t const first = label_t(groups * r / ranges * columnGroup);
+    label_t const last = std::min(values.cols(), label_t(groups * (r + 1) / ranges * columnGroup));
+    rollColumns(values, first, last, makeKernel(std::size_t(last - first)), result.data());
+  });
+  return Dataset(std::move(result), values.cols());
+}
+
+template <typename FACTORY>
+Dataset roll(Dataset const& ds, unsigned threads, FACTORY const& makeKernel)
+{
+  if (ds.getType() == Dataset::Type::EMPTY)
+    return Dataset();
+  return ds.visit([&](auto const& values) { return roll(values, threads, makeKernel); });
+}
+}  // namespace
+
+Dataset DatasetRolling::mean(Dataset const& ds, label_t window, unsigned threads)
+{
+  checkWindow(window, "Rolling window");
+  return roll(ds, threads, [window](std::size_t cols) { return Mean(window, cols); });
+}
+
+Dataset DatasetRolling::standardDeviation(Dataset const& ds, label_t window, unsigned threads)
+{
+  if (window < 2)
+    D_THROW("Rolling window of a standard deviation must be at least 2, got " + Utility::toString(window) + ".");
+  label_t const rows = ds.getRows();
+  return roll(ds, threads, [window, rows](std::size_t cols) { return StandardDeviation(window, rows, cols); });
+}
+
+Dataset DatasetRolling::min(Dataset const& ds, label_t window, unsigned threads)
+{
+  checkWindow(window, "Rolling window");
+  label_t const rows = ds.getRows();
+  return roll(ds, threads, [window, rows](std::size_t cols) { return Extreme<false>(window, rows, cols); });
+}
+
+Dataset DatasetRolling::max(Dataset const& ds, label_t window, unsigned threads)
+{
+  checkWindow(window, "Rolling window");
+  label_t const rows = ds.getRows();
+  return roll(ds, threads, [window, rows](std::size_t cols) { return Extreme<true>(window, rows, cols); });
+}
+
+Dataset DatasetRolling::ema(Dataset const& ds, double alpha, unsigned threads)
+{
+  if (!(alpha > 0.0 && alpha <= 1.0))
+    D_THROW("Smoothing factor alpha must be in (0, 1], got " + Utility::toString(alpha) + ".");
+  return roll(ds, threads, [alpha](std::size_t cols) { return ExponentialMean(alpha, cols); });
+}
+
+Dataset DatasetRolling::returns(Dataset const& ds, label_t lag, unsigned threads)
+{
+  checkWindow(lag, "Lag of returns");
+  return roll(ds, threads, [lag](std::size_t cols) { return Returns<false>(lag, cols); });
+}
+
+Dataset DatasetRolling::logReturns(Dataset const& ds, label_t lag, unsigned threads)
+{
+  checkWindow(lag, "Lag of returns");
+  return roll(ds, threads, [lag](std::size_t cols) { return Returns<true>(lag, cols); });
+}
+
+}  // namespace DUTIL
@@ -0,0 +1,56 @@
+#ifndef DUTIL_DATASETROLLING_H
+#define DUTIL_DATASETROLLING_H
+#include "dataset.h"
+
+namespace DUTIL {
+
+/*! \brief Rolling-window statistics over the columns of a Dataset, e.g. for price series.
+ *
+ * Every function treats each column as a series over the rows and returns a new FLOAT64 Dataset
+ * with the same number of rows and columns. Row i of the result belongs to the window of rows
+ * [i - window + 1, i]; rows without a complete window are NaN:
+ *
+ * Dataset const closes = bars.columns({3});
+ * Dataset const trend = DatasetRolling::mean(closes, 200);
+ *
+ * All functions stream over the rows once and update their state per row in constant amortized
+ * time, independent of the window length: compensated running sums for the mean, Welford's
+ * updates for the variance, recomputed from the window once every window rows against rounding
+ * errors, and monotonic queues for min and max. NaN and infinite values only affect the rows
+ * whose windows contain them, as if each window was computed on its own.
+ *
+ * The values are read in their stored type from any Dataset, selections included. Datasets with
+ * many columns are split into groups of columns, which are processed on several threads; threads
+ * limits their number, 0 for one per processor.
+ */
+class DatasetRolling
+{
+  public:
+  //! Mean of the last 'window' rows.
+  static Dataset mean(Dataset const& ds, label_t window, unsigned threads = 0);
+
+  //! Sample standard deviation of the last 'window' rows, divided by window - 1; window must be at least 2.
+  static Dataset standardDeviation(Dataset const& ds, label_t window, unsigned threads = 0);
+
+  //! Minimum of the last 'window' rows.
+  static Dataset min(Dataset const& ds, label_t window, unsigned threads = 0);
+
+  //! Maximum of the last 'window' rows.
+  static Dataset max(Dataset const& ds, label_t window, unsigned threads = 0);
+
+  /*! \brief Exponential moving average y[i] = y[i - 1] + alpha * (x[i] - y[i - 1]), starting at x[0].
+     *
+     * alpha has to be in (0, 1], alpha = 2 / (span + 1) corresponds to a span of rows. Every row
+     * depends on all earlier ones, so a NaN value makes all later rows of its column NaN.
+     */
+  static Dataset ema(Dataset const& ds, double alpha, unsigned threads = 0);
+
+  //! Simple returns x[i] / x[i - lag] - 1, NaN for the first 'lag' rows.
+  static Dataset returns(Dataset const& ds, label_t lag = 1, unsigned threads = 0);
+
+  //! Logarithmic returns log(x[i] / x[i - lag]), NaN for the first 'lag' rows.
+  static Dataset logReturns(Dataset const& ds, label_t lag = 1, unsigned threads = 0);
+};
+
+}  // namespace DUTIL
+#endif  // DUTIL_DATASETROLLING_H
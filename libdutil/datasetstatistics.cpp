@@ -0,0 +1,403 @@
+#include "datasetstatistics.h"
+#include <algorithm>
+#include <limits>
+#include "parallel.h"
+#include "simd.h"
+
+#if defined(D_GCC) && defined(__x86_64__)
+#define D_STATISTICS_AVX2
+// The kernels are compiled a second time into a function for AVX2 and have to be inlined there.
+#define D_KERNEL inline __attribute__((always_inline))
+#else
+#define D_KERNEL inline
+#endif
+
+namespace DUTIL {
+
+namespace {
+using Summation = DatasetStatistics::Summation;
+
+//! Rows summed directly before the block is merged into the results of its range.
+constexpr label_t blockRows = 256;
+
+//! Values processed by one step of the kernels.
+constexpr std::size_t chunkWidth = 16;
+
+//! Values reduced by one range at least, smaller Datasets are split into fewer ranges.
+constexpr std::size_t valuesPerThread = std::size_t(1) << 18;
+
+//! Levels of the pairwise summation, enough for 2^64 blocks.
+constexpr std::size_t pairwiseLevels = 64;
+
+constexpr double infinity = std::numeric_limits<double>::infinity();
+
+/*! \brief Accumulators of chunkWidth consecutive values of a row group.
+ *
+ * Keeping them in one struct lets the compiler vectorize the kernels without checks for
+ * overlapping arrays.
+ */
+struct Chunk
+{
+  double sum[chunkWidth];
+  double min[chunkWidth];
+  double max[chunkWidth];
+  double center[chunkWidth];
+  double m2[chunkWidth];
+};
+
+template <typename TYPE>
+D_KERNEL void loadChunk(TYPE const* x, std::size_t count, double* values)
+{
+  if (count == chunkWidth) {
+    for (std::size_t k = 0; k < chunkWidth; ++k) {
+      values[k] = static_cast<double>(x[k]);
+    }
+    return;
+  }
+  // the padding belongs to accumulators that are never read
+  for (std::size_t k = 0; k < chunkWidth; ++k) {
+    values[k] = k < count ? static_cast<double>(x[k]) : 0.0;
+  }
+}
+
+//! Add the n values of a full row group to the sums, minima and maxima of the chunks.
+template <typename TYPE>
+D_KERNEL void sumGroup(TYPE const* x, std::size_t n, Chunk* chunks)
+{
+  for (std::size_t c = 0; c * chunkWidth < n; ++c) {
+    double values[chunkWidth];
+    loadChunk(x + c * chunkWidth, std::min(chunkWidth, n - c * chunkWidth), values);
+    Chunk& chunk = chunks[c];
+    for (std::size_t k = 0; k < chunkWidth; ++k) {
+      chunk.sum[k] += values[k];
+      chunk.min[k] = values[k] < chunk.min[k] ? values[k] : chunk.min[k];
+      chunk.max[k] = values[k] > chunk.max[k] ? values[k] : chunk.max[k];
+    }
+  }
+}
+
+//! Add the squared deviations from the block means of a full row group.
+template <typename TYPE>
+D_KERNEL void deviateGroup(TYPE const* x, std::size_t n, Chunk* chunks)
+{
+  for (std::size_t c = 0; c * chunkWidth < n; ++c) {
+    double values[chunkWidth];
+    loadChunk(x + c * chunkWidth, std::min(chunkWidth, n - c * chunkWidth), values);
+    Chunk& chunk = chunks[c];
+    for (std::size_t k = 0; k < chunkWidth; ++k) {
+      double const deviation = values[k] - chunk.center[k];
+      chunk.m2[k] += deviation * deviation;
+    }
+  }
+}
+
+//! Running results of a range of rows.
+class Partial
+{
+  public:
+  Partial(label_t cols, Summation summation, bool covariance) :
+      count(0),
+      sum(std::size_t(cols), 0.0),
+      mean(std::size_t(cols), 0.0),
+      m2(std::size_t(cols), 0.0),
+      min(std::size_t(cols), infinity),
+      max(std::size_t(cols), -infinity),
+      comoment(covariance ? std::size_t(cols) * std::size_t(cols) : 0, 0.0),
+      cols_(std::size_t(cols)),
+      summation_(summation),
+      compensation_(summation == Summation::KAHAN ? cols_ : 0, 0.0),
+      levels_(summation == Summation::PAIRWISE ? pairwiseLevels * cols_ : 0, 0.0),
+      occupied_(summation == Summation::PAIRWISE ? pairwiseLevels : 0, 0),
+      delta_(cols_, 0.0)
+  {}
+
+  //! Add the sums of a block according to the summation.
+  void addSums(double const* blockSum)
+  {
+    if (summation_ == Summation::PLAIN) {
+      for (std::size_t j = 0; j < cols_; ++j) {
+        sum[j] += blockSum[j];
+      }
+    } else if (summation_ == Summation::KAHAN) {
+      for (std::size_t j = 0; j < cols_; ++j) {
+        double const y = blockSum[j] - compensation_[j];
+        double const t = sum[j] + y;
+        compensation_[j] = (t - sum[j]) - y;
+        sum[j] = t;
+      }
+    } else {
+      // a binary counter over the blocks: equal levels are merged, so that every sum is the
+      // sum of two sums of the same number of blocks
+      std::size_t level = 0;
+      delta_.assign(blockSum, blockSum + cols_);
+      for (; occupied_[level]; ++level) {
+        for (std::size_t j = 0; j < cols_; ++j) {
+          delta_[j] += levels_[level * cols_ + j];
+        }
+        occupied_[level] = 0;
+      }
+      std::copy(delta_.begin(), delta_.end(), levels_.begin() + std::ptrdiff_t(level * cols_));
+      occupied_[level] = 1;
+    }
+  }
+
+  //! Merge the means, squared deviations and extremes of 'other' rows following the rows so far.
+  void merge(label_t otherCount, double const* otherMean, double const* otherM2, double const* otherMin,
+             double const* otherMax, double const* otherComoment)
+  {
+    double const total = double(count) + double(otherCount);
+    double const share = double(otherCount) / total;
+    double const weight = double(count) * share;
+    for (std::size_t j = 0; j < cols_; ++j) {
+      delta_[j] = otherMean[j] - mean[j];
+      mean[j] += delta_[j] * share;
+      m2[j] += otherM2[j] + delta_[j] * delta_[j] * weight;
+      min[j] = std::min(min[j], otherMin[j]);
+      max[j] = std::max(max[j], otherMax[j]);
+    }
+    for (std::size_t j = 0; j < cols_ && !comoment.empty(); ++j) {
+      for (std::size_t k = j; k < cols_; ++k) {
+        comoment[j * cols_ + k] += otherComoment[j * cols_ + k] + delta_[j] * delta_[k] * weight;
+      }
+    }
+    count += otherCount;
+  }
+
+  //! Merge the finished results of the rows following this range, the sums with the summation.
+  void merge(Partial const& other)
+  {
+    if (!other.count)
+      return;
+    addSums(other.sum.data());
+    merge(other.count, other.mean.data(), other.m2.data(), other.min.data(), other.max.data(),
+          other.comoment.data());
+  }
+
+  //! Collect the sums once all blocks are added; more sums may be added and collected afterwards.
+  void finishSums()
+  {
+    for (std::size_t j = 0; j < compensation_.size(); ++j) {
+      sum[j] -= compensation_[j];
+      compensation_[j] = 0.0;
+    }
+    for (std::size_t level = 0; level < occupied_.size(); ++level) {
+      for (std::size_t j = 0; j < cols_ && occupied_[level]; ++j) {
+        sum[j] += levels_[level * cols_ + j];
+      }
+      occupied_[level] = 0;
+    }
+  }
+
+  label_t count;
+  std::vector<double> sum;
+  std::vector<double> mean;
+  std::vector<double> m2;
+  std::vector<double> min;
+  std::vector<double> max;
+  //! Upper triangle of the sums of products of deviations, empty without covariance.
+  std::vector<double> comoment;
+
+  private:
+  std::size_t cols_;
+  Summation summation_;
+  std::vector<double> compensation_;
+  std::vector<double> levels_;
+  std::vector<char> occupied_;
+  std::vector<double> delta_;
+};
+
+/*! \brief Accumulate the rows [begin, end) block by block.
+ *
+ * Rows are processed in groups. A group of a contiguous Dataset holds as many rows as fit into
+ * two chunks, so that even a single column fills the vector registers. Other Datasets are read
+ * row by row.
+ */
+template <typename TYPE>
+D_KERNEL void reduceRows(DatasetView<TYPE> const& values, label_t begin, label_t end, Partial& partial)
+{
+  std::size_t const cols = std::size_t(values.cols());
+  bool const flat = values.isContiguous();
+  std::size_t const lanes = flat ? std::max<std::size_t>(1, 2 * chunkWidth / cols) : 1;
+  std::size_t const width = lanes * cols;
+  std::vector<Chunk> chunks((width + chunkWidth - 1) / chunkWidth);
+  std::vector<TYPE> gathered(flat || values.colStride() == 1 ? 0 : cols);
+  std::vector<double> blockSum(cols), blockMean(cols), blockM2(cols), blockMin(cols), blockMax(cols);
+  std::vector<double> blockComoment(partial.comoment.size()), deviation(cols);
+
+  auto const row = [&](label_t i) -> TYPE const* {
+    if (flat)
+      return values.data() + std::ptrdiff_t(i) * values.cols();
+    if (gathered.empty())
+      return &values(i, 0);
+    for (std::size_t j = 0; j < cols; ++j) {
+      gathered[j] = values(i, label_t(j));
+    }
+    return gathered.data();
+  };
+  auto const accumulator = [&chunks](std::size_t k) -> Chunk& { return chunks[k / chunkWidth]; };
+
+  for (label_t first = begin; first < end; first += blockRows) {
+    label_t const last = std::min(end, first + blockRows);
+    label_t const fullGroups = (last - first) / label_t(lanes);
+    label_t const tail = first + fullGroups * label_t(lanes);
+    std::size_t const tailValues = std::size_t(last - tail) * cols;
+    for (auto& chunk : chunks) {
+      std::fill(std::begin(chunk.sum), std::end(chunk.sum), 0.0);
+      std::fill(std::begin(chunk.min), std::end(chunk.min), infinity);
+      std::fill(std::begin(chunk.max), std::end(chunk.max), -infinity);
+      std::fill(std::begin(chunk.m2), std::end(chunk.m2), 0.0);
+    }
+
+    for (label_t i = first; i < tail; i += label_t(lanes)) {
+      sumGroup(row(i), width, chunks.data());
+    }
+    TYPE const* rest = row(tail < last ? tail : first);
+    for (std::size_t k = 0; k < tailValues; ++k) {
+      double const value = static_cast<double>(rest[k]);
+      Chunk& chunk = accumulator(k);
+      chunk.sum[k % chunkWidth] += value;
+      chunk.min[k % chunkWidth] = std::min(chunk.min[k % chunkWidth], value);
+      chunk.max[k % chunkWidth] = std::max(chunk.max[k % chunkWidth], value);
+    }
+
+    // fold the lanes into columns and center the deviations at the means of the block
+    label_t const count = last - first;
+    std::fill(blockSum.begin(), blockSum.end(), 0.0);
+    std::fill(blockMin.begin(), blockMin.end(), infinity);
+    std::fill(blockMax.begin(), blockMax.end(), -infinity);
+    for (std::size_t k = 0; k < width; ++k) {
+      Chunk const& chunk = accumulator(k);
+      blockSum[k % cols] += chunk.sum[k % chunkWidth];
+      blockMin[k % cols] = std::min(blockMin[k % cols], chunk.min[k % chunkWidth]);
+      blockMax[k % cols] = std::max(blockMax[k % cols], chunk.max[k % chunkWidth]);
+    }
+    for (std::size_t j = 0; j < cols; ++j) {
+      blockMean[j] = blockSum[j] / double(count);
+    }
+    for (std::size_t k = 0; k < chunks.size() * chunkWidth; ++k) {
+      accumulator(k).center[k % chunkWidth] = blockMean[k % cols];
+    }
+
+    for (label_t i = first; i < tail; i += label_t(lanes)) {
+      deviateGroup(row(i), width, chunks.data());
+    }
+    rest = row(tail < last ? tail : first);
+    for (std::size_t k = 0; k < tailValues; ++k) {
+      double const value = static_cast<double>(rest[k]) - blockMean[k % cols];
+      accumulator(k).m2[k % chunkWidth] += value * value;
+    }
+    std::fill(blockM2.begin(), blockM2.end(), 0.0);
+    for (std::size_t k = 0; k < width; ++k) {
+      blockM2[k % cols] += accumulator(k).m2[k % chunkWidth];
+    }
+
+    if (!blockComoment.empty()) {
+      std::fill(blockComoment.begin(), blockComoment.end(), 0.0);
+      for (label_t i = first; i < last; ++i) {
+        TYPE const* x = row(i);
+        for (std::size_t j = 0; j < cols; ++j) {
+          deviation[j] = static_cast<double>(x[j]) - blockMean[j];
+        }
+        for (std::size_t j = 0; j < cols; ++j) {
+          double* products = blockComoment.data() + j * cols;
+          for (std::size_t k = j; k < cols; ++k) {
+            products[k] += deviation[j] * deviation[k];
+          }
+        }
+      }
+    }
+
+    partial.addSums(blockSum.data());
+    partial.merge(count, blockMean.data(), blockM2.data(), blockMin.data(), blockMax.data(),
+                  blockComoment.data());
+  }
+  partial.finishSums();
+}
+
+#ifdef D_STATISTICS_AVX2
+template <typename TYPE>
+__attribute__((target("avx2"))) void reduceRowsAVX2(DatasetView<TYPE> const& values, label_t begin,
+                                                     label_t end, Partial& partial)
+{
+  reduceRows(values, begin, end, partial);
+}
+#endif
+
+template <typename TYPE>
+void reduceRange(DatasetView<TYPE> const& values, label_t begin, label_t end, Partial& partial)
+{
+#ifdef D_STATISTICS_AVX2
+  if (SIMD::activeInstructionSet() == SIMD::InstructionSet::AVX2)
+    return reduceRowsAVX2(values, begin, end, partial);
+#endif
+  reduceRows(values, begin, end, partial);
+}
+
+//! Reduce ranges of rows on several threads and merge them in row order.
+template <typename TYPE>
+Partial reduce(DatasetView<TYPE> const& values, Summation summation, bool covariance, unsigned threads)
+{
+  std::size_t const ranges = std::max<std::size_t>(1, std::min(threadCount(threads), values.size() / valuesPerThread));
+  // ranges consist of whole blocks, their sums are added with the summation like block sums
+  label_t const blocks = (values.rows() + blockRows - 1) / blockRows;
+  std::vector<Partial> partials(ranges, Partial(values.cols(), summation, covariance));
+  parallelRanges(ranges, unsigned(ranges), [&values, &partials, blocks, ranges](std::size_t r) {
+    label_t const begin = label_t(std::size_t(blocks) * r / ranges) * blockRows;
+    label_t const end = std::min(values.rows(), label_t(std::size_t(blocks) * (r + 1) / ranges) * blockRows);
+    reduceRange(values, begin, end, partials[r]);
+  });
+  for (std::size_t r = 1; r < ranges; ++r) {
+    partials.front().merge(partials[r]);
+  }
+  partials.front().finishSums();
+  return std::move(partials.front());
+}
+
+Partial reduce(Dataset const& ds, Summation summation, bool covariance, unsigned threads)
+{
+  return ds.visit([&](auto const& values) { return reduce(values, summation, covariance, threads); });
+}
+}  // namespace
+
+std::vector<DatasetStatistics::Column> DatasetStatistics::compute(Dataset const& ds, Summation summation,
+                                                                  unsigned threads)
+{
+  if (ds.getType() == Dataset::Type::EMPTY)
+    return std::vector<Column>();
+  Partial const partial = reduce(ds, summation, false, threads);
+  std::vector<Column> columns(std::size_t(ds.getCols()));
+  for (std::size_t j = 0; j < columns.size(); ++j) {
+    Column& column = columns[j];
+    column.count = partial.count;
+    column.sum = partial.sum[j];
+    // the seeds of min and max remain if no value other than NaN was seen
+    bool const seen = partial.min[j] <= partial.max[j];
+    column.min = seen ? partial.min[j] : std::numeric_limits<double>::quiet_NaN();
+    column.max = seen ? partial.max[j] : std::numeric_limits<double>::quiet_NaN();
+    column.mean = partial.sum[j] / double(partial.count);
+    column.variance = partial.count > 1 ? partial.m2[j] / double(partial.count - 1)
+                                        : std::numeric_limits<double>::quiet_NaN();
+  }
+  return columns;
+}
+
+Dataset DatasetStatistics::covariance(Dataset const& ds, unsigned threads)
+{
+  if (ds.getType() == Dataset::Type::EMPTY)
+    return Dataset();
+  Partial const partial = reduce(ds, Summation::PLAIN, true, threads);
+  std::size_t const cols = std::size_t(ds.getCols());
+  double const divisor = partial.count > 1 ? double(partial.count - 1) : std::numeric_limits<double>::quiet_NaN();
+  std::vector<double> matrix(cols * cols);
+  for (std::size_t j = 0; j < cols; ++j) {
+    for (std::size_t k = j; k < cols; ++k) {
+      matrix[j * cols + k] = partial.comoment[j * cols + k] / divisor;
+      matrix[k * cols + j] = matrix[j * cols + k];
+    }
+  }
+  return Dataset(std::move(matrix), ds.getCols());
+}
+
+}  // namespace DUTIL
+
+#undef D_KERNEL
@@ -0,0 +1,67 @@
+#ifndef DUTIL_DATASETSTATISTICS_H
+#define DUTIL_DATASETSTATISTICS_H
+#include <vector>
+#include "dataset.h"
+#include "namedenum.h"
+
+namespace DUTIL {
+
+/*! \brief Per-column statistics of a Dataset, computed in one pass over the stored values.
+ *
+ * The values are read in their stored type and row by row, so a Dataset of many columns is never
+ * copied or transposed and selections of rows or columns work without copies as well. Rows are
+ * processed in blocks of a few hundred rows: a block is summed, its mean subtracted and the squared
+ * deviations summed while it is still in the cache. Block results are merged with the formulas of
+ * Chan et al., which keeps the variance accurate also for values with a large mean. The loops over
+ * a block run over contiguous values and are vectorized, Datasets with few columns are processed
+ * several rows at once.
+ *
+ * Large Datasets are split into ranges of rows processed on several threads, the results of the
+ * ranges are merged in row order. All results are double, whatever the data type.
+ */
+class DatasetStatistics
+{
+  public:
+  /*! \brief Summation of the column sums and means.
+     *
+     * Each block is summed directly. PLAIN adds the block sums one after the other, KAHAN adds them
+     * with compensated summation and PAIRWISE adds them in a balanced tree. The error of KAHAN and
+     * PAIRWISE hardly grows with the number of rows, PLAIN is slightly faster.
+     *
+     * The sums of the ranges of rows processed by different threads are added the same way. The
+     * order of the additions depends on the number of ranges, so the last bits of sums and means
+     * may differ with the number of threads.
+     */
+  D_NAMED_ENUM(Summation, PLAIN, KAHAN, PAIRWISE);
+
+  //! Statistics of a single column.
+  struct Column
+  {
+    label_t count = 0;
+    double sum = 0;
+    double min = 0;
+    double max = 0;
+    double mean = 0;
+    //! Sample variance, divided by count - 1. NaN for less than two rows.
+    double variance = 0;
+  };
+
+  /*! \brief Return the statistics of every column, an empty vector for an EMPTY Dataset.
+     *
+     * threads limits the number of threads, 0 for one per processor. Small Datasets are processed
+     * on the calling thread only. NaN values propagate into all results except min and max, which
+     * are NaN only if a column has no rows or nothing but NaN values.
+     */
+  static std::vector<Column> compute(Dataset const& ds, Summation summation = Summation::PAIRWISE,
+                                     unsigned threads = 0);
+
+  /*! \brief Return the sample covariance matrix of the columns as cols x cols FLOAT64 Dataset.
+     *
+     * Computed in the same pass as the column statistics, with a cost growing with the square of
+     * the number of columns. An EMPTY Dataset returns an EMPTY Dataset.
+     */
+  static Dataset covariance(Dataset const& ds, unsigned threads = 0);
+};
+
+}  // namespace DUTIL
+#endif  // DUTIL_DATASETSTATISTICS_H
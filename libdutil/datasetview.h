@@ -0,0 +1,123 @@
+#ifndef DUTIL_DATASETVIEW_H
+#define DUTIL_DATASETVIEW_H
+#include <cstddef>
+#include <string>
+#include "exception.h"
+#include "utility.h"
+
+namespace DUTIL {
+
+/*! \brief Typed, non-owning 2D span over values of a Dataset.
+ *
+ * A view describes rows x cols values of type TYPE starting at data(). Element (i, j) is found at
+ * data()[i * rowStride() + j * colStride()], strides are counted in elements. The view of a whole
+ * Dataset has the strides (cols, 1), row and column views of it pick a single row or column
+ * without copying:
+ *
+ * auto prices = ds.view<double>();
+ * for (label_t i = 0; i < prices.rows(); ++i)
+ *   total += prices(i, 2);
+ *
+ * Element access with operator() is unchecked in release builds, use at() for bounds-checked
+ * access that throws.
+ *
+ * The view does not keep the values alive, it is valid as long as the Dataset it was obtained
+ * from or one of its copies exists.
+ */
+template <typename TYPE>
+class DatasetView
+{
+  public:
+  using value_type = TYPE;
+
+  //! Construct an empty view.
+  DatasetView() noexcept :
+      data_(nullptr),
+      rows_(0),
+      cols_(0),
+      rowStride_(0),
+      colStride_(0)
+  {}
+
+  //! Construct a view of rows x cols values with the given strides.
+  DatasetView(TYPE const* data, label_t rows, label_t cols, std::ptrdiff_t rowStride,
+              std::ptrdiff_t colStride) noexcept :
+      data_(data),
+      rows_(rows),
+      cols_(cols),
+      rowStride_(rowStride),
+      colStride_(colStride)
+  {}
+
+  TYPE const* data() const noexcept { return data_; }
+  label_t rows() const noexcept { return rows_; }
+  label_t cols() const noexcept { return cols_; }
+  std::ptrdiff_t rowStride() const noexcept { return rowStride_; }
+  std::ptrdiff_t colStride() const noexcept { return colStride_; }
+
+  //! Return the number of elements.
+  std::size_t size() const noexcept { return std::size_t(rows_) * std::size_t(cols_); }
+  bool empty() const noexcept { return rows_ == 0 || cols_ == 0; }
+
+  //! Tell if the elements are stored row by row without gaps, so data() can be read as flat array.
+  bool isContiguous() const noexcept
+  {
+    return (colStride_ == 1 || cols_ <= 1) && (rowStride_ == cols_ || rows_ <= 1);
+  }
+
+  //! Return element (i, j) without bounds checks.
+  TYPE const& operator()(label_t i, label_t j) const noexcept
+  {
+    D_ASSERT(i >= 0 && i < rows_ && j >= 0 && j < cols_);
+    return data_[i * rowStride_ + j * colStride_];
+  }
+
+  //! Return element (i, j), throw if the indices are out of bounds.
+  TYPE const& at(label_t i, label_t j) const
+  {
+    if (j < 0 || j >= cols_)
+      throwIllegalColumn(j);
+    if (i < 0 || i >= rows_)
+      throwIllegalRow(i);
+    return (*this)(i, j);
+  }
+
+  //! Return a view of row i as 1 x cols values.
+  DatasetView row(label_t i) const
+  {
+    if (i < 0 || i >= rows_)
+      throwIllegalRow(i);
+    return DatasetView(data_ + i * rowStride_, 1, cols_, rowStride_, colStride_);
+  }
+
+  //! Return a view of column j as rows x 1 values.
+  DatasetView column(label_t j) const
+  {
+    if (j < 0 || j >= cols_)
+      throwIllegalColumn(j);
+    return DatasetView(data_ + j * colStride_, rows_, 1, rowStride_, colStride_);
+  }
+
+  private:
+  //! Kept apart from the checks, so that at() stays small enough to be inlined.
+  [[noreturn]] void throwIllegalRow(label_t i) const
+  {
+    D_THROW("illegal row index " + Utility::toString(i) + ", number of rows is "
+            + Utility::toString(rows_));
+  }
+
+  [[noreturn]] void throwIllegalColumn(label_t j) const
+  {
+    D_THROW("illegal column index " + Utility::toString(j) + ", number of columns is "
+            + Utility::toString(cols_));
+  }
+
+  TYPE const* data_;
+  label_t rows_;
+  label_t cols_;
+  std::ptrdiff_t rowStride_;
+  std::ptrdiff_t colStride_;
+};
+
+}  // namespace DUTIL
+#endif  // DUTIL_DATASETVIEW_H
@@ -0,0 +1,86 @@
+#ifndef DUTIL_HASH_H
+#define DUTIL_HASH_H
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace DUTIL {
+
+/*! \brief Small collection of hash functions.
+ *
+ * All functions are constexpr so that hashes of string literals can be computed at compile time
+ * and compared to hashes computed at run time.
+ */
+namespace Hash {
+
+//! 64 bit FNV-1a hash of a string.
+constexpr std::uint64_t fnv1a(std::string_view str) noexcept
+{
+  std::uint64_t hash = 0xcbf29ce484222325ull;
+  for (char c : str) {
+    hash ^= static_cast<std::uint8_t>(c);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+//! Scramble the bits of a 64 bit value (splitmix64 finalizer), e.g. to hash integers.
+constexpr std::uint64_t mix(std::uint64_t value) noexcept
+{
+  value ^= value >> 30;
+  value *= 0xbf58476d1ce4e5b9ull;
+  value ^= value >> 27;
+  value *= 0x94d049bb133111ebull;
+  value ^= value >> 31;
+  return value;
+}
+
+//! Combine a hash value with another one.
+constexpr std::uint64_t combine(std::uint64_t seed, std::uint64_t value) noexcept
+{
+  return mix(seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2)));
+}
+
+/*! \name Index tables
+ *
+ * Helpers for open addressing tables with linear probing which hold 32 bit positions into a
+ * separate vector of entries, as used by VariantSet and Settings. The number of slots is a power
+ * of two and the table is kept at most half full.
+ */
+//!@{
+
+//! Marker of an unused slot.
+constexpr std::uint32_t emptySlot = 0xFFFFFFFF;
+
+//! Return the number of slots needed to index 'size' entries, at least 'minimalCount'.
+constexpr std::size_t slotCountFor(std::size_t size, std::size_t minimalCount) noexcept
+{
+  std::size_t count = minimalCount;
+  while (count < 2 * size) {
+    count *= 2;
+  }
+  return count;
+}
+
+//! Return the slot probed after 'slot' in a table with 'slotCount' slots.
+constexpr std::size_t nextSlot(std::size_t slot, std::size_t slotCount) noexcept
+{
+  return (slot + 1) & (slotCount - 1);
+}
+
+//! Store 'position' in the first unused slot probed from 'slot' on and return that slot.
+template <typename SLOTS>
+constexpr std::size_t occupyFreeSlot(SLOTS& slots, std::size_t slot, std::uint32_t position) noexcept
+{
+  while (slots[slot] != emptySlot) {
+    slot = nextSlot(slot, slots.size());
+  }
+  slots[slot] = position;
+  return slot;
+}
+
+//!@}
+
+}  // namespace Hash
+}  // namespace DUTIL
+#endif  // DUTIL_HASH_H
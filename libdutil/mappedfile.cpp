@@ -0,0 +1,121 @@
+#include "mappedfile.h"
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <utility>
+#if defined(D_MINGW_MXE) || defined(D_MINGW_NATIVE) || defined(D_MSVC)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "exception.h"
+
+namespace DUTIL {
+
+MappedFile::MappedFile(std::string const& path, Access access) :
+    path_(path),
+    buffer_(),
+    data_(nullptr),
+    size_(0)
+{
+#if defined(D_MINGW_MXE) || defined(D_MINGW_NATIVE) || defined(D_MSVC)
+  // There is no memory mapping on these platforms, the whole file is read into a buffer.
+  (void)access;
+  std::ifstream stream(path, std::ios::binary | std::ios::ate);
+  if (!stream)
+    D_THROW("Cannot open file '" + path + "': " + std::strerror(errno) + ".");
+  auto const end = stream.tellg();
+  if (end < 0)
+    D_THROW("Cannot read the size of file '" + path + "'.");
+  size_ = static_cast<std::size_t>(end);
+  if (size_ > 0) {
+    buffer_ = std::make_unique<char[]>(size_);
+    stream.seekg(0);
+    if (!stream.read(buffer_.get(), static_cast<std::streamsize>(size_)))
+      D_THROW("Cannot read file '" + path + "'.");
+    data_ = buffer_.get();
+  }
+#else
+  int const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    D_THROW("Cannot open file '" + path + "': " + std::strerror(errno) + ".");
+
+  struct stat info;
+  if (::fstat(fd, &info) != 0) {
+    int const error = errno;
+    ::close(fd);
+    D_THROW("Cannot read the size of file '" + path + "': " + std::strerror(error) + ".");
+  }
+
+  size_ = static_cast<std::size_t>(info.st_size);
+  if (size_ > 0 && size_ < mappingThreshold) {
+    buffer_ = std::make_unique<char[]>(size_);
+    std::size_t done = 0;
+    while (done < size_) {
+      auto const n = ::read(fd, buffer_.get() + done, size_ - done);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0) {
+        int const error = n < 0 ? errno : EIO;
+        ::close(fd);
+        D_THROW("Cannot read file '" + path + "': " + std::strerror(error) + ".");
+      }
+      done += std::size_t(n);
+    }
+    data_ = buffer_.get();
+  } else if (size_ > 0) {
+    void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      int const error = errno;
+      ::close(fd);
+      D_THROW("Cannot map file '" + path + "' into memory: " + std::strerror(error) + ".");
+    }
+    // content read front to back lets the kernel read ahead aggressively
+    if (access == Access::SEQUENTIAL)
+      ::madvise(mapping, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<char const*>(mapping);
+  }
+  // the mapping keeps its own reference to the file
+  ::close(fd);
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    path_(std::move(other.path_)),
+    buffer_(std::move(other.buffer_)),
+    data_(std::exchange(other.data_, nullptr)),
+    size_(std::exchange(other.size_, 0))
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+  if (this != &other) {
+    unmap();
+    path_ = std::move(other.path_);
+    buffer_ = std::move(other.buffer_);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile()
+{
+  unmap();
+}
+
+void MappedFile::unmap() noexcept
+{
+#if !(defined(D_MINGW_MXE) || defined(D_MINGW_NATIVE) || defined(D_MSVC))
+  if (data_ && !buffer_)
+    ::munmap(const_cast<char*>(data_), size_);
+#endif
+  buffer_.reset();
+  data_ = nullptr;
+  size_ = 0;
+}
+
+}  // namespace DUTIL
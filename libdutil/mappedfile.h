@@ -0,0 +1,67 @@
+#ifndef DUTIL_MAPPEDFILE_H
+#define DUTIL_MAPPEDFILE_H
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "namedenum.h"
+
+namespace DUTIL {
+
+/*! \brief Read-only memory mapping of a whole file.
+ *
+ * The file content is mapped into the address space instead of being copied into a buffer, pages
+ * are loaded by the operating system when they are accessed first. The mapping stays valid until
+ * the object is destroyed, all pointers and string views into it have to be released before.
+ *
+ * Files smaller than 'mappingThreshold' are read into a buffer instead, because setting up and
+ * tearing down a mapping costs more than copying a few pages.
+ * Windows builds (MinGW and MSVC) have no memory mapping and read every file into a buffer.
+ *
+ * The access pattern tells the operating system how far to read ahead. SEQUENTIAL suits parsers
+ * that read the content once from front to back, NORMAL suits data that is accessed in parts.
+ *
+ * Opening or mapping a file that does not exist or cannot be read throws an exception.
+ * Empty files are allowed and yield an empty mapping.
+ */
+class MappedFile
+{
+  public:
+  //! Files of at least this size in bytes are mapped, smaller ones are read.
+  static constexpr std::size_t mappingThreshold = 64 * 1024;
+
+  //! Expected access pattern of mapped files.
+  D_NAMED_ENUM(Access, SEQUENTIAL, NORMAL)
+
+  //! Map the file with the given path.
+  explicit MappedFile(std::string const& path, Access access = Access::SEQUENTIAL);
+
+  MappedFile(MappedFile const&) = delete;
+  MappedFile& operator=(MappedFile const&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  ~MappedFile();
+
+  //! Return the path of the mapped file.
+  std::string const& path() const noexcept { return path_; }
+
+  char const* data() const noexcept { return data_; }
+  std::size_t size() const noexcept { return size_; }
+
+  //! Tell if the file is mapped, smaller files are read into a buffer.
+  bool isMapped() const noexcept { return data_ && !buffer_; }
+
+  //! Return the file content as text.
+  std::string_view text() const noexcept { return std::string_view(data_, size_); }
+
+  private:
+  void unmap() noexcept;
+
+  std::string path_;
+  std::unique_ptr<char[]> buffer_;
+  char const* data_;
+  std::size_t size_;
+};
+
+}  // namespace DUTIL
+#endif  // DUTIL_MAPPEDFILE_H
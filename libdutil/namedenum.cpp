@@ -1,24 +1,69 @@
 #include "namedenum.h"
+#include <mutex>
 #include "exception.h"
 #include "variant.h"
 
 namespace DUTIL {
 namespace NamedEnumDetail {
 
+namespace {
+std::mutex registryMutex;
+
+std::map<std::string, EnumTypeInfo const *, std::less<>> &getRegistry()
+{
+    static std::map<std::string, EnumTypeInfo const *, std::less<>> registry;
+    return registry;
+}
+} // namespace
+
 void dealWithExcpetion(std::string const msg)
 {
     D_THROW(msg);
 }
 
-std::string variantToString(DUTIL::Variant const &variant)
+void registerEnumType(EnumTypeInfo const &info)
 {
-    if(variant.isString()){
-        return variant.toString();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto result = getRegistry().emplace(info.name, &info);
+    if (!result.second && result.first->second != &info)
+        result.first->second = nullptr; // the name is ambiguous
+}
+
+EnumTypeInfo const *findEnumType(std::string_view name)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto const &registry = getRegistry();
+    auto it = registry.find(name);
+    return it != registry.end() ? it->second : nullptr;
+}
+
+std::uint32_t nameToOrdinal(std::string_view input, EnumTypeInfo const &info)
+{
+    auto const name = Utility::trim(input);
+    if (name.empty())
+        return noOrdinal;
+
+    auto const &names = info.valueNames;
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == name)
+            return static_cast<std::uint32_t>(i);
     }
-    else{
-        D_THROW("Variant parameter does not hold a std::string value.");
-        return std::string {};
+
+    std::string allowedValues;
+    for (auto const &node : names) {
+        allowedValues += node + ",";
     }
+    D_THROW("The input string '" + std::string(input)
+            + "' is not registered as an enum value. Allowed values are:" + allowedValues);
+}
+
+std::uint32_t variantToOrdinal(DUTIL::Variant const &variant, EnumTypeInfo const &info)
+{
+    if (variant.enumTypeInfo() == &info)
+        return variant.enumOrdinal();
+    if (!variant.isString() && !variant.isEnum())
+        D_THROW("Variant parameter does not hold a std::string value.");
+    return nameToOrdinal(variant.asStringView(), info);
 }
 } //namespace NamedEnumDetail
 } // namespace DUTIL
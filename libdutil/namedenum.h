@@ -1,8 +1,13 @@
 #ifndef DUTIL_NAMEDENUM_H
 #define DUTIL_NAMEDENUM_H
+#include <algorithm>
+#include <cstdint>
 #include <map>
+#include <string_view>
+#include <vector>
 #include "basictypes.h"
 #include "exception.h"
+#include "hash.h"
 #include "utility.h"
 
 namespace DUTIL {
@@ -15,12 +20,46 @@ void dealWithExcpetion(const std::string msg);
 template <typename ENUM_BASE_TYPE>
 using MapType = std::map<ENUM_BASE_TYPE, std::string>;
 
-/*! \brief Return Variant value as string
+/*! \brief Runtime description of a named enum type.
  *
- * See also DUTIL::Variant::toString function.
- * If no conversion is possible, function returns an empty string.
+ * A DUTIL::Variant stores a named enum as a pointer to the description of its type together with
+ * the ordinal of the value, i.e. its position in the ascending list of enum values. The value names
+ * are listed in ordinal order. There is exactly one description per named enum type,
+ * see NamedEnumBase::getTypeInfo.
  */
-std::string variantToString(DUTIL::Variant const& variant);
+struct EnumTypeInfo
+{
+  std::string name;
+  StringList valueNames;
+};
+
+//! Ordinal returned by nameToOrdinal and variantToOrdinal for an empty name.
+constexpr std::uint32_t noOrdinal = 0xFFFFFFFF;
+
+/*! \brief Make an enum type description findable by its name.
+ *
+ * If several named enum types share the same name, e.g. because they are defined in different
+ * namespaces or classes, none of them can be found by that name.
+ */
+void registerEnumType(EnumTypeInfo const& info);
+
+//! Return the description of the registered enum type with the given name, nullptr if it is unknown or ambiguous.
+EnumTypeInfo const* findEnumType(std::string_view name);
+
+/*! \brief Return the ordinal of the enum value with the given name.
+ *
+ * Leading and trailing whitespace is ignored. An empty name yields noOrdinal, names which are not
+ * registered in 'info' throw an exception.
+ */
+std::uint32_t nameToOrdinal(std::string_view input, EnumTypeInfo const& info);
+
+/*! \brief Return the ordinal of the enum value held by a variant.
+ *
+ * Variants holding an enum described by 'info' yield their ordinal without any look up.
+ * Strings and enums of other types are looked up by name, see nameToOrdinal. All other types
+ * throw an exception.
+ */
+std::uint32_t variantToOrdinal(DUTIL::Variant const& variant, EnumTypeInfo const& info);
 
 /*! \brief Fill the map with enum value strings
  *
@@ -68,40 +107,6 @@ StringList getListOfAllowedValues(MapType<ENUM_BASE_TYPE> const& map) noexcept
   return list;
 }
 
-/*! \brief Return corresponding base type to given enum string value.
- *
- * Basically, this function searches for an enum string inside the enum value map
- * to initialize an enum type object with the underlying enum base type.
- * If that string is not found, an exception is thrown. In case of an empty input
- * string, the defalut enum value is used as return value.
- */
-template <typename ENUM_BASE_TYPE>
-ENUM_BASE_TYPE fromStringToBaseType(MapType<ENUM_BASE_TYPE> const& map, ENUM_BASE_TYPE defaultValue,
-                                    std::string const& input)
-{
-  std::string str = Utility::trim(input);
-  if (str.empty()) {
-    return defaultValue;
-  }
-
-  // look up string in map
-  for (auto const& node : map) {
-    if (node.second == str) {
-      return node.first;
-    }
-  }
-
-  // string not found
-  std::string allowedValues;
-  for (auto const& node : map) {
-    allowedValues += node.second + ",";
-  }
-  NamedEnumDetail::dealWithExcpetion("The input string '" + input
-                                     + "' is not registered as an enum value. Allowed values are:"
-                                     + allowedValues);
-  return ENUM_BASE_TYPE();
-}
-
 }  // namespace NamedEnumDetail
 
 /*! \brief NamedEnum, a smart enum knowing its type name.
@@ -132,7 +137,8 @@ class NamedEnumBase
 
   static void checkName()
   {
-    if (DERIVED_ENUM_CLASS::getEnumName() == NOT_ALLOWED) {
+    // compare the cached type name, getEnumName() returns a new string on each call
+    if (getTypeInfo().name == NOT_ALLOWED) {
       D_ASSERT_MSG(false, "Enum name is not allowed.");
     }
   }
@@ -168,10 +174,11 @@ class NamedEnumBase
 
   /*! \brief Construct from DUTIL::Variant object.
      *
-     * This constructor delegates the construction to the NamedEnumBase(std::string const & value) constructor.
+     * Variants holding a value of this enum type are converted via the stored ordinal,
+     * variants holding a string are handled like the NamedEnumBase(std::string const & value) constructor.
      */
   explicit NamedEnumBase(DUTIL::Variant const& variant) :
-      NamedEnumBase(NamedEnumDetail::variantToString(variant))
+      value_(fromOrdinal(NamedEnumDetail::variantToOrdinal(variant, getTypeInfo())))
   {
     checkName();
   }
@@ -208,11 +215,26 @@ class NamedEnumBase
     return NamedEnumDetail::getListOfAllowedValues(getNameMap());
   }
 
+  //! Return the position of the current value in the ascending list of enum values.
+  std::uint32_t ordinal() const
+  {
+    auto const& values = getTypeData().values;
+    return static_cast<std::uint32_t>(std::lower_bound(values.cbegin(), values.cend(), value_)
+                                      - values.cbegin());
+  }
+
+  //! Return the runtime description of this enum type which is registered on first use.
+  static NamedEnumDetail::EnumTypeInfo const& getTypeInfo() { return getTypeData(); }
+
   protected:
-  static ENUM_BASE_TYPE fromStringToBaseType(std::string input)
+  /*! \brief Return corresponding base type to given enum string value.
+     *
+     * If that string is not found, an exception is thrown. In case of an empty input
+     * string, the default enum value is used as return value.
+     */
+  static ENUM_BASE_TYPE fromStringToBaseType(std::string_view input)
   {
-    return NamedEnumDetail::fromStringToBaseType<ENUM_BASE_TYPE>(getNameMap(), getDefaultValue(),
-                                                                 input);
+    return fromOrdinal(NamedEnumDetail::nameToOrdinal(input, getTypeInfo()));
   }
 
   static std::string toString(ENUM_BASE_TYPE aBaseTypeValue)
@@ -233,14 +255,44 @@ class NamedEnumBase
 
   static NamedEnumDetail::MapType<ENUM_BASE_TYPE>& getNameMap()
   {
-    // static map at compile time
-    static NamedEnumDetail::MapType<ENUM_BASE_TYPE> nameMap;
-    if (nameMap.empty()) {
-      initNameMap(nameMap);
-    }
+    // static map, initialized once in a thread-safe manner
+    static NamedEnumDetail::MapType<ENUM_BASE_TYPE> nameMap = [] {
+      NamedEnumDetail::MapType<ENUM_BASE_TYPE> map;
+      initNameMap(map);
+      return map;
+    }();
     return nameMap;
   }
 
+  //! Type description extended by the enum values in ordinal order.
+  struct TypeData : NamedEnumDetail::EnumTypeInfo
+  {
+    std::vector<ENUM_BASE_TYPE> values;
+  };
+
+  static TypeData const& getTypeData()
+  {
+    static TypeData const data = [] {
+      TypeData d;
+      d.name = DERIVED_ENUM_CLASS::getEnumName();
+      for (auto const& node : getNameMap()) {
+        d.values.push_back(node.first);
+        d.valueNames.push_back(node.second);
+      }
+      return d;
+    }();
+    [[maybe_unused]] static bool const registered
+        = (NamedEnumDetail::registerEnumType(data), true);
+    return data;
+  }
+
+  static ENUM_BASE_TYPE fromOrdinal(std::uint32_t ordinal)
+  {
+    if (ordinal == NamedEnumDetail::noOrdinal)
+      return getDefaultValue();
+    return getTypeData().values[ordinal];
+  }
+
   static ENUM_BASE_TYPE getDefaultValue() { return getNameMap().cbegin()->first; }
 
   static bool isValidValue(ENUM_BASE_TYPE key)
@@ -273,6 +325,7 @@ class NamedEnumBase
  *  - value(): casts an underlying named enum base type (e.g. int) to the actual enum type.
  *  - fromEnumValue: a friend function returning a ENUM_NAME object built from EnumValues parameter.
  *  - getEnumName: returns ENUM_NAME as a string.
+ *  - getEnumNameHash: returns the FNV-1a hash of ENUM_NAME computed at compile time, see Settings::tryGet.
  *  - getArgumentsString(): returns __VA_ARGS__ content as a single string.
  *  - getFullArgumentsString(): like  getArgumentsString(), but including "END_ENTRY".
  *  - toString: friend method to call protected NamedEnumBase::toString function.
@@ -308,6 +361,11 @@ public:                                                                      \
     {                                                                        \
       return #ENUM_NAME;                                                     \
     }                                                                        \
+    static constexpr std::uint64_t getEnumNameHash()                         \
+    {                                                                        \
+      constexpr auto hash = DUTIL::Hash::fnv1a(#ENUM_NAME);                  \
+      return hash;                                                           \
+    }                                                                        \
     static const std::string getArgumentsString()                            \
     {                                                                        \
       return #__VA_ARGS__;                                                   \
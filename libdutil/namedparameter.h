@@ -1,6 +1,10 @@
 #ifndef DUTIL_NAMEDPARAMETER_H
 #define DUTIL_NAMEDPARAMETER_H
+#include <cstdint>
+#include <string>
+#include <type_traits>
 #include "exception.h"
+#include "hash.h"
 #include "variant.h"
 
 namespace DUTIL {
@@ -8,6 +12,8 @@ namespace DUTIL {
 /*! \brief A "smart" parameter.
  *
  * Use the macro below to associate a run-time name string with a given real or label variable.
+ * The macros also provide the hash of that name computed at compile time, getParameterNameHash(),
+ * which lets Settings find the parameter without hashing its name at run time.
  */
 template <typename T>
 class NamedParameterBase
@@ -25,10 +31,24 @@ class NamedParameterBase
 
   //! Construct from DUTIL::Variant.
   NamedParameterBase(Variant const& variant) :
-      value_(variant.getAs<T>().second)
+      value_()
   {
-    if (!variant.getAs<T>().first)
+    // Read values which already have the parameter type in place, convert all others.
+    if constexpr (std::is_arithmetic_v<T>) {
+      if (T const* v = variant.tryGet<T>()) {
+        value_ = *v;
+        return;
+      }
+    } else if constexpr (std::is_same_v<T, std::string>) {
+      if (variant.isString()) {
+        value_.assign(variant.asStringView());
+        return;
+      }
+    }
+    auto result = variant.getAs<T>();
+    if (!result.first)
       D_THROW("Variant type is not convertible into named parameter type.");
+    value_ = std::move(result.second);
   }
 
   //! Return a copy of parameter value.
@@ -54,6 +74,11 @@ public:                                                                   \
     {                                                                     \
       return #PARAMETER_NAME;                                             \
     }                                                                     \
+    static constexpr std::uint64_t getParameterNameHash()                 \
+    {                                                                     \
+      constexpr auto hash = DUTIL::Hash::fnv1a(#PARAMETER_NAME);          \
+      return hash;                                                        \
+    }                                                                     \
   };
 
 #define D_NAMED_BOOL(BOOL_NAME) D_NAMED_PARAMETER(BOOL_NAME, bool);
@@ -73,6 +98,11 @@ public:                                                             \
     {                                                               \
       return #STRING_NAME;                                          \
     }                                                               \
+    static constexpr std::uint64_t getParameterNameHash()           \
+    {                                                               \
+      constexpr auto hash = DUTIL::Hash::fnv1a(#STRING_NAME);       \
+      return hash;                                                  \
+    }                                                               \
   };
 
 #endif  // DUTIL_NAMEDPARAMETER_H
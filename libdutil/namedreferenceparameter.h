@@ -1,5 +1,7 @@
 #ifndef DUTIL_NAMEDREFERENCEPARAMETER_H
 #define DUTIL_NAMEDREFERENCEPARAMETER_H
+#include <cstdint>
+#include "hash.h"
 
 namespace DUTIL {
 
@@ -43,5 +45,10 @@ public: \
     { \
         return #PARAMETER_NAME; \
     } \
+    static constexpr std::uint64_t getParameterNameHash() \
+    { \
+        constexpr auto hash = DUTIL::Hash::fnv1a(#PARAMETER_NAME); \
+        return hash; \
+    } \
 };
 #endif // DUTIL_NAMEDREFERENCEPARAMETER_H
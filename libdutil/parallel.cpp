@@ -0,0 +1,43 @@
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace DUTIL {
+
+std::size_t threadCount(unsigned threads) noexcept
+{
+  return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+void parallelRanges(std::size_t count, unsigned threads, std::function<void(std::size_t)> const& work)
+{
+  std::vector<std::exception_ptr> exceptions(count);
+  std::atomic<std::size_t> next(0);
+  auto const run = [&]() {
+    for (std::size_t r = next++; r < count; r = next++) {
+      try {
+        work(r);
+      } catch (...) {
+        exceptions[r] = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (std::size_t t = 1; t < std::min(count, threadCount(threads)); ++t) {
+    workers.emplace_back(run);
+  }
+  run();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  for (auto const& exception : exceptions) {
+    if (exception)
+      std::rethrow_exception(exception);
+  }
+}
+
+}  // namespace DUTIL
@@ -0,0 +1,20 @@
+#ifndef DUTIL_PARALLEL_H
+#define DUTIL_PARALLEL_H
+#include <cstddef>
+#include <functional>
+
+namespace DUTIL {
+
+//! Return the number of threads to use, 'threads' itself or one per processor for 0.
+std::size_t threadCount(unsigned threads) noexcept;
+
+/*! \brief Call work(r) for every r in [0, count) on at most 'threads' threads, 0 for one per processor.
+ *
+ * The calling thread takes part, no thread is started for a single piece of work. Every thread
+ * takes the next piece not yet taken until none is left. Exceptions thrown by work do not stop the
+ * other pieces; once all threads are joined the exception of the first failed piece is rethrown.
+ */
+void parallelRanges(std::size_t count, unsigned threads, std::function<void(std::size_t)> const& work);
+
+}  // namespace DUTIL
+#endif  // DUTIL_PARALLEL_H
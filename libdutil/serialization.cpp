@@ -0,0 +1,114 @@
+#include "serialization.h"
+#include <cstring>
+#include "exception.h"
+#include "utility.h"
+
+namespace DUTIL {
+
+BinaryWriter::BinaryWriter(ByteBuffer& buffer) :
+    buffer_(buffer)
+{}
+
+void BinaryWriter::writeByte(std::uint8_t value)
+{
+  buffer_.push_back(value);
+}
+
+void BinaryWriter::writeVarint(std::uint64_t value)
+{
+  while (value >= 0x80) {
+    buffer_.push_back(static_cast<std::uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  buffer_.push_back(static_cast<std::uint8_t>(value));
+}
+
+void BinaryWriter::writeSignedVarint(std::int64_t value)
+{
+  // zigzag encoding maps 0, -1, 1, -2, ... onto 0, 1, 2, 3, ...
+  writeVarint((std::uint64_t(value) << 1) ^ std::uint64_t(value >> 63));
+}
+
+void BinaryWriter::writeDouble(double value)
+{
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  for (int i = 0; i < 8; ++i) {
+    buffer_.push_back(static_cast<std::uint8_t>(bits >> (8 * i)));
+  }
+}
+
+void BinaryWriter::writeString(std::string_view value)
+{
+  writeVarint(value.size());
+  buffer_.insert(buffer_.end(), value.begin(), value.end());
+}
+
+BinaryReader::BinaryReader(std::uint8_t const* data, std::size_t size) :
+    data_(data),
+    size_(size),
+    position_(0)
+{}
+
+BinaryReader::BinaryReader(ByteBuffer const& buffer) :
+    BinaryReader(buffer.data(), buffer.size())
+{}
+
+void BinaryReader::require(std::size_t n) const
+{
+  if (n > remaining())
+    D_THROW("Binary data is truncated: " + Utility::toString(std::uint64_t(n))
+            + " more byte(s) expected at position " + Utility::toString(std::uint64_t(position_))
+            + ".");
+}
+
+std::uint8_t BinaryReader::readByte()
+{
+  require(1);
+  return data_[position_++];
+}
+
+std::uint64_t BinaryReader::readVarint()
+{
+  std::uint64_t value = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    std::uint8_t byte = readByte();
+    // the tenth byte holds only the 64th bit, more would overflow
+    if (shift == 63 && (byte & 0x7F) > 1)
+      break;
+    value |= std::uint64_t(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return value;
+  }
+  D_THROW("Malformed varint in binary data at position "
+          + Utility::toString(std::uint64_t(position_)) + ".");
+}
+
+std::int64_t BinaryReader::readSignedVarint()
+{
+  std::uint64_t value = readVarint();
+  return std::int64_t(value >> 1) ^ -std::int64_t(value & 1);
+}
+
+double BinaryReader::readDouble()
+{
+  require(8);
+  std::uint64_t bits = 0;
+  for (int i = 0; i < 8; ++i) {
+    bits |= std::uint64_t(data_[position_++]) << (8 * i);
+  }
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+std::string_view BinaryReader::readString()
+{
+  std::uint64_t length = readVarint();
+  require(length);
+  std::string_view value(reinterpret_cast<char const*>(data_ + position_), length);
+  position_ += length;
+  return value;
+}
+
+}  // namespace DUTIL
@@ -0,0 +1,79 @@
+#ifndef DUTIL_SERIALIZATION_H
+#define DUTIL_SERIALIZATION_H
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace DUTIL {
+
+//! Byte buffer holding binary serialized data.
+using ByteBuffer = std::vector<std::uint8_t>;
+
+/*! \brief Append binary encoded values to a byte buffer.
+ *
+ * The encoding is compact and platform independent:
+ * - unsigned integers are written as LEB128 varints, i.e. seven bits per byte,
+ * - signed integers are zigzag encoded first, so small negative numbers stay short,
+ * - doubles are written as their raw eight IEEE 754 bytes in little endian order,
+ * - strings are written as varint length followed by the characters.
+ *
+ * Classes offering a binary representation implement a 'serialize(BinaryWriter&) const' member
+ * and a static 'deserialize(BinaryReader&)' function, see Variant, Settings and SettingRule.
+ */
+class BinaryWriter
+{
+  public:
+  //! Write into the given buffer, new data is appended to the existing content.
+  explicit BinaryWriter(ByteBuffer& buffer);
+
+  void writeByte(std::uint8_t value);
+  void writeVarint(std::uint64_t value);
+  void writeSignedVarint(std::int64_t value);
+  void writeDouble(double value);
+  void writeString(std::string_view value);
+
+  //! Return the buffer written to.
+  ByteBuffer const& buffer() const noexcept { return buffer_; }
+
+  private:
+  ByteBuffer& buffer_;
+};
+
+/*! \brief Read binary encoded values written by a BinaryWriter.
+ *
+ * The reader does not own the data, the underlying memory has to outlive the reader and
+ * all string views returned by it.
+ * Reading past the end of the data or reading malformed varints throws an exception.
+ */
+class BinaryReader
+{
+  public:
+  BinaryReader(std::uint8_t const* data, std::size_t size);
+  explicit BinaryReader(ByteBuffer const& buffer);
+
+  std::uint8_t readByte();
+  std::uint64_t readVarint();
+  std::int64_t readSignedVarint();
+  double readDouble();
+
+  //! Return a view into the underlying data, no copy is made.
+  std::string_view readString();
+
+  //! Number of bytes which have not been read yet.
+  std::size_t remaining() const noexcept { return size_ - position_; }
+
+  //! Tell if all data has been read.
+  bool atEnd() const noexcept { return position_ == size_; }
+
+  private:
+  //! Throw if less than n bytes are left.
+  void require(std::size_t n) const;
+
+  std::uint8_t const* data_;
+  std::size_t size_;
+  std::size_t position_;
+};
+
+}  // namespace DUTIL
+#endif  // DUTIL_SERIALIZATION_H
@@ -1,7 +1,19 @@
 #include "settingrule.h"
+#include "serialization.h"
 
 using namespace DUTIL;
 
+namespace {
+//! Read the ordinal of a named enum, 'what' names it in the error message.
+label_t readOrdinal(BinaryReader &reader, std::string const &what)
+{
+    auto const ordinal = Conversion::numericCast<label_t>(reader.readVarint());
+    if (!ordinal.ok())
+        D_THROW("Binary data holds " + what + " which is out of range.");
+    return ordinal.value;
+}
+} // namespace
+
 SettingRule::SettingRule() :
     usage(Usage::OPTIONAL),
     key(""),
@@ -13,3 +25,44 @@ SettingRule::SettingRule() :
     maximalValue(),
     minimalStringLength(0)
 {}
+
+void SettingRule::serialize(BinaryWriter &writer) const
+{
+    writer.writeVarint(std::uint64_t(label_t(usage)));
+    writer.writeString(key);
+    writer.writeString(description);
+    writer.writeVarint(listOfPossibleValues.size());
+    for (auto const &value : listOfPossibleValues) {
+        writer.writeString(value);
+    }
+    writer.writeVarint(std::uint64_t(label_t(type)));
+    defaultValue.serialize(writer);
+    minimalValue.serialize(writer);
+    maximalValue.serialize(writer);
+    writer.writeSignedVarint(minimalStringLength);
+}
+
+SettingRule SettingRule::deserialize(BinaryReader &reader)
+{
+    SettingRule sr;
+    sr.usage = Usage(readOrdinal(reader, "a setting usage"));
+    sr.key = reader.readString();
+    sr.description = reader.readString();
+    auto const size = reader.readVarint();
+    if (size > reader.remaining())
+        D_THROW("Binary data announces " + Utility::toString(size)
+                + " possible values which exceeds the size of the data.");
+    sr.listOfPossibleValues.reserve(size);
+    for (std::uint64_t i = 0; i < size; ++i) {
+        sr.listOfPossibleValues.emplace_back(reader.readString());
+    }
+    sr.type = Variant::Type(readOrdinal(reader, "a variant type"));
+    sr.defaultValue = Variant::deserialize(reader);
+    sr.minimalValue = Variant::deserialize(reader);
+    sr.maximalValue = Variant::deserialize(reader);
+    auto minimalStringLength = Conversion::numericCast<label_t>(reader.readSignedVarint());
+    if (!minimalStringLength.ok())
+        D_THROW("Binary data holds a minimal string length which is out of range.");
+    sr.minimalStringLength = minimalStringLength.value;
+    return sr;
+}
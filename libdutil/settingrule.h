@@ -34,7 +34,18 @@ struct SettingRule
      */
   SettingRule();
 
+  /*! \brief Binary serialization, see BinaryWriter for the encoding.
+     *
+     * All members are written in declaration order, enums as their base type values.
+     */
+  void serialize(BinaryWriter& writer) const;
+  static SettingRule deserialize(BinaryReader& reader);
+
   /*! \brief Create a SettingRule for a NamedEnum type.
+     *
+     * The rule's type is Variant::Type::ENUM, values given as strings holding an enum name are
+     * accepted as well. In turn, STRING rules accept enum values by their name, see
+     * ConstructionValidator.
      *
      * Usage:
      * Settingrule sr = SettingRule::forNamedEnum<NAMED_ENUM_TYPE>(usage, description);
@@ -47,7 +58,7 @@ struct SettingRule
     sr.key = NE::getEnumName();
     sr.description = description;
     sr.listOfPossibleValues = NE::getAllowedNames();
-    sr.type = Variant::Type::STRING;
+    sr.type = Variant::Type::ENUM;
     if (u != Usage::MANDATORY_NO_DEFAULT)
       sr.defaultValue = Variant(NE().value());
     return sr;
@@ -1,90 +1,567 @@
 #include "settings.h"
+#include <atomic>
+#include <limits>
+#include "hash.h"
+#include "namedenum.h"
+#include "serialization.h"
 
 namespace DUTIL {
 
+namespace {
+// Key hashes are FNV-1a, whose low bits are weak, so the slot is taken from the mixed hash.
+std::size_t firstSlot(std::uint64_t hash, std::size_t slotCount)
+{
+    return static_cast<std::size_t>(Hash::mix(hash)) & (slotCount - 1);
+}
+
+// Variant::hash of strings depends on the standard library, so strings and named enums, which
+// equal strings holding their name, are hashed by name to get the same fingerprint in every run.
+std::uint64_t valueFingerprint(Variant const &value)
+{
+    if (value.isString() || value.isEnum())
+        return Hash::mix(Hash::fnv1a(value.asStringView()));
+    return value.hash();
+}
+using Hash::emptySlot;
+
+// Marker of a missing entry.
+constexpr std::size_t npos = std::size_t(-1);
+
+// Initial capacity of the entry vectors.
+constexpr std::size_t minimalCapacity = 4;
+} // namespace
+
+struct Settings::Storage
+{
+    explicit Storage(allocator_type const &alloc) :
+        valueMap(alloc),
+        hashes(alloc),
+        slots(alloc)
+    {}
+
+    Storage(Storage const &other, allocator_type const &alloc) :
+        valueMap(other.valueMap, alloc),
+        hashes(other.hashes, alloc),
+        slots(other.slots, alloc),
+        fingerprint(other.fingerprint.load(std::memory_order_relaxed))
+    {}
+
+    //! Return the position of the entry with the given key or npos.
+    std::size_t indexOf(std::string_view key) const;
+
+    //! Return the position of the entry with the given key and key hash or npos.
+    std::size_t indexOf(std::string_view key, std::uint64_t hash) const;
+
+    //! Reserve the entry vectors and the index table for 'size' entries.
+    void reserve(std::size_t size);
+
+    //! Append a new entry, the key must not exist yet.
+    void append(std::string_view key, Variant &&value);
+
+    //! Link the last entry to the index table, growing the table if necessary.
+    void indexLastEntry();
+
+    //! Rebuild the index table, or drop it if there are few enough entries to search linearly.
+    void rebuildIndex();
+
+    //! Remove the entry at position i, keeping the order of the others and the index table.
+    void remove(std::size_t i);
+
+    //! Remove all entries marked in 'erased' in one pass and rebuild the index table once.
+    void remove(std::vector<bool> const &erased);
+
+    MapType valueMap;
+    std::pmr::vector<std::uint64_t> hashes;
+    std::pmr::vector<std::uint32_t> slots;
+    //! Cached fingerprint, 0 if it has not been computed yet. Atomic for concurrent readers.
+    mutable std::atomic<std::uint64_t> fingerprint{0};
+    /*! Number of Settings objects sharing this storage. Unlike shared_ptr::use_count, owners
+     * drop out with release and are checked with acquire, so the accesses of a copy destroyed on
+     * another thread happen before the entries are changed in place.
+     */
+    std::atomic<std::size_t> owners{0};
+};
+
+std::size_t Settings::Storage::indexOf(std::string_view key) const
+{
+    // comparing a few keys is cheaper than hashing the searched one
+    if (slots.empty()) {
+        for (std::size_t i = 0; i < valueMap.size(); ++i) {
+            if (std::string_view(valueMap[i].first) == key)
+                return i;
+        }
+        return npos;
+    }
+    return indexOf(key, Hash::fnv1a(key));
+}
+
+std::size_t Settings::Storage::indexOf(std::string_view key, std::uint64_t hash) const
+{
+    if (slots.empty()) {
+        for (std::size_t i = 0; i < hashes.size(); ++i) {
+            if (hashes[i] == hash && std::string_view(valueMap[i].first) == key)
+                return i;
+        }
+        return npos;
+    }
+
+    for (std::size_t slot = firstSlot(hash, slots.size());; slot = Hash::nextSlot(slot, slots.size())) {
+        std::uint32_t const index = slots[slot];
+        if (index == emptySlot)
+            return npos;
+        if (hashes[index] == hash && std::string_view(valueMap[index].first) == key)
+            return index;
+    }
+}
+
+void Settings::Storage::reserve(std::size_t size)
+{
+    valueMap.reserve(size);
+    hashes.reserve(size);
+    // the table still grows step by step, but within the reserved capacity
+    if (size > indexThreshold)
+        slots.reserve(Hash::slotCountFor(size, 2 * indexThreshold));
+}
+
+void Settings::Storage::append(std::string_view key, Variant &&value)
+{
+    if (valueMap.size() >= std::numeric_limits<std::uint32_t>::max())
+        D_THROW("Settings can not hold more than 2^32 - 1 entries.");
+    // skip the smallest growth steps, most Settings objects hold a few entries
+    if (valueMap.capacity() == 0) {
+        valueMap.reserve(minimalCapacity);
+        hashes.reserve(minimalCapacity);
+    }
+    valueMap.emplace_back(std::piecewise_construct,
+                          std::forward_as_tuple(key),
+                          std::forward_as_tuple(std::move(value)));
+    hashes.push_back(Hash::fnv1a(key));
+    indexLastEntry();
+}
+
+void Settings::Storage::indexLastEntry()
+{
+    std::size_t const size = valueMap.size();
+    if (size <= indexThreshold)
+        return;
+    if (2 * size > slots.size()) {
+        rebuildIndex();
+        return;
+    }
+
+    Hash::occupyFreeSlot(slots, firstSlot(hashes.back(), slots.size()), static_cast<std::uint32_t>(size - 1));
+}
+
+void Settings::Storage::rebuildIndex()
+{
+    std::size_t const size = valueMap.size();
+    if (size <= indexThreshold) {
+        slots.clear();
+        slots.shrink_to_fit();
+        return;
+    }
+
+    std::size_t const slotCount = Hash::slotCountFor(size, 2 * indexThreshold);
+    slots.assign(slotCount, emptySlot);
+    for (std::size_t i = 0; i < size; ++i) {
+        Hash::occupyFreeSlot(slots, firstSlot(hashes[i], slotCount), static_cast<std::uint32_t>(i));
+    }
+}
+
+void Settings::Storage::remove(std::size_t i)
+{
+    if (!slots.empty() && valueMap.size() - 1 > indexThreshold) {
+        // backward-shift deletion: move later entries of the probe sequence into the hole if their
+        // first slot lies not behind it, so that lookups need no tombstones
+        std::size_t const mask = slots.size() - 1;
+        std::size_t hole = firstSlot(hashes[i], slots.size());
+        while (slots[hole] != i) {
+            hole = Hash::nextSlot(hole, slots.size());
+        }
+        for (std::size_t next = Hash::nextSlot(hole, slots.size()); slots[next] != emptySlot;
+             next = Hash::nextSlot(next, slots.size())) {
+            std::size_t const first = firstSlot(hashes[slots[next]], slots.size());
+            if (((next - first) & mask) >= ((next - hole) & mask)) {
+                slots[hole] = slots[next];
+                hole = next;
+            }
+        }
+        slots[hole] = emptySlot;
+        // The entries behind i move one position to the front. The table size is a multiple of 8
+        // and the loop in blocks of 8 without branches is vectorized at -O2 as well; a position in
+        // (i, emptySlot) is the only one with position - first < limit in unsigned arithmetic.
+        if (i + 1 < valueMap.size()) {
+            std::uint32_t const first = static_cast<std::uint32_t>(i) + 1;
+            std::uint32_t const limit = emptySlot - first;
+            std::uint32_t *slot = slots.data();
+            for (std::size_t k = 0; k < slots.size(); k += 8) {
+                for (std::size_t l = 0; l < 8; ++l) {
+                    slot[k + l] -= std::uint32_t(slot[k + l] - first < limit);
+                }
+            }
+        }
+    } else if (!slots.empty()) {
+        slots.clear();
+        slots.shrink_to_fit();
+    }
+    valueMap.erase(valueMap.begin() + std::ptrdiff_t(i));
+    hashes.erase(hashes.begin() + std::ptrdiff_t(i));
+}
+
+void Settings::Storage::remove(std::vector<bool> const &erased)
+{
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < valueMap.size(); ++i) {
+        if (erased[i])
+            continue;
+        if (kept != i) {
+            valueMap[kept] = std::move(valueMap[i]);
+            hashes[kept] = hashes[i];
+        }
+        ++kept;
+    }
+    valueMap.erase(valueMap.begin() + std::ptrdiff_t(kept), valueMap.end());
+    hashes.resize(kept);
+    rebuildIndex();
+}
+
 Settings::Settings() {}
 
+Settings::Settings(allocator_type const &alloc) :
+    alloc_(alloc)
+{}
+
+Settings::Settings(Settings const &other)
+{
+    adopt(share(other, alloc_));
+}
+
+Settings::Settings(Settings const &other, allocator_type const &alloc) :
+    alloc_(alloc)
+{
+    adopt(share(other, alloc));
+}
+
+Settings::Settings(Settings &&other, allocator_type const &alloc) :
+    alloc_(alloc)
+{
+    if (alloc == other.alloc_)
+        storage_ = std::move(other.storage_);
+    else
+        adopt(share(other, alloc));
+}
+
+Settings::~Settings()
+{
+    release();
+}
+
+Settings &Settings::operator=(Settings const &other)
+{
+    if (this != &other)
+        adopt(share(other, alloc_));
+    return *this;
+}
+
+Settings &Settings::operator=(Settings &&other)
+{
+    if (this == &other)
+        return *this;
+    if (alloc_ == other.alloc_) {
+        // the owner moves along, the count of the moved storage stays the same
+        release();
+        storage_ = std::move(other.storage_);
+    } else {
+        adopt(share(other, alloc_));
+    }
+    return *this;
+}
+
+void Settings::adopt(std::shared_ptr<Storage> storage)
+{
+    if (storage)
+        storage->owners.fetch_add(1, std::memory_order_relaxed);
+    release();
+    storage_ = std::move(storage);
+}
+
+void Settings::release() noexcept
+{
+    if (storage_)
+        storage_->owners.fetch_sub(1, std::memory_order_release);
+}
+
+std::shared_ptr<Settings::Storage> Settings::share(Settings const &other, allocator_type const &alloc)
+{
+    if (!other.storage_ || alloc == other.alloc_)
+        return other.storage_;
+    return std::allocate_shared<Storage>(alloc, *other.storage_, alloc);
+}
+
+Settings::Storage const &Settings::storage() const noexcept
+{
+    if (storage_)
+        return *storage_;
+    static Storage const empty{allocator_type()};
+    return empty;
+}
+
+Settings::Storage &Settings::mutableStorage()
+{
+    if (!storage_)
+        adopt(std::allocate_shared<Storage>(alloc_, alloc_));
+    else if (storage_->owners.load(std::memory_order_acquire) > 1)
+        adopt(std::allocate_shared<Storage>(alloc_, *storage_, alloc_));
+    return *storage_;
+}
+
+Settings::allocator_type Settings::get_allocator() const noexcept
+{
+    return alloc_;
+}
+
 bool Settings::empty() const
 {
-    if (valueMap_.empty())
-        return true;
-    return false;
+    return storage().valueMap.empty();
+}
+
+bool Settings::hasKey(std::string_view key) const
+{
+    return storage().indexOf(key) != npos;
 }
 
-bool Settings::hasKey(std::string const &key) const
+std::uint64_t Settings::fingerprint() const noexcept
 {
-    for (auto const &i : valueMap_) {
-        if (i.first == key)
-            return true;
+    Storage const &data = storage();
+    std::uint64_t result = data.fingerprint.load(std::memory_order_relaxed);
+    if (result != 0)
+        return result;
+
+    // summing up the entry hashes makes the result independent of the order of insertion
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < data.valueMap.size(); ++i) {
+        sum += Hash::combine(data.hashes[i], valueFingerprint(data.valueMap[i].second));
     }
-    return false;
+    result = Hash::combine(sum, data.valueMap.size());
+    // 0 marks a missing fingerprint
+    if (result == 0)
+        result = 1;
+    data.fingerprint.store(result, std::memory_order_relaxed);
+    return result;
 }
 
 StringList Settings::keys() const noexcept
 {
-    size_t i = 0, size = valueMap_.size();
+    auto const &valueMap = storage().valueMap;
     StringList list{};
-    list.reserve(size);
-    for (; i < size; ++i) {
-        list.push_back(valueMap_[i].first);
+    list.reserve(valueMap.size());
+    for (auto const &entry : valueMap) {
+        list.emplace_back(entry.first);
     }
     return list;
 }
 
-Variant Settings::value(std::string const key, Variant const &defaultValue) const
+Variant Settings::value(std::string_view key, Variant const &defaultValue) const
+{
+    Variant const *v = tryGet(key);
+    return v ? *v : defaultValue;
+}
+
+Variant const *Settings::tryGet(std::string_view key) const noexcept
 {
     if (key.empty())
-        return defaultValue;
+        return nullptr;
 
-    size_t i = 0, size = valueMap_.size();
-    for (; i < size; ++i) {
-        if (valueMap_[i].first == key)
-            return valueMap_[i].second;
-    }
-    return defaultValue;
+    Storage const &data = storage();
+    auto const i = data.indexOf(key);
+    return i != npos ? &data.valueMap[i].second : nullptr;
+}
+
+Variant const *Settings::tryGet(std::string_view key, std::uint64_t keyHash) const noexcept
+{
+    if (key.empty())
+        return nullptr;
+
+    Storage const &data = storage();
+    auto const i = data.indexOf(key, keyHash);
+    return i != npos ? &data.valueMap[i].second : nullptr;
 }
 
-Settings &Settings::setFromVariant(std::string key, DUTIL::Variant variant)
+Settings &Settings::setFromVariant(std::string_view key, DUTIL::Variant variant)
 {
     if (key.empty())
         return *this;
 
-    size_t i = 0, size = valueMap_.size();
-    for (; i < size; ++i) {
-        if (valueMap_[i].first == key) {
-            valueMap_[i].second = variant; // override map entry if it already exists.
-            break;
-        }
-    }
-    if (i == size)
-        valueMap_.emplace_back(std::make_pair(key, variant));
+    Storage &data = mutableStorage();
+    data.fingerprint.store(0, std::memory_order_relaxed);
+    auto const i = data.indexOf(key);
+    if (i != npos)
+        // override map entry if it already exists, the entry keeps our memory resource.
+        data.valueMap[i].second = std::move(variant);
+    else
+        data.append(key, std::move(variant));
     return *this;
 }
 
-Settings &Settings::erase(std::string const key)
+Settings &Settings::erase(std::string_view key)
 {
-    if (key.empty())
+    if (key.empty() || !hasKey(key))
         return *this;
 
-    auto i = valueMap_.begin();
-    while (i != valueMap_.end() && i->first != key) {
-        ++i;
+    Storage &data = mutableStorage();
+    data.fingerprint.store(0, std::memory_order_relaxed);
+    data.remove(data.indexOf(key));
+    return *this;
+}
+
+Settings &Settings::erase(StringList const &keys)
+{
+    // look the keys up first, an object holding none of them stays shared with its copies
+    Storage const &shared = storage();
+    std::vector<bool> erased;
+    for (auto const &key : keys) {
+        auto const i = key.empty() ? npos : shared.indexOf(key);
+        if (i == npos)
+            continue;
+        if (erased.empty())
+            erased.resize(shared.valueMap.size(), false);
+        erased[i] = true;
+    }
+    if (erased.empty())
+        return *this;
+
+    // copies keep the order of the entries, so the positions stay valid
+    Storage &data = mutableStorage();
+    data.fingerprint.store(0, std::memory_order_relaxed);
+    data.remove(erased);
+    return *this;
+}
+
+Settings::Patch Settings::diff(Settings const &other) const
+{
+    Patch patch;
+    auto const &from = storage();
+    auto const &to = other.storage();
+    if (&from == &to)
+        return patch;
+
+    for (std::size_t i = 0; i < from.valueMap.size(); ++i) {
+        auto const &entry = from.valueMap[i];
+        auto const hash = from.hashes[i];
+        // entries are usually inserted in the same order, try the same position first
+        std::size_t j = i;
+        if (j >= to.hashes.size() || to.hashes[j] != hash || to.valueMap[j].first != entry.first)
+            j = to.indexOf(entry.first, hash);
+        if (j == npos)
+            patch.removed.emplace_back(entry.first);
+        else if (!(to.valueMap[j].second == entry.second))
+            patch.changed.setFromVariant(entry.first, to.valueMap[j].second);
+    }
+    // all keys of 'to' but the added ones have been found above
+    if (to.valueMap.size() + patch.removed.size() != from.valueMap.size()) {
+        for (std::size_t j = 0; j < to.valueMap.size(); ++j) {
+            auto const &entry = to.valueMap[j];
+            if (from.indexOf(entry.first, to.hashes[j]) == npos)
+                patch.added.setFromVariant(entry.first, entry.second);
+        }
+    }
+    return patch;
+}
+
+Settings &Settings::apply(Patch const &patch)
+{
+    erase(patch.removed);
+    for (Settings const *values : {&patch.changed, &patch.added}) {
+        for (auto const &entry : values->storage().valueMap) {
+            setFromVariant(entry.first, entry.second);
+        }
     }
-    if (i != valueMap_.end())
-        valueMap_.erase(i);
     return *this;
 }
 
+bool Settings::Patch::empty() const
+{
+    return added.empty() && changed.empty() && removed.empty();
+}
+
+StringList Settings::Patch::keys() const
+{
+    StringList result = added.keys();
+    for (auto &key : changed.keys()) {
+        result.push_back(std::move(key));
+    }
+    result.insert(result.end(), removed.cbegin(), removed.cend());
+    return result;
+}
+
+void Settings::serialize(BinaryWriter &writer) const
+{
+    auto const &valueMap = storage().valueMap;
+    writer.writeVarint(valueMap.size());
+    for (auto const &entry : valueMap) {
+        writer.writeString(entry.first);
+        entry.second.serialize(writer);
+    }
+}
+
+Settings Settings::deserialize(BinaryReader &reader, allocator_type const &alloc)
+{
+    // Each entry occupies at least two bytes, the key length and the variant tag.
+    auto const size = reader.readVarint();
+    if (size > reader.remaining() / 2)
+        D_THROW("Binary data announces " + Utility::toString(size)
+                + " settings entries which exceeds the size of the data.");
+
+    Settings s(alloc);
+    if (size == 0)
+        return s;
+
+    Storage &data = s.mutableStorage();
+    data.reserve(size);
+    for (std::uint64_t i = 0; i < size; ++i) {
+        auto const key = reader.readString();
+        auto value = Variant::deserialize(reader, alloc);
+        // keep the last value of duplicate keys, like setFromVariant does
+        auto const existing = data.indexOf(key);
+        if (existing != npos)
+            data.valueMap[existing].second = std::move(value);
+        else
+            data.append(key, std::move(value));
+    }
+    return s;
+}
+
 Settings::MapType const &Settings::get() const
 {
-    return valueMap_;
+    return storage().valueMap;
 }
 
 bool operator==(Settings const &lhs, Settings const &rhs)
 {
-    auto lhsMap = lhs.get();
-    auto rhsMap = rhs.get();
-    return (std::tie(lhsMap) == std::tie(rhsMap));
+    auto const &left = lhs.storage();
+    auto const &right = rhs.storage();
+    if (&left == &right)
+        return true;
+    auto const &entries = left.valueMap;
+    if (entries.size() != right.valueMap.size())
+        return false;
+    auto const lhsFingerprint = left.fingerprint.load(std::memory_order_relaxed);
+    auto const rhsFingerprint = right.fingerprint.load(std::memory_order_relaxed);
+    if (lhsFingerprint != 0 && rhsFingerprint != 0 && lhsFingerprint != rhsFingerprint)
+        return false;
+
+    // Keys are unique, so equal sizes and finding every entry of lhs in rhs suffice.
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        std::string_view const key = entries[i].first;
+        auto const hash = left.hashes[i];
+        // entries are usually inserted in the same order, try the same position first
+        std::size_t j = i;
+        if (right.hashes[j] != hash || std::string_view(right.valueMap[j].first) != key)
+            j = right.indexOf(key, hash);
+        if (j == npos || !(right.valueMap[j].second == entries[i].second))
+            return false;
+    }
+    return true;
 }
 
 bool operator!=(Settings const &lhs, Settings const &rhs)
@@ -1,5 +1,10 @@
 #ifndef DUTIL_SETTINGS_H
 #define DUTIL_SETTINGS_H
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
 #include <vector>
 #include "basictypes.h"
 #include "variant.h"
@@ -12,19 +17,71 @@ namespace DUTIL {
  * This class basically defines a data container mapping a string names with
  * its defined value. It allows you to extract data by providing the string key.
  *
+ * Keys, the entry vector and long string values are allocated from the memory resource of the
+ * Settings object, see allocator_type. This allows to build whole configurations inside a
+ * std::pmr::monotonic_buffer_resource and to release them at once.
+ *
+ * Entries are kept in order of insertion together with the hash of each key. Small Settings
+ * objects are searched linearly by comparing keys. Once a Settings object holds more than
+ * indexThreshold entries, an open addressing table with linear probing indexes the entries,
+ * so lookups stay cheap for wares carrying hundreds of settings.
+ *
+ * Copies share their entries until one of them is changed (copy-on-write). Copying a Settings
+ * object therefore takes constant time, only the first change after a copy clones the entries.
+ * Copies may be read, changed and destroyed on different threads, like independent objects.
+ * Entries are only shared between objects using equal memory resources, so the lifetime rules of
+ * std::pmr still hold: a plain copy of a Settings object living in an arena gets its own entries
+ * on the default resource.
  */
 
 class Settings
 {
   public:
+  /*! \brief Allocator type, makes Settings usable in std::pmr containers.
+     *
+     * Follows the usual std::pmr rules: copy construction uses std::pmr::get_default_resource(),
+     * move construction keeps the resource and assignments never change it.
+     */
+  using allocator_type = std::pmr::polymorphic_allocator<char>;
+
   //! Default-construct an empty Settings object.
   Settings();
 
+  //! Construct an empty Settings object allocating from the given allocator's memory resource.
+  explicit Settings(allocator_type const& alloc);
+
+  //! Copy and move construction allocating from the given allocator's memory resource.
+  Settings(Settings const& other, allocator_type const& alloc);
+  Settings(Settings&& other, allocator_type const& alloc);
+
+  //! Maximal number of entries which are searched linearly, larger objects build a hash index.
+  static constexpr std::size_t indexThreshold = 16;
+
+  Settings(Settings const& other);
+  Settings(Settings&& other) noexcept = default;
+  ~Settings();
+  Settings& operator=(Settings const& other);
+  Settings& operator=(Settings&& other);
+
+  //! Return the allocator whose memory resource is used for all entries.
+  allocator_type get_allocator() const noexcept;
+
   //! Check if the Settings object contains any key-value pairs.
   bool empty() const;
 
   //! Check if Setings object already has this registered key.
-  bool hasKey(std::string const& key) const;
+  bool hasKey(std::string_view key) const;
+
+  /*! \brief Return a 64 bit fingerprint of the content.
+     *
+     * Equal Settings objects have equal fingerprints, independent of the order of insertion.
+     * The fingerprint only depends on keys and values, not on memory addresses, so it is the same
+     * in every run of a program and can be used as a key for memoization. Different Settings
+     * objects may share a fingerprint, use operator== to tell them apart.
+     *
+     * The fingerprint is computed on first use and cached until the object is changed.
+     */
+  std::uint64_t fingerprint() const noexcept;
 
   //! Return a list containing all currently registered keys. List can be empty.
   StringList keys() const noexcept;
@@ -35,7 +92,22 @@ class Settings
      * In case of an empty key value the default value will be returned.
      * This function does not alter the object.
      */
-  Variant value(std::string const key, Variant const& defaultValue = Variant()) const;
+  Variant value(std::string_view key, Variant const& defaultValue = Variant()) const;
+
+  /*! \brief Return a pointer to the value specified by the given key or nullptr if there is none.
+     *
+     * Unlike Settings::value, the value is not copied. The pointer is invalidated by any change
+     * of the Settings object.
+     */
+  Variant const* tryGet(std::string_view key) const noexcept;
+
+  /*! \brief Like tryGet(key), but with the key hash computed beforehand.
+     *
+     * 'keyHash' has to be Hash::fnv1a(key), as returned by the getParameterNameHash() and
+     * getEnumNameHash() functions of named parameters and named enums at compile time.
+     * Candidate entries are found by comparing hashes, the key itself is only compared on a hit.
+     */
+  Variant const* tryGet(std::string_view key, std::uint64_t keyHash) const noexcept;
 
   /*! \brief Emplaced back a new key-value pair to the map.
      *
@@ -43,13 +115,20 @@ class Settings
      * the new value and the map size stays the same.
      * In case of an empty key, nothing is added and the function just returns.
      */
-  Settings& setFromVariant(std::string key, DUTIL::Variant value);
+  Settings& setFromVariant(std::string_view key, DUTIL::Variant value);
 
   /*! \brief Remove a value specified by the given key.
      *
      * If no value for the given key is found or in case of an empty key, nothing happens.
      */
-  Settings& erase(std::string const key);
+  Settings& erase(std::string_view key);
+
+  /*! \brief Remove the values of all given keys.
+     *
+     * Unknown and empty keys are skipped. The remaining entries are moved together in a single
+     * pass, so erasing k keys from n entries costs O(n + k) instead of k single erases.
+     */
+  Settings& erase(StringList const& keys);
 
   /*! \brief Add a new settings key-value pair.
      *
@@ -57,9 +136,12 @@ class Settings
      * will be overriden with the new value.
      */
   template <typename ConvertibleToVariant>
-  Settings& set(std::string key, ConvertibleToVariant value)
+  Settings& set(std::string_view key, ConvertibleToVariant value)
   {
-    return setFromVariant(key, DUTIL::Variant(value));
+    if constexpr (VariantDetail::is_allowed_type_v<ConvertibleToVariant>)
+      return setFromVariant(key, DUTIL::Variant(value, get_allocator()));
+    else
+      return setFromVariant(key, DUTIL::Variant(value));
   }
 
   /*! \brief Shortcut mehtod for adding a NamedEnum to the key-value map.
@@ -75,7 +157,7 @@ class Settings
      *   Settings s = Settings().setEnum(WEEKDAY::Monday);
      *
      * Both calls result in the following key-value entry:
-     * key: std::string("WEEKDAY"), value: Variant(std::string("Monday"))
+     * key: std::string("WEEKDAY"), value: Variant(WEEKDAY::Monday), i.e. a variant of Type::ENUM
      */
   template <typename NEV, std::enable_if_t<std::is_enum_v<NEV>, bool> = false>
   Settings& setEnum(NEV const& nev)
@@ -92,14 +174,17 @@ class Settings
 
   /*! \brief Shortcut mehtod for extracting a NamedEnum object.
      *
-     * This function basically calls Settings::value function.
-     * Assumed the enum has been stored using the Settings::setEnum function
-     * which actually stores its string representation.
+     * This function basically calls Settings::tryGet function.
+     * Assumed the enum has been stored using the Settings::setEnum function, no string look up
+     * takes place. Values stored as strings holding the enum name are supported as well.
+     * Neither the key nor the stored value are copied, so no memory is allocated.
      */
   template <typename NE, std::enable_if_t<std::is_enum_v<typename NE::EnumValues>, bool> = false>
   NE getEnum() const
   {
-    return NE(value(NE::getEnumName()));
+    if (Variant const* v = tryGet(NE::getTypeInfo().name, NE::getEnumNameHash()))
+      return NE(*v);
+    return NE(Variant());
   }
 
   /*! \brief Shortcut mehtod for storing a NamedParameter object.
@@ -124,14 +209,17 @@ class Settings
 
   /*! \brief Shortcut mehtod for extracting a NamedParameter objects.
      *
-     * This function basically calls Settings::value function.
+     * This function basically calls Settings::tryGet function.
      * Assumed the named parameter has been stored using the Settings::setParameter function
      * which actually stores its string representation.
+     * Only string parameters allocate memory, for their own copy of the value.
      */
   template <typename NP>
   NP getParameter() const
   {
-    return NP(value(NP::getParameterName()));
+    if (Variant const* v = tryGet(NP::getParameterName(), NP::getParameterNameHash()))
+      return NP(*v);
+    return NP(Variant());
   }
 
   /*! \brief Shortcut mehtod for storing ConcreteClass objects.
@@ -149,9 +237,41 @@ class Settings
     return setParameter<Ware::DUTIL_Ware_Type>(ConcreteClass::getClassName());
   }
 
-  /*! \brief Lexicographical comparison operator.
+  //! Differences between two Settings objects, see diff and apply.
+  struct Patch;
+
+  /*! \brief Return the patch which turns this object into 'other'.
+     *
+     * Only keys which are added, changed or removed are part of the patch, so applying it
+     * touches no more entries than necessary. Copies sharing their entries are compared in
+     * constant time, see the class description.
+     */
+  Patch diff(Settings const& other) const;
+
+  /*! \brief Apply a patch returned by diff.
+     *
+     * Removed keys are erased, added and changed keys are set to the values of the patch.
+     * Afterwards, the object compares equal to the argument of diff. An empty patch does not
+     * touch the object at all, so its entries stay shared with its copies.
+     */
+  Settings& apply(Patch const& patch);
+
+  /*! \brief Binary serialization, see BinaryWriter for the encoding.
+     *
+     * Settings are written as the number of entries followed by key-value pairs in insertion order.
+     * Deserialization allocates the storage, the entry vector and the key hashes once each, and the
+     * index table once for more than indexThreshold entries. Outside the default memory resource
+     * each value adds the block binding it to the resource, see Variant. Only keys and string values
+     * longer than the small string optimization buffers require further allocations.
+     */
+  void serialize(BinaryWriter& writer) const;
+  static Settings deserialize(BinaryReader& reader, allocator_type const& alloc = {});
+
+  /*! \brief Comparison operators.
      *
-     * Implementation uses the std::tie pattern for operators.
+     * Two Settings objects are equal if they hold the same keys with equal values, the order of
+     * insertion does not matter. Nothing is copied, cached fingerprints which differ tell
+     * unequal objects apart right away.
      * Operators are friend functions to be able to use lhs and rhs arguments.
      */
   friend bool operator==(Settings const& lhs, Settings const& rhs);
@@ -160,13 +280,50 @@ class Settings
   protected:
   //! Declare the map type. A vector is used because we want to have
   //! a sequential container.
-  using MapType = std::vector<std::pair<std::string, DUTIL::Variant>>;
+  using MapType = std::pmr::vector<std::pair<std::pmr::string, DUTIL::Variant>>;
 
   //! Return a reference to the map member.
   MapType const& get() const;
 
   private:
-  MapType valueMap_;
+  //! Entries together with the key hashes and the index table, see settings.cpp.
+  struct Storage;
+
+  //! Return the storage of the entries, an empty one if there are none.
+  Storage const& storage() const noexcept;
+
+  //! Return the storage for modification, cloning it first if it is shared with other objects.
+  Storage& mutableStorage();
+
+  //! Return the storage of 'other' to be used by an object allocating from 'alloc'.
+  static std::shared_ptr<Storage> share(Settings const& other, allocator_type const& alloc);
+
+  //! Replace the storage, counting this object as an owner of the new one, see Storage::owners.
+  void adopt(std::shared_ptr<Storage> storage);
+
+  //! Stop counting this object as an owner of its storage.
+  void release() noexcept;
+
+  allocator_type alloc_;
+  std::shared_ptr<Storage> storage_;
+};
+
+/*! \brief A compact description of the differences between two Settings objects.
+ *
+ * 'added' and 'changed' hold the new values of keys which are new or whose values differ,
+ * 'removed' lists the keys which are gone. Unchanged keys are not part of the patch.
+ */
+struct Settings::Patch
+{
+  Settings added;
+  Settings changed;
+  StringList removed;
+
+  //! Tell if the patch does not change anything.
+  bool empty() const;
+
+  //! Return all keys touched by the patch: added, changed and removed ones in this order.
+  StringList keys() const;
 };
 
 }  // namespace DUTIL
@@ -0,0 +1,92 @@
+#include "settingsview.h"
+#include <algorithm>
+
+namespace DUTIL {
+
+SettingsView::SettingsView() :
+    layers_()
+{}
+
+SettingsView::SettingsView(Settings base) :
+    layers_()
+{
+  layers_.push_back(std::move(base));
+}
+
+SettingsView& SettingsView::overlay(Settings layer) &
+{
+  layers_.push_back(std::move(layer));
+  return *this;
+}
+
+SettingsView&& SettingsView::overlay(Settings layer) &&
+{
+  layers_.push_back(std::move(layer));
+  return std::move(*this);
+}
+
+bool SettingsView::empty() const
+{
+  return std::all_of(layers_.cbegin(), layers_.cend(), [](Settings const& s) { return s.empty(); });
+}
+
+bool SettingsView::hasKey(std::string_view key) const
+{
+  return tryGet(key) != nullptr;
+}
+
+StringList SettingsView::keys() const
+{
+  StringList result;
+  for (auto layer = layers_.crbegin(); layer != layers_.crend(); ++layer) {
+    for (auto& key : layer->keys()) {
+      // skip keys hidden by an upper layer, which have been listed already
+      bool const hidden = std::any_of(layers_.crbegin(), layer,
+                                      [&key](Settings const& upper) { return upper.hasKey(key); });
+      if (!hidden)
+        result.push_back(std::move(key));
+    }
+  }
+  return result;
+}
+
+Variant SettingsView::value(std::string_view key, Variant const& defaultValue) const
+{
+  Variant const* v = tryGet(key);
+  return v ? *v : defaultValue;
+}
+
+Variant const* SettingsView::tryGet(std::string_view key) const noexcept
+{
+  for (auto layer = layers_.crbegin(); layer != layers_.crend(); ++layer) {
+    if (Variant const* v = layer->tryGet(key))
+      return v;
+  }
+  return nullptr;
+}
+
+Variant const* SettingsView::tryGet(std::string_view key, std::uint64_t keyHash) const noexcept
+{
+  for (auto layer = layers_.crbegin(); layer != layers_.crend(); ++layer) {
+    if (Variant const* v = layer->tryGet(key, keyHash))
+      return v;
+  }
+  return nullptr;
+}
+
+Settings SettingsView::materialize() const
+{
+  if (layers_.empty())
+    return Settings();
+
+  // the copy shares the entries of the lowest layer until the first override is set
+  Settings result = layers_.front();
+  for (auto layer = layers_.cbegin() + 1; layer != layers_.cend(); ++layer) {
+    for (auto const& key : layer->keys()) {
+      result.setFromVariant(key, *layer->tryGet(key));
+    }
+  }
+  return result;
+}
+
+}  // namespace DUTIL
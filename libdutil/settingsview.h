@@ -0,0 +1,95 @@
+#ifndef DUTIL_SETTINGSVIEW_H
+#define DUTIL_SETTINGSVIEW_H
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "settings.h"
+
+namespace DUTIL {
+
+/*! \brief Layered, read-only access to a stack of Settings objects.
+ *
+ * A view chains a few Settings objects, e.g. small per-instrument overrides on top of large
+ * default settings shared by all instruments:
+ *
+ * SettingsView view = SettingsView(defaults).overlay(instrumentOverrides);
+ * auto gain = view.getParameter<Gain>();
+ *
+ * Lookups start at the topmost layer and fall through to the layers below, so the values of upper
+ * layers hide those of lower layers. A key set to an empty variant in an upper layer hides the
+ * key in all layers below.
+ *
+ * Layers are stored as Settings copies, which share their entries with the original objects, see
+ * Settings. A view therefore only costs memory for its own overrides, no matter how large the
+ * shared layers are. Changing an original Settings object after building the view does not
+ * change the view.
+ */
+class SettingsView
+{
+  public:
+  //! Construct a view without layers.
+  SettingsView();
+
+  //! Construct a view with a single layer.
+  explicit SettingsView(Settings base);
+
+  //! Put a layer on top of all others.
+  SettingsView& overlay(Settings layer) &;
+  SettingsView&& overlay(Settings layer) &&;
+
+  //! Return the number of layers.
+  std::size_t layerCount() const noexcept { return layers_.size(); }
+
+  //! Return layer i, counted from the bottom.
+  Settings const& layer(std::size_t i) const { return layers_.at(i); }
+
+  //! Check if none of the layers contains any key-value pairs.
+  bool empty() const;
+
+  //! Check if any of the layers contains the key.
+  bool hasKey(std::string_view key) const;
+
+  /*! \brief Return all keys visible through the view, each one once.
+     *
+     * Keys of the topmost layer come first, followed by keys of lower layers in the order of their
+     * layers from top to bottom.
+     */
+  StringList keys() const;
+
+  //! Return the value of the topmost layer holding the key or the default value.
+  Variant value(std::string_view key, Variant const& defaultValue = Variant()) const;
+
+  //! Return a pointer to the value of the topmost layer holding the key or nullptr, see Settings::tryGet.
+  Variant const* tryGet(std::string_view key) const noexcept;
+  Variant const* tryGet(std::string_view key, std::uint64_t keyHash) const noexcept;
+
+  //! Extract a named enum, see Settings::getEnum.
+  template <typename NE, std::enable_if_t<std::is_enum_v<typename NE::EnumValues>, bool> = false>
+  NE getEnum() const
+  {
+    if (Variant const* v = tryGet(NE::getTypeInfo().name, NE::getEnumNameHash()))
+      return NE(*v);
+    return NE(Variant());
+  }
+
+  //! Extract a named parameter, see Settings::getParameter.
+  template <typename NP>
+  NP getParameter() const
+  {
+    if (Variant const* v = tryGet(NP::getParameterName(), NP::getParameterNameHash()))
+      return NP(*v);
+    return NP(Variant());
+  }
+
+  /*! \brief Merge all layers into a single Settings object.
+     *
+     * Keys keep the order of the lowest layer, keys only present in upper layers follow.
+     */
+  Settings materialize() const;
+
+  private:
+  std::vector<Settings> layers_;
+};
+
+}  // namespace DUTIL
+#endif  // DUTIL_SETTINGSVIEW_H
@@ -0,0 +1,269 @@
+#include "simd.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "exception.h"
+
+#if defined(D_GCC) && defined(__x86_64__)
+#define D_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace DUTIL {
+namespace SIMD {
+
+namespace {
+InstructionSet detectInstructionSet()
+{
+#ifdef D_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return InstructionSet::AVX2;
+  return InstructionSet::SSE2;
+#else
+  return InstructionSet::SCALAR;
+#endif
+}
+
+label_t supportedValue()
+{
+  static label_t const supported = detectInstructionSet();
+  return supported;
+}
+
+//! Value of the active instruction set, read on every kernel call.
+std::atomic<label_t>& activeValue()
+{
+  static std::atomic<label_t> active(supportedValue());
+  return active;
+}
+
+template <typename RESULT, typename INTERNAL>
+void convertScalar(INTERNAL const* src, RESULT* dst, std::size_t n)
+{
+  for (std::size_t i = 0; i < n; ++i) {
+    dst[i] = static_cast<RESULT>(src[i]);
+  }
+}
+
+//! Tell if the pair has a vector kernel, see convert.
+template <typename RESULT, typename INTERNAL>
+constexpr bool isVectorized()
+{
+  constexpr bool smallIntegerSource = std::is_same_v<INTERNAL, int8_t> || std::is_same_v<INTERNAL, uint8_t>
+                                      || std::is_same_v<INTERNAL, int16_t>
+                                      || std::is_same_v<INTERNAL, uint16_t>
+                                      || std::is_same_v<INTERNAL, int32_t>;
+  constexpr bool floatingResult = std::is_same_v<RESULT, float> || std::is_same_v<RESULT, double>;
+  constexpr bool floatingSource = std::is_same_v<INTERNAL, float> || std::is_same_v<INTERNAL, double>;
+  return (smallIntegerSource && floatingResult)
+         || (floatingSource && floatingResult && !std::is_same_v<RESULT, INTERNAL>)
+         || (floatingSource && std::is_same_v<RESULT, int32_t>);
+}
+
+#ifdef D_SIMD_X86
+// SSE2 kernels, 4 values per step. Integers are widened to 32 bit lanes before the conversion.
+
+inline __m128i load4AsInt32(int8_t const* p)
+{
+  std::int32_t bytes;
+  std::memcpy(&bytes, p, sizeof(bytes));
+  __m128i x = _mm_cvtsi32_si128(bytes);
+  x = _mm_unpacklo_epi8(x, x);
+  return _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 24);
+}
+
+inline __m128i load4AsInt32(uint8_t const* p)
+{
+  std::int32_t bytes;
+  std::memcpy(&bytes, p, sizeof(bytes));
+  __m128i const zero = _mm_setzero_si128();
+  return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero);
+}
+
+inline __m128i load4AsInt32(int16_t const* p)
+{
+  __m128i const x = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(p));
+  return _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+}
+
+inline __m128i load4AsInt32(uint16_t const* p)
+{
+  return _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(p)), _mm_setzero_si128());
+}
+
+inline __m128i load4AsInt32(int32_t const* p)
+{
+  return _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+}
+
+inline void store4(float* dst, __m128i x)
+{
+  _mm_storeu_ps(dst, _mm_cvtepi32_ps(x));
+}
+
+inline void store4(double* dst, __m128i x)
+{
+  _mm_storeu_pd(dst, _mm_cvtepi32_pd(x));
+  _mm_storeu_pd(dst + 2, _mm_cvtepi32_pd(_mm_shuffle_epi32(x, 0xEE)));
+}
+
+template <typename RESULT, typename INTERNAL>
+void convertSSE2(INTERNAL const* src, RESULT* dst, std::size_t n)
+{
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    if constexpr (std::is_same_v<INTERNAL, float> && std::is_same_v<RESULT, double>) {
+      __m128 const x = _mm_loadu_ps(src + i);
+      _mm_storeu_pd(dst + i, _mm_cvtps_pd(x));
+      _mm_storeu_pd(dst + i + 2, _mm_cvtps_pd(_mm_movehl_ps(x, x)));
+    } else if constexpr (std::is_same_v<INTERNAL, double> && std::is_same_v<RESULT, float>) {
+      __m128 const low = _mm_cvtpd_ps(_mm_loadu_pd(src + i));
+      __m128 const high = _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2));
+      _mm_storeu_ps(dst + i, _mm_movelh_ps(low, high));
+    } else if constexpr (std::is_same_v<INTERNAL, float>) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_cvttps_epi32(_mm_loadu_ps(src + i)));
+    } else if constexpr (std::is_same_v<INTERNAL, double>) {
+      __m128i const low = _mm_cvttpd_epi32(_mm_loadu_pd(src + i));
+      __m128i const high = _mm_cvttpd_epi32(_mm_loadu_pd(src + i + 2));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi64(low, high));
+    } else {
+      store4(dst + i, load4AsInt32(src + i));
+    }
+  }
+  convertScalar(src + i, dst + i, n - i);
+}
+
+// AVX2 kernels, 8 values per step. Compiled for AVX2 independent of the build flags and only
+// called after the processor support has been checked.
+#define D_AVX2 __attribute__((target("avx2")))
+
+D_AVX2 inline __m256i load8AsInt32(int8_t const* p)
+{
+  return _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(p)));
+}
+
+D_AVX2 inline __m256i load8AsInt32(uint8_t const* p)
+{
+  return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(p)));
+}
+
+D_AVX2 inline __m256i load8AsInt32(int16_t const* p)
+{
+  return _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(p)));
+}
+
+D_AVX2 inline __m256i load8AsInt32(uint16_t const* p)
+{
+  return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(p)));
+}
+
+D_AVX2 inline __m256i load8AsInt32(int32_t const* p)
+{
+  return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+}
+
+D_AVX2 inline void store8(float* dst, __m256i x)
+{
+  _mm256_storeu_ps(dst, _mm256_cvtepi32_ps(x));
+}
+
+D_AVX2 inline void store8(double* dst, __m256i x)
+{
+  _mm256_storeu_pd(dst, _mm256_cvtepi32_pd(_mm256_castsi256_si128(x)));
+  _mm256_storeu_pd(dst + 4, _mm256_cvtepi32_pd(_mm256_extracti128_si256(x, 1)));
+}
+
+template <typename RESULT, typename INTERNAL>
+D_AVX2 void convertAVX2(INTERNAL const* src, RESULT* dst, std::size_t n)
+{
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    if constexpr (std::is_same_v<INTERNAL, float> && std::is_same_v<RESULT, double>) {
+      _mm256_storeu_pd(dst + i, _mm256_cvtps_pd(_mm_loadu_ps(src + i)));
+      _mm256_storeu_pd(dst + i + 4, _mm256_cvtps_pd(_mm_loadu_ps(src + i + 4)));
+    } else if constexpr (std::is_same_v<INTERNAL, double> && std::is_same_v<RESULT, float>) {
+      _mm_storeu_ps(dst + i, _mm256_cvtpd_ps(_mm256_loadu_pd(src + i)));
+      _mm_storeu_ps(dst + i + 4, _mm256_cvtpd_ps(_mm256_loadu_pd(src + i + 4)));
+    } else if constexpr (std::is_same_v<INTERNAL, float>) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                          _mm256_cvttps_epi32(_mm256_loadu_ps(src + i)));
+    } else if constexpr (std::is_same_v<INTERNAL, double>) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm256_cvttpd_epi32(_mm256_loadu_pd(src + i)));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4),
+                       _mm256_cvttpd_epi32(_mm256_loadu_pd(src + i + 4)));
+    } else {
+      store8(dst + i, load8AsInt32(src + i));
+    }
+  }
+  convertSSE2(src + i, dst + i, n - i);
+}
+
+#undef D_AVX2
+#endif
+}  // namespace
+
+InstructionSet supportedInstructionSet()
+{
+  return InstructionSet(supportedValue());
+}
+
+InstructionSet activeInstructionSet()
+{
+  return InstructionSet(activeValue().load(std::memory_order_relaxed));
+}
+
+void setActiveInstructionSet(InstructionSet set)
+{
+  if (label_t(set) > supportedValue())
+    D_THROW("Instruction set " + set.toString() + " is not supported, the most capable one is "
+            + supportedInstructionSet().toString() + ".");
+  activeValue().store(set, std::memory_order_relaxed);
+}
+
+template <typename RESULT, typename INTERNAL>
+void convert(INTERNAL const* src, RESULT* dst, std::size_t n)
+{
+#ifdef D_SIMD_X86
+  if constexpr (isVectorized<RESULT, INTERNAL>()) {
+    label_t const active = activeValue().load(std::memory_order_relaxed);
+    if (active == InstructionSet::AVX2)
+      return convertAVX2(src, dst, n);
+    if (active == InstructionSet::SSE2)
+      return convertSSE2(src, dst, n);
+  }
+#endif
+  convertScalar(src, dst, n);
+}
+
+#define D_INSTANTIATE_CONVERT(RESULT)                                                 \
+  template void convert<RESULT, int8_t>(int8_t const*, RESULT*, std::size_t);         \
+  template void convert<RESULT, uint8_t>(uint8_t const*, RESULT*, std::size_t);       \
+  template void convert<RESULT, int16_t>(int16_t const*, RESULT*, std::size_t);       \
+  template void convert<RESULT, uint16_t>(uint16_t const*, RESULT*, std::size_t);     \
+  template void convert<RESULT, int32_t>(int32_t const*, RESULT*, std::size_t);       \
+  template void convert<RESULT, uint32_t>(uint32_t const*, RESULT*, std::size_t);     \
+  template void convert<RESULT, int64_t>(int64_t const*, RESULT*, std::size_t);       \
+  template void convert<RESULT, uint64_t>(uint64_t const*, RESULT*, std::size_t);     \
+  template void convert<RESULT, float>(float const*, RESULT*, std::size_t);           \
+  template void convert<RESULT, double>(double const*, RESULT*, std::size_t);
+
+D_INSTANTIATE_CONVERT(int8_t)
+D_INSTANTIATE_CONVERT(uint8_t)
+D_INSTANTIATE_CONVERT(int16_t)
+D_INSTANTIATE_CONVERT(uint16_t)
+D_INSTANTIATE_CONVERT(int32_t)
+D_INSTANTIATE_CONVERT(uint32_t)
+D_INSTANTIATE_CONVERT(int64_t)
+D_INSTANTIATE_CONVERT(uint64_t)
+D_INSTANTIATE_CONVERT(float)
+D_INSTANTIATE_CONVERT(double)
+#if defined(D_MINGW_MXE) || defined(D_MINGW_NATIVE) || defined(D_MSVC)
+// long has 32 bit here and is a distinct type from int32_t, see Dataset::getValuesLONG.
+D_INSTANTIATE_CONVERT(long)
+#endif
+#undef D_INSTANTIATE_CONVERT
+
+}  // namespace SIMD
+}  // namespace DUTIL
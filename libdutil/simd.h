@@ -0,0 +1,42 @@
+#ifndef DUTIL_SIMD_H
+#define DUTIL_SIMD_H
+#include <cstddef>
+#include "namedenum.h"
+
+namespace DUTIL {
+namespace SIMD {
+
+/*! \brief Instruction sets used by the vectorized kernels, ordered from the least to the most capable.
+ *
+ * SSE2 is part of every x86-64 processor, AVX2 is detected at runtime. Builds for other
+ * architectures or compilers only provide the SCALAR kernels.
+ */
+D_NAMED_ENUM(InstructionSet, SCALAR, SSE2, AVX2)
+
+//! Return the most capable instruction set supported by the processor and the build.
+InstructionSet supportedInstructionSet();
+
+//! Return the instruction set the kernels currently use, the supported one by default.
+InstructionSet activeInstructionSet();
+
+/*! \brief Restrict the kernels to the given instruction set, e.g. to compare kernels in benchmarks.
+ *
+ * Throws if the instruction set is not supported. The setting applies to all threads.
+ */
+void setActiveInstructionSet(InstructionSet set);
+
+/*! \brief Convert n values element-wise as with static_cast, dst[i] = RESULT(src[i]).
+ *
+ * Conversions of 8, 16 and 32 bit integers into float and double, between float and double and
+ * of float and double into 32 bit integers use the active instruction set. All other pairs, in
+ * particular 64 bit integers which have no vector conversion in SSE2 or AVX2, use a scalar loop.
+ *
+ * Implemented for all pairs of the fixed width integer types, float and double, on Windows builds
+ * also for long results. The ranges must not overlap.
+ */
+template <typename RESULT, typename INTERNAL>
+void convert(INTERNAL const* src, RESULT* dst, std::size_t n);
+
+}  // namespace SIMD
+}  // namespace DUTIL
+#endif  // DUTIL_SIMD_H
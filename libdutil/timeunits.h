@@ -1,5 +1,5 @@
-#ifndef DUTIL_TIME_H
-#define DUTIL_TIME_H
+#ifndef DUTIL_TIMEUNITS_H
+#define DUTIL_TIMEUNITS_H
 #include "basictypes.h"
 #include "namedenum.h"
 
@@ -33,4 +33,4 @@ static constexpr BasicTypes::real_t nanoByOne = 1e-09;
 }  // namespace TIME
 
 }  // namespace DUTIL
-#endif  // DUTIL_TIME_H
+#endif  // DUTIL_TIMEUNITS_H
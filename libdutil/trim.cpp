@@ -0,0 +1,44 @@
+#include "trim.h"
+#include <cctype>
+
+namespace DUTIL {
+namespace Utility {
+
+void trimThis(std::string &str)
+{
+    std::string_view const trimmed = trim(std::string_view(str));
+    std::size_t const begin = std::size_t(trimmed.data() - str.data());
+    str.erase(begin + trimmed.size());
+    str.erase(0, begin);
+}
+
+std::string trimMove(std::string &&str)
+{
+    trimThis(str);
+    return std::move(str);
+}
+
+std::string trim(std::string str)
+{
+    trimThis(str); // be careful, trimThis gets a local reference.
+    return str;
+}
+
+std::string trim(char const *str)
+{
+    return std::string(trim(std::string_view(str)));
+}
+
+std::string_view trim(std::string_view str) noexcept
+{
+    while (!str.empty() && std::isspace(static_cast<unsigned char>(str.front()))) {
+        str.remove_prefix(1);
+    }
+    while (!str.empty() && std::isspace(static_cast<unsigned char>(str.back()))) {
+        str.remove_suffix(1);
+    }
+    return str;
+}
+
+} // namespace Utility
+} // namespace DUTIL
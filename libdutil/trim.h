@@ -0,0 +1,34 @@
+#ifndef DUTIL_TRIM_H
+#define DUTIL_TRIM_H
+#include <string>
+#include <string_view>
+
+namespace DUTIL {
+namespace Utility {
+
+/*! \brief Remove leading and trailing whitespace characters from a string.
+ *
+ *  According to https://en.cppreference.com (std::isspace) whitespace characters are:
+ *  - space (0x20, ' ')
+ *  - form feed (0x0c, '\f')
+ *  - line feed (0x0a, '\n')
+ *  - carriage return (0x0d, '\r')
+ *  - horizontal tab (0x09, '\t')
+ *  - vertical tab (0x0b, '\v')
+ *
+ * The std::string_view overload returns a view into the argument and does not allocate, all other
+ * functions are built on it. String literals and other character pointers yield a std::string
+ * like std::string arguments do.
+ *
+ * \remarks trimThis trims in place. It is not an overload of trim taking std::string&, which
+ *          would be ambiguous with the overload taking std::string by value.
+ */
+void trimThis(std::string& str);
+std::string trimMove(std::string&& str);
+std::string trim(std::string str);
+std::string trim(char const* str);
+std::string_view trim(std::string_view str) noexcept;
+
+}  // namespace Utility
+}  // namespace DUTIL
+#endif  // DUTIL_TRIM_H
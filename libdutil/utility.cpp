@@ -18,17 +18,17 @@ void replaceDecimalSeperator(char const oldSep, char const newSep, std::string &
 std::string integerToString(int value) noexcept
 {
     // Largest number representable by a four byte int type is (2^31)-1 since one digit is reserved for the minus sign.
-    // That corresponds to a 11 digit number including the decimal point and possible minus sign.
-    std::array<char, 11> buffer{'\0'};
-    std::to_chars(buffer.begin(), buffer.end(), value);
-    return std::string(buffer.begin());
+    // That corresponds to a 11 digit number including the possible minus sign.
+    std::array<char, 11> buffer;
+    auto end = std::to_chars(buffer.begin(), buffer.end(), value).ptr;
+    return std::string(buffer.begin(), end);
 }
 
 std::string integerToString(std::int64_t value) noexcept
 {
-    std::array<char, 21> buffer{'\0'};
-    std::to_chars(buffer.begin(), buffer.end(), value);
-    return std::string(buffer.begin());
+    std::array<char, 20> buffer;
+    auto end = std::to_chars(buffer.begin(), buffer.end(), value).ptr;
+    return std::string(buffer.begin(), end);
 }
 
 std::string doubleToString(double value, int precision) noexcept
@@ -37,33 +37,11 @@ std::string doubleToString(double value, int precision) noexcept
         precision = 20;
         // hier eine log meldung
     }
-    // Two additional digits for decimal seperator and minus sign.
-    std::array<char, 22> buffer{'\0'};
-    std::to_chars(buffer.begin(), buffer.end(), value, std::chars_format::fixed, precision);
-    std::string num{buffer.begin()};
-    return num;
-}
-
-void trimThis(std::string &str)
-{
-    while (!str.empty() && std::isspace(str[0])) {
-        str.erase(str.begin());
-    }
-    while (!str.empty() && std::isspace(str[str.size() - 1])) {
-        str.pop_back();
-    }
-}
-
-std::string trimMove(std::string &&str)
-{
-    trimThis(str);
-    return std::move(str);
-}
-
-std::string trim(std::string str)
-{
-    trimThis(str); // be careful, trimThis gets a local reference.
-    return str;
+    // Fixed notation of the largest double has 309 digits, two additional characters for decimal seperator
+    // and minus sign.
+    std::array<char, 309 + 20 + 2> buffer;
+    auto end = std::to_chars(buffer.begin(), buffer.end(), value, std::chars_format::fixed, precision).ptr;
+    return std::string(buffer.begin(), end);
 }
 
 void trimZeros(std::string &str)
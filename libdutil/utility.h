@@ -3,9 +3,12 @@
 #include <cstdint>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include "basictypes.h"
+#include "conversion.h"
 #include "exception.h"
+#include "trim.h"
 
 namespace DUTIL {
 using namespace BasicTypes;
@@ -58,64 +61,38 @@ std::string arithmeticToString(T value, std::int8_t precision = 10) noexcept
 }
 
 /*! \brief Convert a std::string into an arithmetic type.
+ *
+ * The conversion is done by Conversion::fromChars, see conversion.h:
  *
  * 1. Target type is integer:
- *    Uses std::stoll and casting for conversion to T type.
+ *    Numbers in decimal or exponent notation are truncated towards zero.
  *
  * 2. Target type is unsidned integer:
- *    Uses std::stoull and casting for conversion to T type. If string
- *    number is negative, the minus sign gets removed ant number is treated
+ *    If string number is negative, the minus sign gets removed ant number is treated
  *    as an absolute values
  *
  * 3. Target type is double:
- *    Uses std::stod for conversion.
+ *    Decimal point and decimal comma are accepted, independently from std::locale settings.
  *
  * 4. Target type is bool:
  *    Retruns true if string is not empty, otherwise false.
  *
  * 5. Target type char:
- *    Conversion of string into char is not supported since it does not make sense.
- *    An exception is thrown in that case.
+ *    The string has to consist of exactly one character.
  *
  * Throws exections in the following cases:
- * i)   If target type T is char which is not supported by this function
- * ii)  If string contains an invalid value which is not convertible by the above functions.
- * iii) If the string number is out of range of the target type.
+ * i)   If string contains an invalid value which is not convertible by the above functions.
+ * ii)  If the string number is out of range of the target type.
+ * Use Conversion::fromChars directly for an exception-free conversion.
  */
 template <typename T, std::enable_if_t<std::is_arithmetic_v<T>, bool> = true>
-T stringToArithmetic(std::string& value)
+T stringToArithmetic(std::string_view value)
 {
-  Utility::replaceDecimalSeperator(',', '.', value);
-  try
-  {
-    if constexpr (is_integer_v<T>)
-    {
-      return static_cast<T>(std::stoll(value));
-    }
-    if constexpr (std::is_unsigned_v<T>)
-    {
-      if (value.front() == '-')
-        value.erase(value.begin());
-      return std::stoull(value);
-    }
-    if constexpr (std::is_same_v<T, double>)
-    {
-      return std::stod(value);
-    }
-    if constexpr (std::is_same_v<T, bool>)
-    {
-      return !value.empty();
-    }
-    D_ASSERT_MSG(false, "Unimplemented case!");
-  }
-  catch (std::invalid_argument const& ex)
-  {
-    D_THROW(ex.what());
-  }
-  catch (std::out_of_range const& ex)
-  {
-    D_THROW(ex.what());
-  }
+  auto result = Conversion::fromChars<T>(value);
+  if (!result.hasValue())
+    D_THROW("Conversion of '" + std::string(value)
+            + "' into an arithmetic type failed: " + Conversion::errorToString(result.error) + ".");
+  return result.value;
 }
 
 /*! \brief Convert a wchar_t array into a std::string.
@@ -156,17 +133,19 @@ std::string toString(T value)
  * Shortcut function for other strintTo... functions specified here.
  *
  * 1. Arithmetic types int, uint, double, bool and char are converted according
- *    to stringToArithmetic fucntion.
+ *    to stringToArithmetic fucntion. Instead of throwing, the first entry of the returned
+ *    pair is false if the conversion failed.
  * 2. If target type is std::string just return the input value.
  *
  * 3. Other types not implemented yet
  */
 template <typename T>
-std::pair<bool, T> fromString(std::string& value)
+std::pair<bool, T> fromString(std::string_view value)
 {
   if constexpr (std::is_arithmetic_v<T>)
   {
-    return std::make_pair(true, stringToArithmetic<T>(value));
+    auto result = Conversion::fromChars<T>(value);
+    return std::make_pair(result.hasValue(), result.value);
   }
   else if constexpr (std::is_same_v<T, std::string>)
   {
@@ -175,24 +154,6 @@ std::pair<bool, T> fromString(std::string& value)
   D_ASSERT_MSG(false, "Unimplemented case!");
 }
 
-/*! \brief Remove leading and trailing whitespace characters from a string.
- *
- *  According to https://en.cppreference.com (std::isspace) whitespace characters are:
- *  - space (0x20, ' ')
- *  - form feed (0x0c, '\f')
- *  - line feed (0x0a, '\n')
- *  - carriage return (0x0d, '\r')
- *  - horizontal tab (0x09, '\t')
- *  - vertical tab (0x0b, '\v')
- *
- * \remarks Since overloading trim with paramter std::string and std::string&
- *          might have some dangerous side effects this funciotn is named
- *          trimThis
- */
-void trimThis(std::string& str);
-std::string trimMove(std::string&& str);
-std::string trim(std::string str);
-
 /*! \brief Remove trailing zero characters from a string.
  *
  * For example:
@@ -1,15 +1,196 @@
 #include "variant.h"
 #include "exception.h"
-#include <tuple>
+#include "hash.h"
+#include "serialization.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
 
 namespace DUTIL {
 using namespace DUTIL::VariantDetail;
 
 Variant::Variant() :
-    var_(std::monostate()),
-    type_(Type::MONOSTATE)
+    data_(),
+    size_(0),
+    tag_(Type::MONOSTATE)
 {}
 
+Variant::Variant(allocator_type const &alloc) :
+    Variant()
+{
+    bind(alloc.resource());
+}
+
+Variant::Variant(Variant const &other) :
+    Variant()
+{
+    assignValue(other);
+}
+
+Variant::Variant(Variant &&other) noexcept :
+    Variant()
+{
+    // Heap buffers change their owner, the moved-from object becomes empty.
+    copyRepresentation(other);
+    other.size_ = 0;
+    other.tag_ = Type::MONOSTATE;
+}
+
+Variant::Variant(Variant const &other, allocator_type const &alloc) :
+    Variant(alloc)
+{
+    assignValue(other);
+}
+
+Variant::Variant(Variant &&other, allocator_type const &alloc) :
+    Variant()
+{
+    // A variant bound to the same resource hands over its Binding instead of allocating a new one.
+    if (other.isBound() && other.binding().resource->is_equal(*alloc.resource())) {
+        copyRepresentation(other);
+        other.size_ = 0;
+        other.tag_ = Type::MONOSTATE;
+        return;
+    }
+    bind(alloc.resource());
+    *this = std::move(other);
+}
+
+Variant &Variant::operator=(Variant const &other)
+{
+    if (this != &other)
+        assignValue(other);
+    return *this;
+}
+
+Variant &Variant::operator=(Variant &&other)
+{
+    if (this == &other)
+        return *this;
+    // Only a value living in our memory resource may change its owner, all others are copied.
+    std::pmr::memory_resource *const resource = isBound() ? binding().resource
+                                                          : std::pmr::get_default_resource();
+    if (isBound() != other.isBound() || !other.allocationResource()->is_equal(*resource)) {
+        assignValue(other);
+        return *this;
+    }
+    release();
+    copyRepresentation(other);
+    other.size_ = 0;
+    other.tag_ = Type::MONOSTATE;
+    return *this;
+}
+
+Variant::~Variant()
+{
+    release();
+}
+
+void Variant::setString(std::string_view str, std::pmr::memory_resource *resource)
+{
+    if (str.size() <= inlineStringCapacity) {
+        reset();
+        std::memcpy(data_, str.data(), str.size());
+        size_ = static_cast<std::uint8_t>(str.size());
+    } else {
+        if (str.size() > std::numeric_limits<std::uint32_t>::max())
+            D_THROW("string with " + Utility::toString(std::uint64_t(str.size()))
+                    + " characters is too long to be stored in a Variant.");
+        // The buffer starts with the memory resource which is needed to release it again.
+        // It is obtained before the old value is released, which keeps the value if allocation fails.
+        auto *block = static_cast<char *>(
+            resource->allocate(heapHeaderSize + str.size(), alignof(std::pmr::memory_resource *)));
+        reset();
+        std::memcpy(block, &resource, heapHeaderSize);
+        char *buffer = block + heapHeaderSize;
+        std::memcpy(buffer, str.data(), str.size());
+        auto length = static_cast<std::uint32_t>(str.size());
+        ::new (static_cast<void *>(data_)) char *(buffer);
+        std::memcpy(data_ + heapSizeOffset, &length, sizeof(length));
+        size_ = heapStringMarker;
+    }
+    tag_ = Type::STRING;
+}
+
+void Variant::copyRepresentation(Variant const &other) noexcept
+{
+    std::memcpy(data_, other.data_, sizeof(data_));
+    size_ = other.size_;
+    tag_ = other.tag_;
+}
+
+void Variant::bind(std::pmr::memory_resource *resource)
+{
+    if (resource->is_equal(*std::pmr::get_default_resource()))
+        return;
+    auto *block = static_cast<Binding *>(resource->allocate(sizeof(Binding), alignof(Binding)));
+    ::new (static_cast<void *>(block)) Binding{resource, Variant()};
+    ::new (static_cast<void *>(data_)) Binding *(block);
+    size_ = boundMarker;
+    tag_ = Type::MONOSTATE;
+}
+
+std::pmr::memory_resource *Variant::allocationResource() const noexcept
+{
+    if (isBound())
+        return binding().resource;
+    return hasHeapString() ? memoryResource() : std::pmr::get_default_resource();
+}
+
+void Variant::assignValue(Variant const &other)
+{
+    Variant const &source = other.content();
+    Variant &target = content();
+    if (source.hasHeapString())
+        target.setString(source.stringView(),
+                         isBound() ? binding().resource : std::pmr::get_default_resource());
+    else {
+        target.reset();
+        target.copyRepresentation(source);
+    }
+    tag_ = target.tag_;
+}
+
+void Variant::release() noexcept
+{
+    if (isBound()) {
+        Binding *block = &binding();
+        std::pmr::memory_resource *resource = block->resource;
+        block->~Binding();
+        resource->deallocate(block, sizeof(Binding), alignof(Binding));
+        size_ = 0;
+        tag_ = Type::MONOSTATE;
+    } else
+        reset();
+}
+
+void Variant::reset() noexcept
+{
+    if (isBound()) {
+        binding().value.reset();
+        tag_ = Type::MONOSTATE;
+        return;
+    }
+    if (hasHeapString()) {
+        char *block = ref<char *>() - heapHeaderSize;
+        memoryResource()->deallocate(block, heapHeaderSize + stringView().size(),
+                                     alignof(std::pmr::memory_resource *));
+    }
+    size_ = 0;
+    tag_ = Type::MONOSTATE;
+}
+
+std::pmr::memory_resource *Variant::memoryResource() const noexcept
+{
+    if (isBound())
+        return binding().resource;
+    if (!hasHeapString())
+        return nullptr;
+    std::pmr::memory_resource *resource;
+    std::memcpy(&resource, ref<char *>() - heapHeaderSize, heapHeaderSize);
+    return resource;
+}
+
 bool Variant::isNumeric(Type t)
 {
     return t >= Type::LABEL && t <= Type::DOUBLE;
@@ -17,44 +198,86 @@ bool Variant::isNumeric(Type t)
 
 Variant::Type Variant::getType() const
 {
-    return type_;
+    // Constructing a named enum object validates its value, pick a prevalidated copy instead.
+    static Type const types[] = {Type::MONOSTATE,
+                                 Type::LABEL,
+                                 Type::INT64,
+                                 Type::UINT64,
+                                 Type::DOUBLE,
+                                 Type::BOOL,
+                                 Type::CHAR,
+                                 Type::STRING,
+                                 Type::ENUM};
+    return types[tag_];
 }
 
 bool Variant::isValid() const
 {
-    return type_ > Type::MONOSTATE;
+    return tag_ > Type::MONOSTATE;
 }
 
 bool Variant::isMonostate() const
 {
-    return type_ == Type::MONOSTATE;
+    return tag_ == Type::MONOSTATE;
 }
 
 bool Variant::isString() const
 {
-    return type_ == Type::STRING;
+    return tag_ == Type::STRING;
+}
+
+bool Variant::isEnum() const
+{
+    return tag_ == Type::ENUM;
+}
+
+NamedEnumDetail::EnumTypeInfo const *Variant::enumTypeInfo() const noexcept
+{
+    if (tag_ != Type::ENUM)
+        return nullptr;
+    return ref<NamedEnumDetail::EnumTypeInfo const *>();
+}
+
+std::uint32_t Variant::enumOrdinal() const noexcept
+{
+    std::uint32_t ordinal;
+    std::memcpy(&ordinal, content().data_ + enumOrdinalOffset, sizeof(ordinal));
+    return ordinal;
 }
 
 bool Variant::isNumeric() const
 {
-    return type_ >= Type::LABEL && type_ <= Type::DOUBLE;
+    return tag_ >= Type::LABEL && tag_ <= Type::DOUBLE;
 }
 
 bool Variant::isCharacter() const
 {
-    return type_ == Type::CHAR;
+    return tag_ == Type::CHAR;
 }
 
 bool Variant::isBool() const
 {
-    return type_ == Type::BOOL;
+    return tag_ == Type::BOOL;
+}
+
+std::string_view Variant::asStringView() const
+{
+    if (tag_ == Type::ENUM)
+        return enumName();
+    if (tag_ != Type::STRING)
+        D_THROW("Variant holding type '" + getType().toString() + "' does not hold a std::string.");
+    return stringView();
 }
 
 std::string Variant::toString() const
 {
+    if (tag_ == Type::STRING)
+        return std::string(stringView());
+    if (tag_ == Type::ENUM)
+        return std::string(enumName());
     auto result = getAs<std::string>();
     if (!result.first)
-        D_THROW("Variant holding type '" + type_.toString() + "' is not convertible into std::string.");
+        D_THROW("Variant holding type '" + getType().toString() + "' is not convertible into std::string.");
     return result.second;
 }
 
@@ -62,7 +285,7 @@ bool Variant::toBool() const
 {
     auto result = getAs<bool>();
     if (!result.first)
-        D_THROW("Variant holding type '" + type_.toString() + "' is not convertible into bool.");
+        D_THROW("Variant holding type '" + getType().toString() + "' is not convertible into bool.");
     return result.second;
 }
 
@@ -70,7 +293,7 @@ label_t Variant::toLabel() const
 {
     auto result = getAs<label_t>();
     if (!result.first)
-        D_THROW("Variant holding type '" + type_.toString() + "' is not convertible into lable_t alias int.");
+        D_THROW("Variant holding type '" + getType().toString() + "' is not convertible into lable_t alias int.");
     return result.second;
 }
 
@@ -78,66 +301,159 @@ real_t Variant::toReal() const
 {
     auto result = getAs<real_t>();
     if (!result.first)
-        D_THROW("Variant holding type '" + type_.toString() + "' is not convertible into real_t alias double.");
+        D_THROW("Variant holding type '" + getType().toString() + "' is not convertible into real_t alias double.");
     return result.second;
 }
 
+namespace {
+template <typename T>
+void convertArithmetic(Variant &v)
+{
+    auto result = v.convert<T>();
+    if (result.hasValue())
+        v = Variant(result.value);
+}
+} // namespace
+
 Variant &Variant::convertTo(Type t)
 {
     switch (t) {
-    case Type::MONOSTATE: {
-        DutilVariant v = DutilVariant();
-        var_.swap(v);
+    case Type::MONOSTATE:
+        reset();
         break;
-    }
-    case Type::LABEL: {
-        auto result = getAs<label_t>();
-        if (result.first)
-            var_ = result.second;
+    case Type::LABEL:
+        convertArithmetic<label_t>(*this);
         break;
-    }
-    case Type::INT64: {
-        auto result = getAs<std::int64_t>();
-        if (result.first)
-            var_ = result.second;
+    case Type::INT64:
+        convertArithmetic<std::int64_t>(*this);
         break;
-    }
-    case Type::UINT64: {
-        auto result = getAs<std::uint64_t>();
-        if (result.first)
-            var_ = result.second;
+    case Type::UINT64:
+        convertArithmetic<std::uint64_t>(*this);
         break;
-    }
-    case Type::DOUBLE: {
-        auto result = getAs<real_t>();
-        if (result.first)
-            var_ = result.second;
+    case Type::DOUBLE:
+        convertArithmetic<real_t>(*this);
         break;
-    }
-    case Type::CHAR: {
-        auto result = getAs<char>();
-        if (result.first)
-            var_ = result.second;
+    case Type::BOOL:
+        convertArithmetic<bool>(*this);
+        break;
+    case Type::CHAR:
+        convertArithmetic<char>(*this);
         break;
-    }
     case Type::STRING: {
         auto result = getAs<std::string>();
         if (result.first)
-            var_ = result.second;
+            *this = Variant(result.second);
         break;
     }
+    case Type::ENUM:
+        // The enum type cannot be deduced from Type::ENUM alone, the value stays unchanged.
+        break;
     }
-    type_ = t;
     return *this;
 }
 
+void Variant::serialize(BinaryWriter &writer) const
+{
+    writer.writeByte(tag_);
+    if (tag_ == Type::ENUM) {
+        writer.writeString(enumTypeInfo()->name);
+        writer.writeString(enumName());
+        return;
+    }
+    visit(Overload{[](std::monostate) {},
+                   [&writer](std::string_view value) { writer.writeString(value); },
+                   [&writer](double const &value) { writer.writeDouble(value); },
+                   [&writer](bool const &value) { writer.writeByte(value); },
+                   [&writer](char const &value) { writer.writeByte(static_cast<std::uint8_t>(value)); },
+                   [&writer](std::uint64_t const &value) { writer.writeVarint(value); },
+                   [&writer](auto const &value) { writer.writeSignedVarint(value); }});
+}
+
+Variant Variant::deserialize(BinaryReader &reader, allocator_type const &alloc)
+{
+    Variant v(alloc);
+    Variant &target = v.content();
+    auto const tag = reader.readByte();
+    switch (tag) {
+    case Type::MONOSTATE:
+        return v;
+    case Type::LABEL: {
+        auto value = Conversion::numericCast<label_t>(reader.readSignedVarint());
+        if (!value.ok())
+            D_THROW("Binary data holds a label value which is out of range.");
+        target.setArithmetic(value.value);
+        break;
+    }
+    case Type::INT64:
+        target.setArithmetic(reader.readSignedVarint());
+        break;
+    case Type::UINT64:
+        target.setArithmetic(reader.readVarint());
+        break;
+    case Type::DOUBLE:
+        target.setArithmetic(reader.readDouble());
+        break;
+    case Type::BOOL:
+        target.setArithmetic(reader.readByte() != 0);
+        break;
+    case Type::CHAR:
+        target.setArithmetic(static_cast<char>(reader.readByte()));
+        break;
+    case Type::STRING:
+        target.setString(reader.readString(), v.allocationResource());
+        break;
+    case Type::ENUM: {
+        auto const typeName = reader.readString();
+        auto const valueName = reader.readString();
+        if (auto const *info = NamedEnumDetail::findEnumType(typeName)) {
+            auto const &names = info->valueNames;
+            auto it = std::find(names.cbegin(), names.cend(), valueName);
+            if (it != names.cend()) {
+                target.setEnum(*info, static_cast<std::uint32_t>(it - names.cbegin()));
+                break;
+            }
+        }
+        // Unknown or ambiguous enum types are restored by name, named enums can be constructed from strings.
+        target.setString(valueName, v.allocationResource());
+        break;
+    }
+    default:
+        D_THROW("Binary data holds an unknown variant type tag '" + Utility::toString(label_t(tag)) + "'.");
+    }
+    v.tag_ = target.tag_;
+    return v;
+}
+
+namespace {
+//! Tell if the variant holds a string or a named enum, which compare by name.
+bool holdsName(Variant const &v)
+{
+    return v.isString() || v.isEnum();
+}
+} // namespace
+
 bool operator==(Variant const &lhs, Variant const &rhs)
 {
-    // create std::tie objects for lhs-ref and rhs-ref and use std::tuple's
-    // lexicographical operators
-    auto lhsType = lhs.getType();
-    auto rhsType = rhs.getType();
-    return (std::tie(lhsType, lhs.get()) == std::tie(rhsType, rhs.get()));
+    if (lhs.tag_ == Variant::Type::ENUM || rhs.tag_ == Variant::Type::ENUM) {
+        // values of the same enum type by ordinal, all others by name as if both were strings
+        if (lhs.tag_ == rhs.tag_ && lhs.enumTypeInfo() == rhs.enumTypeInfo())
+            return lhs.enumOrdinal() == rhs.enumOrdinal();
+        return holdsName(lhs) && holdsName(rhs) && lhs.asStringView() == rhs.asStringView();
+    }
+    if (lhs.tag_ != rhs.tag_)
+        return false;
+    return lhs.visit([&rhs](auto const &value) {
+        using T = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, std::monostate>)
+            return true;
+        else if constexpr (std::is_same_v<T, std::string_view>)
+            return value == rhs.stringView();
+        else if constexpr (std::is_floating_point_v<T>)
+            // all NaNs are equal, as in the total order
+            return value == rhs.ref<T>() || (value != value && rhs.ref<T>() != rhs.ref<T>());
+        else
+            return value == rhs.ref<T>();
+    });
 }
 
 bool operator!=(Variant const &lhs, Variant const &rhs)
@@ -145,8 +461,85 @@ bool operator!=(Variant const &lhs, Variant const &rhs)
     return !(lhs == rhs);
 }
 
-Variant::DutilVariant const &Variant::get() const
+namespace {
+//! Three-way comparison of values of the same type, see operator<.
+template <typename T>
+int compareValues(T const &lhs, T const &rhs)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        bool const lhsNan = lhs != lhs;
+        bool const rhsNan = rhs != rhs;
+        if (lhsNan || rhsNan)
+            return int(lhsNan) - int(rhsNan);
+    }
+    if (lhs < rhs)
+        return -1;
+    if (rhs < lhs)
+        return 1;
+    return 0;
+}
+} // namespace
+
+int Variant::compare(Variant const &other) const
+{
+    // named enums take the place of strings in the order of types and are ordered by name
+    std::uint8_t const lhsTag = tag_ == Type::ENUM ? std::uint8_t(Type::STRING) : tag_;
+    std::uint8_t const rhsTag = other.tag_ == Type::ENUM ? std::uint8_t(Type::STRING) : other.tag_;
+    if (lhsTag != rhsTag)
+        return lhsTag < rhsTag ? -1 : 1;
+    if (lhsTag == Type::STRING)
+        return compareValues(asStringView(), other.asStringView());
+    return visit([&other](auto const &value) {
+        using T = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, std::monostate>)
+            return 0;
+        else if constexpr (std::is_same_v<T, std::string_view>)
+            return compareValues(value, other.stringView());
+        else
+            return compareValues(value, other.ref<T>());
+    });
+}
+
+bool operator<(Variant const &lhs, Variant const &rhs)
+{
+    return lhs.compare(rhs) < 0;
+}
+
+bool operator>(Variant const &lhs, Variant const &rhs)
+{
+    return lhs.compare(rhs) > 0;
+}
+
+bool operator<=(Variant const &lhs, Variant const &rhs)
+{
+    return lhs.compare(rhs) <= 0;
+}
+
+bool operator>=(Variant const &lhs, Variant const &rhs)
+{
+    return lhs.compare(rhs) >= 0;
+}
+
+std::size_t Variant::hash() const noexcept
 {
-    return var_;
+    // named enums equal strings holding their name and are hashed like them
+    if (tag_ == Type::ENUM)
+        return Hash::combine(Hash::mix(Type::STRING), std::hash<std::string_view>()(enumName()));
+    std::uint64_t const seed = Hash::mix(tag_);
+    return visit(Overload{[seed](std::monostate) { return seed; },
+                          [seed](std::string_view value) {
+                              return Hash::combine(seed, std::hash<std::string_view>()(value));
+                          },
+                          [seed](double const &value) {
+                              // 0.0 and -0.0 as well as all NaNs compare equal and need the same hash
+                              double const normalized = value == 0.0 ? 0.0
+                                                        : value != value
+                                                            ? std::numeric_limits<double>::quiet_NaN()
+                                                            : value;
+                              std::uint64_t bits;
+                              std::memcpy(&bits, &normalized, sizeof(bits));
+                              return Hash::combine(seed, bits);
+                          },
+                          [seed](auto const &value) { return Hash::combine(seed, std::uint64_t(value)); }});
 }
 } // namespace DUTIL
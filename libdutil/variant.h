@@ -1,15 +1,24 @@
 #ifndef DUTIL_VARIANT_H
 #define DUTIL_VARIANT_H
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <new>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <variant>
 #include "basictypes.h"
+#include "conversion.h"
 #include "namedenum.h"
 #include "overload.h"
 #include "utility.h"
 
 namespace DUTIL {
+class BinaryReader;
+class BinaryWriter;
+
 namespace VariantDetail {
 template <typename T>
 struct is_allowed_arithmetic_type :
@@ -31,7 +40,7 @@ template <typename T>
 constexpr bool is_allowed_type_v = is_allowed_type<T>::value;
 }  // namespace VariantDetail
 
-/*! \brief A standard variant limited to a special set of types.
+/*! \brief A compact variant limited to a special set of types.
  *
  *  The allowed types are:
  *  - std::monostate as the default type
@@ -39,52 +48,85 @@ constexpr bool is_allowed_type_v = is_allowed_type<T>::value;
  *  - double
  *  - bool
  *  - char and std::string´
+ *  - named enums, see D_NAMED_ENUM
  *
  * Longer description of Variant.
  * The reason why label_t type alias int is listed is because it can be useful.
  * We only support std::uint64_t and no smaller uints since it uint should only be used if
  * the sign bit is needed for very large numbers where std::int64_t is not sufficient.
+ *
+ * Memory layout:
+ * A Variant object occupies 16 bytes. The last byte holds the type tag, the byte in front of it
+ * the length of an inline string. Arithmetic values are stored in the first eight bytes.
+ * Strings with up to 'inlineStringCapacity' characters are stored inside the object itself,
+ * longer strings are stored in a heap buffer whose pointer and length occupy the first twelve bytes.
+ * Heap buffers are obtained from a std::pmr::memory_resource which is recorded in front of the
+ * characters. A variant bound to another resource than the default one keeps its value in a block
+ * obtained from that resource instead, see allocator_type.
+ * Named enums are stored as a pointer to the description of their type, see NamedEnumDetail::EnumTypeInfo,
+ * followed by the ordinal of the value. Their names are only looked up when they are requested.
+ * Hence, copying a Variant which does not hold a long string never touches the heap.
  */
 
 class Variant
 {
   public:
   //! List of allowed types.
-  D_NAMED_ENUM(Type, MONOSTATE, LABEL, INT64, UINT64, DOUBLE, BOOL, CHAR, STRING)
+  D_NAMED_ENUM(Type, MONOSTATE, LABEL, INT64, UINT64, DOUBLE, BOOL, CHAR, STRING, ENUM)
 
-  using DutilVariant = std::variant<std::monostate, label_t, std::int64_t, std::uint64_t, double,
-                                    bool, char, std::string>;
+  //! Maximal number of characters of a string stored without heap allocation.
+  static constexpr std::size_t inlineStringCapacity = 14;
+
+  /*! \brief Allocator type, makes Variant usable in std::pmr containers.
+     *
+     * There is no room for an allocator in the 16 bytes of a variant. Constructors taking an allocator
+     * whose resource differs from std::pmr::get_default_resource() therefore bind the variant to it:
+     * the value moves into a small block obtained from the resource, which also records the resource.
+     * All other variants use the default resource, the heap buffer of a long string records it.
+     * Follows the usual std::pmr rules: copy construction uses the default resource, move construction
+     * keeps the resource and assignments never change it. Moving between different resources copies.
+     * Containers like std::pmr::vector<Variant> pass their allocator on to the variants they hold.
+     */
+  using allocator_type = std::pmr::polymorphic_allocator<char>;
 
   //! Default construct empty variant, current variant type is std::monostate.
   explicit Variant();
 
+  //! Construct an empty variant bound to the allocator's memory resource.
+  explicit Variant(allocator_type const& alloc);
+
   //! Constructor with initial value for variant and type.
   template <typename InitialType,
             std::enable_if_t<VariantDetail::is_allowed_type_v<InitialType>, bool> = true>
-  explicit Variant(InitialType const value) :
-      var_(value),
-      type_()
+  explicit Variant(InitialType const& value) :
+      Variant()
   {
-    if constexpr (std::is_same_v<InitialType, std::int64_t>)
-      type_ = Type::INT64;
-    else if constexpr (std::is_same_v<InitialType, label_t>)
-      type_ = Type::LABEL;
-    else if constexpr (std::is_same_v<InitialType, std::uint64_t>)
-      type_ = Type::UINT64;
-    else if constexpr (std::is_same_v<InitialType, double>)
-      type_ = Type::DOUBLE;
-    else if constexpr (std::is_same_v<InitialType, bool>)
-      type_ = Type::BOOL;
-    else if constexpr (std::is_same_v<InitialType, char>)
-      type_ = Type::CHAR;
-    else
-      type_ = Type::STRING;
+    if constexpr (BasicTypes::is_string_v<InitialType>)
+      setString(std::string_view(value));
+    else if constexpr (!std::is_same_v<InitialType, std::monostate>)
+      setArithmetic(value);
+  }
+
+  //! Constructor with initial value bound to the allocator's memory resource.
+  template <typename InitialType,
+            std::enable_if_t<VariantDetail::is_allowed_type_v<InitialType>, bool> = true>
+  Variant(InitialType const& value, allocator_type const& alloc) :
+      Variant(alloc)
+  {
+    Variant& target = content();
+    if constexpr (BasicTypes::is_string_v<InitialType>)
+      target.setString(std::string_view(value), alloc.resource());
+    else if constexpr (!std::is_same_v<InitialType, std::monostate>)
+      target.setArithmetic(value);
+    tag_ = target.tag_;
   }
 
   /*! \brief Construct from a D_NAMED_ENUM object.
      *
-     * The named enum is stored in the variant using the enum's string representation. That is, internally,
-     * a named enum is acutally a string value. Use these two constructors as follows:
+     * The named enum is stored as Type::ENUM, i.e. as its enum type and ordinal, which neither allocates
+     * nor looks up the enum's string representation. Wherever a string is expected, e.g. by toString,
+     * getAs or visit, the variant behaves like a string holding the enum value's name.
+     * Use these two constructors as follows:
      *
      * D_NAMED_ENUM(COLOR, RED, BLUE, GREEN);
      * Variant v1 {COLOR::RED}; // from named enum value (NEV)
@@ -95,14 +137,37 @@ class Variant
      */
   template <typename NE, std::enable_if_t<std::is_enum_v<typename NE::EnumValues>, int> = true>
   explicit Variant(NE const& ne) :
-      Variant(ne.toString())
-  {}
+      Variant()
+  {
+    setEnum(NE::getTypeInfo(), ne.ordinal());
+  }
 
   template <typename NEV, typename std::enable_if_t<std::is_enum_v<NEV>, int> = true>
   explicit Variant(NEV const& nev) :
       Variant(fromEnumValue(nev))
   {}
 
+  //! Copy and move operations, only long strings require special treatment.
+  Variant(Variant const& other);
+  Variant(Variant&& other) noexcept;
+  Variant& operator=(Variant const& other);
+  Variant& operator=(Variant&& other);
+  ~Variant();
+
+  /*! \brief Copy and move construction binding the variant to the allocator's memory resource.
+     *
+     * Moving takes over the value of 'other' only if it uses an equal memory resource.
+     */
+  Variant(Variant const& other, allocator_type const& alloc);
+  Variant(Variant&& other, allocator_type const& alloc);
+
+  /*! \brief Return the memory resource the variant is bound to.
+     *
+     * For unbound variants, the memory resource of the heap buffer of a long string is returned or nullptr
+     * if there is none.
+     */
+  std::pmr::memory_resource* memoryResource() const noexcept;
+
   //! Check if a Variant::Type value represents a numeric type.
   static bool isNumeric(Type t);
 
@@ -118,6 +183,15 @@ class Variant
   //! Tells if the variant holds std::string type.
   bool isString() const;
 
+  //! Tells if the variant holds a named enum.
+  bool isEnum() const;
+
+  //! Return the type description of the stored named enum or nullptr if the variant holds another type.
+  NamedEnumDetail::EnumTypeInfo const* enumTypeInfo() const noexcept;
+
+  //! Return the ordinal of the stored named enum, only meaningful if isEnum() is true.
+  std::uint32_t enumOrdinal() const noexcept;
+
   //! Tells if the variant holds s numeric type, i.e. label_t, std::int64_t, std::uint64_t or double.
   bool isNumeric() const;
 
@@ -139,79 +213,333 @@ class Variant
   std::pair<bool, T> getAs() const
   {
     std::pair<bool, T> result;
-    std::visit(Overload{[&result](auto arg) {
-                          using VariantType = std::decay_t<decltype(arg)>;
-                          if constexpr (std::is_unsigned_v<T> && !std::is_unsigned_v<VariantType>) {
-                            if (arg < 0) {  // change sign
-                              arg *= -1;
-                            }
+    visit(Overload{[&result](auto arg) {
+                        using VariantType = std::decay_t<decltype(arg)>;
+                        if constexpr (std::is_unsigned_v<T> && !std::is_unsigned_v<VariantType>) {
+                          if (arg < 0) {  // change sign
+                            arg *= -1;
                           }
-                          if constexpr (std::is_arithmetic_v<T>) {
-                            // both types T and VariantType are arithmetic
-                            result.first = std::is_convertible_v<VariantType, T>;
-                            if (result.first) {
-                              result.second = static_cast<T>(arg);
-                              return;
-                            }
-                            result.second = T(0);
-                          } else {  // Target type T is string and variant type is arithmetic
-                            result.second = Utility::toString(arg);
-                            result.first = true;
-                            if (result.second.empty())
-                              result.first = false;
+                        }
+                        if constexpr (std::is_arithmetic_v<T>) {
+                          // both types T and VariantType are arithmetic
+                          result.first = std::is_convertible_v<VariantType, T>;
+                          if (result.first) {
+                            result.second = static_cast<T>(arg);
+                            return;
                           }
-                        },
-                        [&result](std::string arg) {  // try to convert string into arithmetic type
-                          result = Utility::fromString<T>(arg);
-                        },
-                        [&result](std::monostate) {
-                          result.first = false;
-                          result.second = T();
-                        }},
-               var_);
+                          result.second = T(0);
+                        } else {  // Target type T is string and variant type is arithmetic
+                          result.second = Utility::toString(arg);
+                          result.first = true;
+                          if (result.second.empty())
+                            result.first = false;
+                        }
+                      },
+                      [&result](std::string_view arg) {  // try to convert string into arithmetic type
+                        if constexpr (std::is_same_v<T, std::string>) {
+                          result = std::make_pair(true, std::string(arg));
+                        } else {
+                          auto converted = Conversion::fromChars<T>(arg);
+                          result = std::make_pair(converted.hasValue(), converted.value);
+                        }
+                      },
+                      [&result](std::monostate) {
+                        result.first = false;
+                        result.second = T();
+                      }});
 
     return result;
   }
 
+  /*! \brief Convert the stored value into an arithmetic type and report conversion errors.
+     *
+     * Strings are parsed by Conversion::fromChars, arithmetic values are range checked by
+     * Conversion::numericCast. Unlike getAs, this function never throws and reports values
+     * which do not fit into T as ConversionError::OUT_OF_RANGE. An empty variant yields
+     * ConversionError::INVALID.
+     */
+  template <typename T,
+            std::enable_if_t<VariantDetail::is_allowed_arithmetic_type_v<T>
+                                 && !std::is_same_v<T, std::monostate>,
+                             bool> = true>
+  ConversionResult<T> convert() const noexcept
+  {
+    return visit(Overload{[](std::string_view arg) { return Conversion::fromChars<T>(arg); },
+                          [](std::monostate) {
+                            return ConversionResult<T>{T(), ConversionError::INVALID};
+                          },
+                          [](auto const& arg) { return Conversion::numericCast<T>(arg); }});
+  }
+
   /*! \brief Convert the Variant type value into another one.
      *
      * For example convert
      * Variant with type_ = Type::DOUBLE into Variant with type_ = Type::STRING.
      *
-     * This function basically uses the Variant::getAs function.
-     * If the conversion is not feasible, the Variant objects stays unchanged.
+     * Conversions into arithmetic types use Variant::convert, a loss of precision is accepted.
+     * If the conversion is not feasible, i.e. the value is invalid or out of range for the new type,
+     * the Variant objects stays unchanged.
      */
   Variant& convertTo(Type t);
 
+  /*! \brief Binary serialization, see BinaryWriter for the encoding.
+     *
+     * A variant is written as its type tag followed by the value: integers as (zigzag) varints,
+     * doubles as raw IEEE bytes, bool and char as a single byte and strings length-prefixed.
+     * Named enums are written as the names of their type and value. Deserialization restores them
+     * as Type::ENUM if the enum type has already been used in this process and its name is unique,
+     * otherwise as a string.
+     * Deserializing a string with up to 'inlineStringCapacity' characters does not allocate.
+     */
+  void serialize(BinaryWriter& writer) const;
+  static Variant deserialize(BinaryReader& reader, allocator_type const& alloc = {});
+
   /*! \brief Lexicographical operators to compare variant objects.
      *
-     * Operators are implemented using the std::tie pattern.
+     * Two variants are equal if they hold the same type and the same value. Doubles holding NaN
+     * are equal to each other, consistent with the total order below. Named enums compare by
+     * name like the strings they were stored as before: Variant(COLOR::RED) == Variant("RED"), and
+     * values of different enum types are equal if their names are.
      * Implemented as friend functions to have lhs and rhs input arguments.
      */
   friend bool operator==(Variant const& lhs, Variant const& rhs);
   friend bool operator!=(Variant const& lhs, Variant const& rhs);
 
+  /*! \brief Total order of variant objects.
+     *
+     * Variants are ordered by their type first, in the order of the Variant::Type list, and by
+     * value second. Strings and named enums are compared lexicographically by their names, a
+     * named enum takes the place of a string in the order of types. For doubles, NaN is greater
+     * than all other values and all NaNs are equivalent, -0.0 and 0.0 are equivalent as well.
+     * Hence, variants can be sorted and used as keys of ordered containers.
+     */
+  friend bool operator<(Variant const& lhs, Variant const& rhs);
+  friend bool operator>(Variant const& lhs, Variant const& rhs);
+  friend bool operator<=(Variant const& lhs, Variant const& rhs);
+  friend bool operator>=(Variant const& lhs, Variant const& rhs);
+
+  /*! \brief Return a hash of type and value.
+     *
+     * Variants which compare equal have equal hashes, variants holding equal values of
+     * different types usually not. Used by std::hash<DUTIL::Variant>.
+     */
+  std::size_t hash() const noexcept;
+
+  /*! \brief Call the function object f with a reference to the stored value.
+     *
+     * Strings and the names of named enums are handed over as std::string_view, all other types
+     * as const references to the stored value. An empty variant calls f with std::monostate.
+     * Visiting never copies the stored value and never allocates, use it together with DUTIL::Overload
+     * to inspect values in performance critical code:
+     *
+     * v.visit(Overload{[](double const& d) { ... }, [](std::string_view s) { ... }, [](auto const&) {}});
+     */
+  template <typename F>
+  decltype(auto) visit(F&& f) const
+  {
+    switch (tag_) {
+      case Type::LABEL:
+        return f(ref<label_t>());
+      case Type::INT64:
+        return f(ref<std::int64_t>());
+      case Type::UINT64:
+        return f(ref<std::uint64_t>());
+      case Type::DOUBLE:
+        return f(ref<double>());
+      case Type::BOOL:
+        return f(ref<bool>());
+      case Type::CHAR:
+        return f(ref<char>());
+      case Type::STRING:
+        return f(stringView());
+      case Type::ENUM:
+        return f(enumName());
+      default:
+        return f(std::monostate());
+    }
+  }
+
+  /*! \brief Return a pointer to the stored value if the variant holds exactly type T.
+     *
+     * No conversion takes place, e.g. tryGet<double>() on a variant holding a label returns nullptr.
+     * Only arithmetic types are supported, use asStringView() for strings.
+     */
+  template <typename T,
+            std::enable_if_t<VariantDetail::is_allowed_arithmetic_type_v<T>
+                                 && !std::is_same_v<T, std::monostate>,
+                             bool> = true>
+  T const* tryGet() const noexcept
+  {
+    if (tag_ != tagOf<T>())
+      return nullptr;
+    return &ref<T>();
+  }
+
+  /*! \brief Return a view of the stored string without copying it.
+     *
+     * For named enums, a view of the enum value's name is returned which stays valid until the
+     * program ends. Throws if the variant holds neither Type::STRING nor Type::ENUM. The view of
+     * a string is valid as long as the variant is neither modified nor destroyed.
+     */
+  std::string_view asStringView() const;
+
   /*! \brief Assignment operator.
      *
-     * Operators are implemented using the std::tie pattern.
-     * Implemented as friend functions to have lhs and rhs input arguments.
+     * Assigning a value of one of the allowed types replaces the current value and type.
      */
   template <typename AssignedType,
             std::enable_if_t<VariantDetail::is_allowed_type_v<AssignedType>, bool> = true>
   void operator=(AssignedType v)
   {
-    Variant nV = Variant(v);
-    this->type_ = std::move(nV.type_);
-    this->var_ = std::move(nV.var_);
+    *this = Variant(v);
   }
 
-  protected:
-  //! Return a reference to the std::variant member.
-  DutilVariant const& get() const;
-
   private:
-  DutilVariant var_;
-  Type type_;
+  //! Bulk conversions read values of uniform columns directly.
+  friend class VariantColumn;
+
+  //! Marker in size_ for strings stored in a heap buffer.
+  static constexpr std::uint8_t heapStringMarker = 0xFF;
+
+  //! Byte offset of the length of a heap string inside data_.
+  static constexpr std::size_t heapSizeOffset = sizeof(char*);
+
+  //! Byte offset of the ordinal of a named enum inside data_.
+  static constexpr std::size_t enumOrdinalOffset = sizeof(NamedEnumDetail::EnumTypeInfo const*);
+
+  //! Marker in size_ for variants bound to a memory resource, data_ then points to a Binding.
+  static constexpr std::uint8_t boundMarker = 0xFE;
+
+  //! Value and memory resource of a bound variant, obtained from that resource.
+  struct Binding;
+
+  //! Tell if the variant is bound to a memory resource.
+  bool isBound() const noexcept { return size_ == boundMarker; }
+
+  //! Return the block of a bound variant.
+  Binding& binding() const noexcept { return **std::launder(reinterpret_cast<Binding* const*>(data_)); }
+
+  //! Return the variant holding the value, i.e. the one inside the Binding of a bound variant.
+  Variant const& content() const noexcept;
+  Variant& content() noexcept;
+
+  //! Return a reference to the arithmetic value of type T placed at the start of data_.
+  template <typename T>
+  T const& ref() const
+  {
+    return *std::launder(reinterpret_cast<T const*>(content().data_));
+  }
+
+  //! Return the tag belonging to an arithmetic type.
+  template <typename T>
+  static constexpr std::uint8_t tagOf() noexcept
+  {
+    if constexpr (std::is_same_v<T, label_t>)
+      return Type::LABEL;
+    else if constexpr (std::is_same_v<T, std::int64_t>)
+      return Type::INT64;
+    else if constexpr (std::is_same_v<T, std::uint64_t>)
+      return Type::UINT64;
+    else if constexpr (std::is_same_v<T, double>)
+      return Type::DOUBLE;
+    else if constexpr (std::is_same_v<T, bool>)
+      return Type::BOOL;
+    else
+      return Type::CHAR;
+  }
+
+  //! Place an arithmetic value at the start of data_ and set the corresponding tag.
+  template <typename T>
+  void setArithmetic(T value)
+  {
+    tag_ = tagOf<T>();
+    ::new (static_cast<void*>(data_)) T(value);
+  }
+
+  //! Byte offset of the characters of a heap string behind the recorded memory resource.
+  static constexpr std::size_t heapHeaderSize = sizeof(std::pmr::memory_resource*);
+
+  //! Store a string in an unbound variant either inline or in a heap buffer obtained from 'resource'.
+  void setString(std::string_view str,
+                 std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+  //! Store a named enum given by its type description and ordinal.
+  void setEnum(NamedEnumDetail::EnumTypeInfo const& info, std::uint32_t ordinal) noexcept
+  {
+    tag_ = Type::ENUM;
+    ::new (static_cast<void*>(data_)) NamedEnumDetail::EnumTypeInfo const*(&info);
+    std::memcpy(data_ + enumOrdinalOffset, &ordinal, sizeof(ordinal));
+  }
+
+  //! Take over the bytes of another variant without copying a heap buffer.
+  void copyRepresentation(Variant const& other) noexcept;
+
+  //! Bind an empty variant to 'resource' unless it is the default resource.
+  void bind(std::pmr::memory_resource* resource);
+
+  //! Return the memory resource used for heap buffers, see memoryResource().
+  std::pmr::memory_resource* allocationResource() const noexcept;
+
+  //! Replace the value by a copy of the value of 'other', keeping the memory resource.
+  void assignValue(Variant const& other);
+
+  //! Release the Binding of a bound variant as well and reset the variant to std::monostate.
+  void release() noexcept;
+
+  //! Three-way comparison defining the total order, see operator<.
+  int compare(Variant const& other) const;
+
+  //! Release a heap buffer if there is one and reset the variant to std::monostate, a binding is kept.
+  void reset() noexcept;
+
+  //! Tell if the variant owns a heap buffer.
+  bool hasHeapString() const noexcept { return tag_ == Type::STRING && size_ == heapStringMarker; }
+
+  //! Return the stored string, only meaningful for Type::STRING.
+  std::string_view stringView() const noexcept
+  {
+    Variant const& v = content();
+    if (v.size_ != heapStringMarker)
+      return std::string_view(v.data_, v.size_);
+    std::uint32_t length;
+    std::memcpy(&length, v.data_ + heapSizeOffset, sizeof(length));
+    return std::string_view(v.ref<char*>(), length);
+  }
+
+  //! Return the name of the stored named enum value, only meaningful for Type::ENUM.
+  std::string_view enumName() const noexcept
+  {
+    return ref<NamedEnumDetail::EnumTypeInfo const*>()->valueNames[enumOrdinal()];
+  }
+
+  alignas(8) char data_[inlineStringCapacity];
+  std::uint8_t size_;
+  std::uint8_t tag_;
 };
+
+static_assert(sizeof(Variant) == 16, "Variant is expected to occupy exactly 16 bytes.");
+
+struct Variant::Binding
+{
+  std::pmr::memory_resource* resource;
+  Variant value;
+};
+
+inline Variant const& Variant::content() const noexcept
+{
+  return isBound() ? binding().value : *this;
+}
+
+inline Variant& Variant::content() noexcept
+{
+  return isBound() ? binding().value : *this;
+}
 }  // namespace DUTIL
+
+//! Make variants usable as keys of unordered containers.
+template <>
+struct std::hash<DUTIL::Variant>
+{
+  std::size_t operator()(DUTIL::Variant const& v) const noexcept { return v.hash(); }
+};
 #endif  // DUTIL_VARIANT_H
@@ -0,0 +1,66 @@
+#include "variantcolumn.h"
+
+namespace DUTIL {
+
+VariantColumn::VariantColumn() :
+    values_(),
+    tag_(Variant::Type::MONOSTATE),
+    uniform_(false),
+    bound_(false)
+{}
+
+VariantColumn::VariantColumn(std::vector<Variant> values) :
+    VariantColumn()
+{
+  reserve(values.size());
+  for (auto& value : values) {
+    push_back(std::move(value));
+  }
+}
+
+void VariantColumn::push_back(Variant value)
+{
+  if (values_.empty()) {
+    tag_ = value.tag_;
+    uniform_ = true;
+  } else if (value.tag_ != tag_) {
+    uniform_ = false;
+  }
+  bound_ = bound_ || value.isBound();
+  values_.push_back(std::move(value));
+}
+
+void VariantColumn::reserve(std::size_t size)
+{
+  values_.reserve(size);
+}
+
+void VariantColumn::clear() noexcept
+{
+  values_.clear();
+  tag_ = Variant::Type::MONOSTATE;
+  uniform_ = false;
+  bound_ = false;
+}
+
+bool VariantColumn::isUniform() const noexcept
+{
+  return uniform_;
+}
+
+Variant::Type VariantColumn::getType() const
+{
+  if (!uniform_ || values_.empty())
+    return Variant::Type::MONOSTATE;
+  return values_.front().getType();
+}
+
+void VariantColumn::throwConversionError(std::size_t i, ConversionError error) const
+{
+  D_THROW("Value " + Utility::toString(std::uint64_t(i)) + " of the variant column holding type '"
+          + values_[i].getType().toString()
+          + "' cannot be converted into the requested type: " + Conversion::errorToString(error)
+          + ".");
+}
+
+}  // namespace DUTIL
@@ -0,0 +1,223 @@
+#ifndef DUTIL_VARIANTCOLUMN_H
+#define DUTIL_VARIANTCOLUMN_H
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <vector>
+#include "dataset.h"
+#include "exception.h"
+#include "settings.h"
+#include "variant.h"
+
+namespace DUTIL {
+
+/*! \brief A column of variants converted in bulk into arrays of an arithmetic type.
+ *
+ * A typical column holds the value of one key collected from many Settings objects, e.g. one per
+ * simulated instrument:
+ *
+ * VariantColumn column = VariantColumn::fromSettings(instrumentSettings, "wavelength");
+ * std::vector<double> wavelengths = column.toVector<double>();
+ *
+ * The column keeps track of whether all of its values hold the same Variant::Type. If so and no
+ * value is bound to a memory resource, values are read straight from their inline storage in a
+ * plain loop without dispatching on the type of every single value. If that
+ * conversion can never fail, e.g. from label_t into double, the loop consists of casts only and
+ * can be vectorized by the compiler. Mixed columns are converted value by value, strings are parsed.
+ *
+ * Like Variant::convertTo, conversions accept a loss of precision, but reject values which are
+ * empty, not a number or out of range for the target type.
+ */
+class VariantColumn
+{
+  public:
+  //! Default-construct an empty column.
+  VariantColumn();
+
+  //! Construct a column holding the given values.
+  explicit VariantColumn(std::vector<Variant> values);
+
+  /*! \brief Collect the values stored under 'key' from a range of Settings objects.
+     *
+     * Settings objects without that key contribute an empty variant.
+     */
+  template <typename SettingsRange>
+  static VariantColumn fromSettings(SettingsRange const& settings, std::string const& key)
+  {
+    VariantColumn column;
+    column.reserve(std::size(settings));
+    for (Settings const& s : settings) {
+      column.push_back(s.value(key));
+    }
+    return column;
+  }
+
+  //! Append a value.
+  void push_back(Variant value);
+
+  //! Reserve memory for the given number of values.
+  void reserve(std::size_t size);
+
+  //! Remove all values.
+  void clear() noexcept;
+
+  std::size_t size() const noexcept { return values_.size(); }
+  bool empty() const noexcept { return values_.empty(); }
+
+  //! Return the value at position i without range checking.
+  Variant const& operator[](std::size_t i) const { return values_[i]; }
+
+  //! Return all values in order of insertion.
+  std::vector<Variant> const& values() const noexcept { return values_; }
+
+  //! Tell if the column is not empty and all values hold the same type.
+  bool isUniform() const noexcept;
+
+  //! Return the type all values hold if the column is uniform, Type::MONOSTATE otherwise.
+  Variant::Type getType() const;
+
+  /*! \brief Convert all values and write them to 'out', which has to provide room for size() values.
+     *
+     * Throws if a value cannot be converted, 'out' is partially written in that case.
+     */
+  template <typename T>
+  void convertInto(T* out) const
+  {
+    convert(out, [this](std::size_t i, ConversionError error) -> T {
+      throwConversionError(i, error);
+      return T();
+    });
+  }
+
+  /*! \brief Convert all values and write them to 'out', which has to provide room for size() values.
+     *
+     * Values which cannot be converted are replaced by 'fallback', e.g. NaN for missing
+     * floating point values. Return the number of replaced values.
+     */
+  template <typename T>
+  std::size_t convertInto(T* out, T fallback) const noexcept
+  {
+    return convert(out, [fallback](std::size_t, ConversionError) { return fallback; });
+  }
+
+  //! Return all values converted into type T, see convertInto.
+  template <typename T>
+  std::vector<T> toVector() const
+  {
+    std::vector<T> result(values_.size());
+    convertInto(result.data());
+    return result;
+  }
+
+  /*! \brief Return all values converted into type T as a Dataset with one column.
+     *
+     * T has to be one of the types supported by Dataset. An empty column yields an empty Dataset.
+     */
+  template <typename T>
+  Dataset toDataset() const
+  {
+    return Dataset(toVector<T>());
+  }
+
+  private:
+  //! Tell if converting any value of type S into T succeeds, possibly with a loss of precision.
+  template <typename T, typename S>
+  static constexpr bool isAlwaysConvertible()
+  {
+    if constexpr (std::is_same_v<T, S> || std::is_same_v<T, bool>) {
+      return true;
+    } else if constexpr (std::is_floating_point_v<T>) {
+      return std::is_integral_v<S> || sizeof(T) >= sizeof(S);
+    } else if constexpr (std::is_integral_v<S>) {
+      return (std::is_signed_v<T> || !std::is_signed_v<S>)
+             && std::numeric_limits<S>::digits <= std::numeric_limits<T>::digits;
+    } else {
+      return false;
+    }
+  }
+
+  //! Convert all values, 'onError' returns the replacement of a value which cannot be converted.
+  template <typename T, typename OnError>
+  std::size_t convert(T* out, OnError&& onError) const
+  {
+    static_assert(std::is_arithmetic_v<T>, "Variant columns can only be converted into arithmetic types.");
+    if (uniform_ && !bound_) {
+      switch (tag_) {
+        case Variant::Type::LABEL:
+          return convertUniform<T, label_t>(out, onError);
+        case Variant::Type::INT64:
+          return convertUniform<T, std::int64_t>(out, onError);
+        case Variant::Type::UINT64:
+          return convertUniform<T, std::uint64_t>(out, onError);
+        case Variant::Type::DOUBLE:
+          return convertUniform<T, double>(out, onError);
+        case Variant::Type::BOOL:
+          return convertUniform<T, bool>(out, onError);
+        case Variant::Type::CHAR:
+          return convertUniform<T, char>(out, onError);
+        default:
+          break;
+      }
+    }
+
+    std::size_t errors = 0;
+    for (std::size_t i = 0; i < values_.size(); ++i) {
+      auto const result = values_[i].visit(
+          Overload{[](std::string_view arg) { return Conversion::fromChars<T>(arg); },
+                   [](std::monostate) { return ConversionResult<T>{T(), ConversionError::INVALID}; },
+                   [](auto const& arg) { return Conversion::numericCast<T>(arg); }});
+      if (result.hasValue()) {
+        out[i] = result.value;
+      } else {
+        out[i] = onError(i, result.error);
+        ++errors;
+      }
+    }
+    return errors;
+  }
+
+  //! Return the value of type S stored inline in a variant which is not bound.
+  template <typename S>
+  static S inlineValue(Variant const& v) noexcept
+  {
+    return *std::launder(reinterpret_cast<S const*>(v.data_));
+  }
+
+  //! Convert a column whose values all hold type S and none of which is bound.
+  template <typename T, typename S, typename OnError>
+  std::size_t convertUniform(T* out, OnError& onError) const
+  {
+    Variant const* values = values_.data();
+    std::size_t const n = values_.size();
+    if constexpr (isAlwaysConvertible<T, S>()) {
+      for (std::size_t i = 0; i < n; ++i) {
+        out[i] = static_cast<T>(inlineValue<S>(values[i]));
+      }
+      return 0;
+    } else {
+      std::size_t errors = 0;
+      for (std::size_t i = 0; i < n; ++i) {
+        auto const result = Conversion::numericCast<T>(inlineValue<S>(values[i]));
+        if (result.hasValue()) {
+          out[i] = result.value;
+        } else {
+          out[i] = onError(i, result.error);
+          ++errors;
+        }
+      }
+      return errors;
+    }
+  }
+
+  [[noreturn]] void throwConversionError(std::size_t i, ConversionError error) const;
+
+  std::vector<Variant> values_;
+  std::uint8_t tag_;
+  bool uniform_;
+  //! Tell if any value is bound to a memory resource and keeps its value outside of itself.
+  bool bound_;
+};
+
+}  // namespace DUTIL
+#endif  // DUTIL_VARIANTCOLUMN_H
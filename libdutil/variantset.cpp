@@ -0,0 +1,106 @@
+#include "variantset.h"
+#include <algorithm>
+#include <limits>
+#include "exception.h"
+#include "hash.h"
+
+namespace DUTIL {
+
+namespace {
+using Hash::emptySlot;
+
+constexpr std::size_t minimalSlotCount = 16;
+}  // namespace
+
+VariantSet::VariantSet() :
+    values_(),
+    hashes_(),
+    slots_()
+{}
+
+bool VariantSet::insert(Variant const& value)
+{
+  std::size_t const hash = value.hash();
+  std::size_t const slot = findInsertionSlot(value, hash);
+  if (slot == std::size_t(-1))
+    return false;
+  values_.push_back(value);
+  occupySlot(slot, hash);
+  return true;
+}
+
+bool VariantSet::insert(Variant&& value)
+{
+  std::size_t const hash = value.hash();
+  std::size_t const slot = findInsertionSlot(value, hash);
+  if (slot == std::size_t(-1))
+    return false;
+  values_.push_back(std::move(value));
+  occupySlot(slot, hash);
+  return true;
+}
+
+std::size_t VariantSet::findInsertionSlot(Variant const& value, std::size_t hash)
+{
+  // look the value up before growing the table, inserting a duplicate does not change the set
+  std::size_t slot = slots_.empty() ? std::size_t(-1) : findSlot(value, hash);
+  if (slot != std::size_t(-1) && slots_[slot] != emptySlot)
+    return std::size_t(-1);
+  if (values_.size() >= std::numeric_limits<std::uint32_t>::max())
+    D_THROW("VariantSet can not hold more than 2^32 - 1 values.");
+  if (2 * (values_.size() + 1) > slots_.size()) {
+    rehash(Hash::slotCountFor(values_.size() + 1, minimalSlotCount));
+    slot = findSlot(value, hash);
+  }
+  // grow the hashes before the value is added, occupySlot can not throw after it
+  if (hashes_.size() == hashes_.capacity())
+    hashes_.reserve(std::max(minimalSlotCount, 2 * hashes_.size()));
+  return slot;
+}
+
+void VariantSet::occupySlot(std::size_t slot, std::size_t hash)
+{
+  slots_[slot] = static_cast<std::uint32_t>(values_.size() - 1);
+  hashes_.push_back(hash);
+}
+
+bool VariantSet::contains(Variant const& value) const
+{
+  if (values_.empty())
+    return false;
+  return slots_[findSlot(value, value.hash())] != emptySlot;
+}
+
+void VariantSet::reserve(std::size_t size)
+{
+  values_.reserve(size);
+  hashes_.reserve(size);
+  if (2 * size > slots_.size())
+    rehash(Hash::slotCountFor(size, minimalSlotCount));
+}
+
+void VariantSet::clear() noexcept
+{
+  values_.clear();
+  hashes_.clear();
+  slots_.assign(slots_.size(), emptySlot);
+}
+
+std::size_t VariantSet::findSlot(Variant const& value, std::size_t hash) const
+{
+  for (std::size_t slot = hash & (slots_.size() - 1);; slot = Hash::nextSlot(slot, slots_.size())) {
+    std::uint32_t const index = slots_[slot];
+    if (index == emptySlot || (hashes_[index] == hash && values_[index] == value))
+      return slot;
+  }
+}
+
+void VariantSet::rehash(std::size_t slotCount)
+{
+  slots_.assign(slotCount, emptySlot);
+  for (std::size_t i = 0; i < values_.size(); ++i) {
+    Hash::occupyFreeSlot(slots_, hashes_[i] & (slotCount - 1), static_cast<std::uint32_t>(i));
+  }
+}
+
+}  // namespace DUTIL
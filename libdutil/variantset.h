@@ -0,0 +1,78 @@
+#ifndef DUTIL_VARIANTSET_H
+#define DUTIL_VARIANTSET_H
+#include <cstdint>
+#include <vector>
+#include "variant.h"
+
+namespace DUTIL {
+
+/*! \brief A flat hash set of variants keeping insertion order.
+ *
+ * Values are stored contiguously in a vector in the order of insertion, a separate open addressing
+ * table with linear probing holds indices into that vector. Together with the hash of each value
+ * this makes lookups touch only two small arrays and keeps iteration as fast as for a plain vector.
+ *
+ * The typical use case is deduplication of parameter values:
+ *
+ * VariantSet set;
+ * for (auto const& v : values)
+ *   set.insert(v);
+ * // set.values() now contains every distinct value once, in order of first occurence.
+ *
+ * Single values can not be removed, use clear() to start over.
+ */
+class VariantSet
+{
+  public:
+  using const_iterator = std::vector<Variant>::const_iterator;
+
+  //! Construct an empty set.
+  VariantSet();
+
+  //! Insert a value, return false if an equal value is already part of the set.
+  //! If the insertion throws, the set is unchanged.
+  bool insert(Variant const& value);
+  bool insert(Variant&& value);
+
+  //! Tell if an equal value is part of the set.
+  bool contains(Variant const& value) const;
+
+  //! Reserve memory for the given number of values.
+  void reserve(std::size_t size);
+
+  //! Remove all values.
+  void clear() noexcept;
+
+  std::size_t size() const noexcept { return values_.size(); }
+  bool empty() const noexcept { return values_.empty(); }
+
+  //! Return all values in order of insertion.
+  std::vector<Variant> const& values() const noexcept { return values_; }
+
+  const_iterator begin() const noexcept { return values_.begin(); }
+  const_iterator end() const noexcept { return values_.end(); }
+
+  private:
+  /*! \brief Prepare the insertion of a value with the given hash.
+   *
+   * Return the empty slot the value has to be inserted at or npos if an equal value exists. Memory
+   * for the hash is reserved, so only adding the value to values_ can throw afterwards.
+   */
+  std::size_t findInsertionSlot(Variant const& value, std::size_t hash);
+
+  //! Link the last value in values_ to the given slot.
+  void occupySlot(std::size_t slot, std::size_t hash);
+
+  //! Return the slot holding an equal value or the empty slot where it would be inserted.
+  std::size_t findSlot(Variant const& value, std::size_t hash) const;
+
+  //! Rebuild the index table with the given number of slots, which has to be a power of two.
+  void rehash(std::size_t slotCount);
+
+  std::vector<Variant> values_;
+  std::vector<std::size_t> hashes_;
+  std::vector<std::uint32_t> slots_;
+};
+
+}  // namespace DUTIL
+#endif  // DUTIL_VARIANTSET_H
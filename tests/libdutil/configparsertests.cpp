@@ -0,0 +1,206 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include "libdutil/configparser.h"
+#include "libdutil/exception.h"
+#include "libdutil/mappedfile.h"
+#include "libdutil/namedparameter.h"
+#include "tests/testbase.h"
+
+using namespace DUTIL;
+
+namespace {
+class ConfigParserTests : public TestBase
+{};
+
+D_NAMED_ENUM(Solver, CONJUGATE_GRADIENT, GMRES)
+D_NAMED_REAL(Tolerance)
+D_NAMED_LABEL(Iterations)
+
+std::string const config = R"(# solver configuration
+Solver = GMRES
+Tolerance = 1e-8        # inline comment
+Iterations = 250
+Verbose = true
+Title = "Run \"A\" # 1"
+Version = 1.2.3
+Empty =
+
+[Detector]
+Gain = 2.5
+@dataset FLOAT64 2 = [ 0.5, 1.5,   # first row
+                       2.5  3.5 ]
+
+[Detector.Pixel]
+Channels = 64
+
+[Detector.Pixel]
+Channels = 128
+
+[Detector]
+Gain = 3
+)";
+}  // namespace
+
+TEST_F(ConfigParserTests, parseTypedValues)
+{
+  Settings s = ConfigParser::parseSettings("a = 1\n"
+                                           "b = -7\n"
+                                           "c = 5000000000\n"
+                                           "d = 18446744073709551615\n"
+                                           "e = 0.25\n"
+                                           "f = -3e2\n"
+                                           "g = false\n"
+                                           "h = SCINTILLATOR\n"
+                                           "i = 2024-01-01\n"
+                                           "j = \"12\"\n"
+                                           "k =\n"
+                                           "l = \"tab\\tnew\\nline\\\\\"\n"
+                                           "m = 1,5\n"
+                                           "n = +.5\n"
+                                           "o = inf\n"
+                                           "p = -inf\n"
+                                           "q = -nan\n"
+                                           "r = +infinity\n");
+  EXPECT_EQ(s.value("a").getType(), Variant::Type::LABEL);
+  EXPECT_EQ(s.value("a").getAs<label_t>().second, 1);
+  EXPECT_EQ(s.value("b").getAs<label_t>().second, -7);
+  EXPECT_EQ(s.value("c").getType(), Variant::Type::INT64);
+  EXPECT_EQ(s.value("c").getAs<std::int64_t>().second, 5000000000);
+  EXPECT_EQ(s.value("d").getType(), Variant::Type::UINT64);
+  EXPECT_EQ(s.value("d").getAs<std::uint64_t>().second, 18446744073709551615u);
+  EXPECT_EQ(s.value("e").getType(), Variant::Type::DOUBLE);
+  EXPECT_EQ(s.value("e").getAs<double>().second, 0.25);
+  EXPECT_EQ(s.value("f").getAs<double>().second, -300.0);
+  EXPECT_EQ(s.value("g").getType(), Variant::Type::BOOL);
+  EXPECT_FALSE(s.value("g").getAs<bool>().second);
+  EXPECT_EQ(s.value("h").toString(), "SCINTILLATOR");
+  EXPECT_EQ(s.value("i").toString(), "2024-01-01");
+  EXPECT_EQ(s.value("j").getType(), Variant::Type::STRING);
+  EXPECT_EQ(s.value("j").toString(), "12");
+  EXPECT_TRUE(s.hasKey("k"));
+  EXPECT_FALSE(s.value("k").isValid());
+  EXPECT_EQ(s.value("l").toString(), "tab\tnew\nline\\");
+  // numbers use the decimal point only
+  EXPECT_EQ(s.value("m").getType(), Variant::Type::STRING);
+  EXPECT_EQ(s.value("m").toString(), "1,5");
+  EXPECT_EQ(s.value("n").getAs<double>().second, 0.5);
+  // non-finite spellings are strings, with or without a sign
+  for (char const* key : {"o", "p", "q", "r"}) {
+    EXPECT_EQ(s.value(key).getType(), Variant::Type::STRING) << key;
+  }
+  EXPECT_EQ(s.value("p").toString(), "-inf");
+}
+
+TEST_F(ConfigParserTests, parseConstructionDataTree)
+{
+  ConstructionData cd = ConfigParser::parse(config);
+
+  EXPECT_EQ(cd.s.getEnum<Solver>(), Solver::GMRES);
+  EXPECT_EQ(cd.s.getParameter<Tolerance>().value(), 1e-8);
+  EXPECT_EQ(cd.s.getParameter<Iterations>().value(), 250);
+  EXPECT_TRUE(cd.s.value("Verbose").getAs<bool>().second);
+  EXPECT_EQ(cd.s.value("Title").toString(), "Run \"A\" # 1");
+  EXPECT_EQ(cd.s.value("Version").toString(), "1.2.3");
+  EXPECT_FALSE(cd.s.value("Empty").isValid());
+  EXPECT_FALSE(cd.hasDataset());
+
+  // repeated headers add further instances
+  ASSERT_EQ(cd.subObjectData.size(), 2u);
+  auto first = cd.getSubObjectWithCounter("Detector", 0);
+  auto second = cd.getSubObjectWithCounter("Detector", 1);
+  ASSERT_NE(first, cd.subObjectData.end());
+  ASSERT_NE(second, cd.subObjectData.end());
+  EXPECT_EQ(first->second.s.value("Gain").getAs<double>().second, 2.5);
+  EXPECT_EQ(second->second.s.value("Gain").getAs<label_t>().second, 3);
+
+  Dataset const& ds = first->second.ds;
+  EXPECT_EQ(ds.getType(), Dataset::Type::FLOAT64);
+  EXPECT_EQ(ds.getCols(), 2);
+  EXPECT_EQ(ds.getValues<double>(), (std::vector<double>{0.5, 1.5, 2.5, 3.5}));
+
+  // nested headers refer to the last instance of their parents
+  ConstructionData const& detector = first->second;
+  ASSERT_EQ(detector.subObjectData.size(), 2u);
+  EXPECT_EQ(detector.getSubObjectWithCounter("Pixel", 0)->second.s.value("Channels").toString(), "64");
+  EXPECT_EQ(detector.getSubObjectWithCounter("Pixel", 1)->second.s.value("Channels").toString(), "128");
+  EXPECT_TRUE(second->second.subObjectData.empty());
+}
+
+TEST_F(ConfigParserTests, parseDatasetTypes)
+{
+  ConstructionData cd = ConfigParser::parse("@dataset INT16 = [-3 4, 5]\n"
+                                            "[a]\n@dataset UINT8 3 = [1 2 3\n4 5 6]\n"
+                                            "[b]\n@dataset FLOAT32 = [0.1]\n"
+                                            "[c]\n@dataset EMPTY = []\n");
+  EXPECT_EQ(cd.ds.getType(), Dataset::Type::INT16);
+  EXPECT_EQ(cd.ds.getValues<std::int16_t>(), (std::vector<std::int16_t>{-3, 4, 5}));
+  Dataset const& a = cd.getSubObjectWithCounter("a")->second.ds;
+  EXPECT_EQ(a.getType(), Dataset::Type::UINT8);
+  EXPECT_EQ(a.getRows(), 2);
+  EXPECT_EQ(a.getValue<std::uint8_t>(1, 2), 6);
+  EXPECT_EQ(cd.getSubObjectWithCounter("b")->second.ds.getValues<float>(), (std::vector<float>{0.1f}));
+  EXPECT_FALSE(cd.getSubObjectWithCounter("c")->second.hasDataset());
+}
+
+TEST_F(ConfigParserTests, syntaxErrorsNameSourceAndLine)
+{
+  D_EXPECT_THROW(ConfigParser::parse("a = 1\nmissing equals\n", "test.ini"), "test.ini:2: Expected '='");
+  D_EXPECT_THROW(ConfigParser::parse("= 1\n"), "Missing key");
+  D_EXPECT_THROW(ConfigParser::parse("a = \"open\n"), "Missing closing quote");
+  D_EXPECT_THROW(ConfigParser::parse("a = \"x\" y\n"), "Unexpected text 'y'");
+  D_EXPECT_THROW(ConfigParser::parse("a = \"\\q\"\n"), "Unknown escape sequence");
+  D_EXPECT_THROW(ConfigParser::parse("[a\n"), "Missing ']'");
+  D_EXPECT_THROW(ConfigParser::parse("[a..b]\n"), "Empty section name");
+  D_EXPECT_THROW(ConfigParser::parse("[a;1]\n"), "must not contain");
+  D_EXPECT_THROW(ConfigParser::parse("@table FLOAT64 = [1]\n"), "expected '@dataset'");
+  D_EXPECT_THROW(ConfigParser::parse("@dataset FLOAT128 = [1]\n"), "Unknown dataset type");
+  D_EXPECT_THROW(ConfigParser::parse("@dataset INT8 = [1 300]\n"), "Invalid dataset value '300'");
+  D_EXPECT_THROW(ConfigParser::parse("@dataset INT8 = [1.5]\n"), "Invalid dataset value");
+  D_EXPECT_THROW(ConfigParser::parse("@dataset UINT8 = [-5]\n"), "Invalid dataset value");
+  D_EXPECT_THROW(ConfigParser::parse("@dataset UINT64 = [-18446744073709551615]\n"), "Invalid dataset value '-18446744073709551615': number out of range");
+  D_EXPECT_THROW(ConfigParser::parse("@dataset INT8 2 = [1 2 3]\n"), "not divisible");
+  D_EXPECT_THROW(ConfigParser::parse("@dataset INT8 = [1 2\n3\n"), "<text>:3: Missing ']'");
+  D_EXPECT_THROW(ConfigParser::parse("@dataset INT8 = [1]\n@dataset INT8 = [2]\n"), "already holds");
+  D_EXPECT_THROW(ConfigParser::parseSettings("[a]\n"), "Sections are not allowed");
+  D_EXPECT_THROW(ConfigParser::parseSettings("@dataset INT8 = [1]\n"), "Datasets are not allowed");
+}
+
+TEST_F(ConfigParserTests, parseMappedFileIntoMemoryResource)
+{
+  auto const path = (std::filesystem::temp_directory_path() / "libd_configparsertests.ini").string();
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << config;
+  }
+
+  std::pmr::monotonic_buffer_resource arena;
+  ConstructionData cd = ConfigParser::parseFile(path, &arena);
+  EXPECT_EQ(cd.get_allocator().resource(), &arena);
+  EXPECT_EQ(cd.s.get_allocator().resource(), &arena);
+  EXPECT_EQ(cd.getSubObjectWithCounter("Detector")->second.s.get_allocator().resource(), &arena);
+  EXPECT_EQ(cd.s.getEnum<Solver>(), Solver::GMRES);
+
+  // the mapped file yields the same result as the text
+  EXPECT_EQ(cd.s, ConfigParser::parse(config).s);
+  D_EXPECT_THROW(ConfigParser::parseSettingsFile(path), "libd_configparsertests.ini:10: Sections are not allowed");
+
+  // large files are mapped instead of read
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << "@dataset UINT32 = [";
+    for (std::uint32_t i = 0; i < 20000; ++i) {
+      file << i << ' ';
+    }
+    file << "]\n";
+  }
+  ASSERT_GE(MappedFile(path).size(), MappedFile::mappingThreshold);
+  std::vector<std::uint32_t> const values = ConfigParser::parseFile(path).ds.getValues<std::uint32_t>();
+  ASSERT_EQ(values.size(), 20000u);
+  EXPECT_EQ(values.back(), 19999u);
+  std::remove(path.c_str());
+
+  D_EXPECT_THROW(MappedFile("/nonexistent/libd/config.ini"), "Cannot open file");
+  D_EXPECT_THROW(ConfigParser::parseFile("/nonexistent/libd/config.ini"), "Cannot open file");
+}
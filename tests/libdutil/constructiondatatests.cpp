@@ -6,6 +6,8 @@
 #include "tests/libtesting/trivialware.h"
 #include "tests/testbase.h"
 
+#include <memory_resource>
+
 using namespace DUTIL;
 
 namespace {
@@ -254,3 +256,114 @@ TEST_F(ConstructionDataTests, createSubobjectKeyWithCounter)
   ConstructionData cd;
   ASSERT_EQ(cd.createSubObjectKeyWithCounter("bla"), "bla;0");
 }
+
+TEST_F(ConstructionDataTests, buildTreeInsideMemoryResource)
+{
+  // count the allocations served by the arena's upstream resource
+  struct CountingResource : std::pmr::memory_resource
+  {
+    std::size_t allocations = 0;
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+      ++allocations;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+      std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+    {
+      return this == &other;
+    }
+  } counting;
+  std::string const longValue = "a description which is too long to be stored inline";
+
+  ConstructionData cd(&counting);
+  cd.s.set("description", longValue);
+  EXPECT_EQ(&counting, cd.get_allocator().resource());
+  EXPECT_EQ(&counting, cd.s.get_allocator().resource());
+  std::size_t const settingsAllocations = counting.allocations;
+  EXPECT_GE(settingsAllocations, 2u);
+
+  // a nested ConstructionData object is copied into the resource of its parent
+  ConstructionData sub;
+  sub.s.set("description", longValue);
+  cd.addSubobject<Subobject::SubSubObjectList>(sub);
+  auto const& storedSub = cd.getSubObjectWithCounter("SubSubObjectList", 0)->second;
+  EXPECT_EQ(&counting, storedSub.get_allocator().resource());
+  EXPECT_GT(counting.allocations, settingsAllocations);
+  EXPECT_EQ(storedSub.s, sub.s);
+
+  // plain copies use the default resource, extended copies the given one
+  ConstructionData copy = cd;
+  EXPECT_EQ(std::pmr::get_default_resource(), copy.get_allocator().resource());
+  EXPECT_EQ(copy.s, cd.s);
+  std::pmr::monotonic_buffer_resource arena;
+  ConstructionData arenaCopy(cd, &arena);
+  EXPECT_EQ(&arena, arenaCopy.subObjectData.begin()->second.s.get_allocator().resource());
+  EXPECT_EQ(longValue, arenaCopy.s.value("description").toString());
+}
+
+TEST_F(ConstructionDataTests, diffTreesAndListChangedSubobjects)
+{
+  ConstructionData pixel = ConstructionData().setEnum(WEEKDAY::FRIDAY);
+  ConstructionData detector;
+  detector.s.set("gain", 2.5);
+  detector.subObjectData.emplace("Pixel;0", pixel);
+  detector.subObjectData.emplace("Pixel;1", pixel);
+  ConstructionData root;
+  root.s.set("title", "run");
+  root.subObjectData.emplace("Detector;0", detector);
+  root.subObjectData.emplace("Detector;1", detector);
+
+  ConstructionData same = root;
+  EXPECT_TRUE(root.diff(same).empty());
+  EXPECT_TRUE(root.diff(same).changedPaths().empty());
+
+  // change a leaf: only its own path has to be rebuilt
+  ConstructionData changed = root;
+  changed.subObjectData.at("Detector;1").subObjectData.at("Pixel;0").s.setEnum(WEEKDAY::SUNDAY);
+  auto diff = root.diff(changed);
+  EXPECT_FALSE(diff.empty());
+  EXPECT_FALSE(diff.ownMembersChanged());
+  ASSERT_EQ(diff.changedSubObjects.size(), 1u);
+  EXPECT_EQ(diff.changedSubObjects.front().first, "Detector;1");
+  EXPECT_EQ(diff.changedPaths(), StringList{"Detector;1/Pixel;0"});
+  auto const& leaf = diff.changedSubObjects.front().second.changedSubObjects.front().second;
+  EXPECT_EQ(leaf.settings.changed.keys(), StringList{"WEEKDAY"});
+
+  // removing or adding a subobject rebuilds its parent
+  ConstructionData removed = root;
+  removed.subObjectData.at("Detector;0").subObjectData.erase("Pixel;1");
+  diff = root.diff(removed);
+  EXPECT_FALSE(diff.changedSubObjects.front().second.ownMembersChanged());
+  EXPECT_EQ(diff.changedPaths(), StringList{"Detector;0"});
+  removed.subObjectData.erase("Detector;1");
+  EXPECT_EQ(root.diff(removed).changedPaths(), (StringList{"", "Detector;0"}));
+  EXPECT_EQ(removed.diff(root).changedPaths(), (StringList{"", "Detector;1", "Detector;0", "Detector;0/Pixel;1"}));
+
+  // added and removed subobjects, datasets and own settings
+  changed.s.set("title", "second run");
+  changed.subObjectData.erase("Detector;0");
+  changed.subObjectData.at("Detector;1").ds = Dataset(std::vector<double>{1.0, 2.0});
+  changed.subObjectData.emplace("Source;0", ConstructionData());
+  diff = root.diff(changed);
+  EXPECT_TRUE(diff.ownMembersChanged());
+  EXPECT_EQ(diff.settings.changed.keys(), StringList{"title"});
+  EXPECT_EQ(diff.removedSubObjects, StringList{"Detector;0"});
+  EXPECT_EQ(diff.addedSubObjects, StringList{"Source;0"});
+  EXPECT_TRUE(diff.changedSubObjects.front().second.datasetChanged);
+  EXPECT_EQ(diff.changedPaths(), (StringList{"", "Source;0", "Detector;1", "Detector;1/Pixel;0"}));
+
+  // shared wares are compared by identity
+  auto ware = std::make_shared<TESTS::TrivialWare>();
+  ConstructionData withWare = root;
+  withWare.sharedWares.emplace("TrivialWare;0", ware);
+  diff = root.diff(withWare);
+  EXPECT_EQ(diff.changedSharedWares, StringList{"TrivialWare;0"});
+  ConstructionData sameWare = withWare;
+  EXPECT_TRUE(withWare.diff(sameWare).empty());
+  sameWare.sharedWares["TrivialWare;0"] = std::make_shared<TESTS::TrivialWare>();
+  EXPECT_EQ(withWare.diff(sameWare).changedSharedWares, StringList{"TrivialWare;0"});
+}
@@ -384,6 +384,20 @@ TEST_F(ConstructionValidatorTests, checkNamedEnum)
   ASSERT_FALSE(cv.checkNamedEnum<States>(ConstructionData()).empty());
 }
 
+TEST_F(ConstructionValidatorTests, checkNamedEnumAgainstStringRule)
+{
+  // hand-built STRING rules listing the enum names accept values stored by setEnum
+  SettingRule sd;
+  sd.usage = SettingRule::Usage::MANDATORY_NO_DEFAULT;
+  sd.key = States::getEnumName();
+  sd.listOfPossibleValues = {"NEWYORK", "TEXAS"};
+  ConstructionValidator cv({sd});
+
+  ASSERT_TRUE(cv.checkNamedEnum<States>(ConstructionData().setEnum(States::TEXAS)).empty());
+  EXPECT_THAT(cv.checkNamedEnum<States>(ConstructionData().setEnum(States::NEVADA)),
+              testing::HasSubstr("'NEVADA' is not in that list."));
+}
+
 TEST_F(ConstructionValidatorTests, checkNamedParameterForLabel)
 {
   SettingRule sd = SettingRule::forNamedParameter<LabelParam>(SettingRule::Usage::OPTIONAL,
@@ -669,6 +683,12 @@ TEST_F(ConstructionValidatorTests, validateNamedEnum)
       {SettingRule::forNamedEnum<Fruits>(SettingRule::Usage::OPTIONAL, "a container for fruits")});
   ConstructionData cd = ConstructionData().setEnum(Fruits::ORANGE);
   ASSERT_EQ(Fruits::ORANGE, cv.validateNamedEnum<Fruits>(cd).value());
+
+  // enums given by name, e.g. read from a text file, are accepted as well
+  cd.s.set(Fruits::getEnumName(), "BANANA");
+  ASSERT_EQ(Fruits::BANANA, cv.validateNamedEnum<Fruits>(cd).value());
+  cd.s.set(Fruits::getEnumName(), "CHERRY");
+  D_EXPECT_THROW(cv.validateNamedEnum<Fruits>(cd), "is not in that list");
 }
 
 TEST_F(ConstructionValidatorTests, validateNamedParameterForLabel)
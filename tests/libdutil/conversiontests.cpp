@@ -0,0 +1,104 @@
+#include "libd/libdutil/conversion.h"
+#include "libd/libdutil/variant.h"
+#include "tests/testbase.h"
+
+#include <limits>
+
+using namespace DUTIL;
+
+namespace {
+class ConversionTests : public TestBase
+{};
+}  // namespace
+
+TEST_F(ConversionTests, testFromCharsIntegers)
+{
+  auto a = Conversion::fromChars<std::int64_t>("  -1234 ");
+  EXPECT_TRUE(a.ok());
+  EXPECT_EQ(-1234, a.value);
+
+  auto b = Conversion::fromChars<label_t>("+42");
+  EXPECT_TRUE(b.ok());
+  EXPECT_EQ(42, b.value);
+
+  // decimal and exponent notation
+  auto c = Conversion::fromChars<label_t>("1234.5678");
+  EXPECT_EQ(ConversionError::PRECISION_LOSS, c.error);
+  EXPECT_TRUE(c.hasValue());
+  EXPECT_EQ(1234, c.value);
+  auto d = Conversion::fromChars<std::int64_t>("1e3");
+  EXPECT_TRUE(d.ok());
+  EXPECT_EQ(1000, d.value);
+
+  // unsigned integers ignore the sign
+  auto e = Conversion::fromChars<std::uint64_t>("-77");
+  EXPECT_TRUE(e.ok());
+  EXPECT_EQ(77u, e.value);
+
+  EXPECT_EQ(ConversionError::OUT_OF_RANGE, Conversion::fromChars<label_t>("2147483648").error);
+  EXPECT_EQ(ConversionError::OUT_OF_RANGE, Conversion::fromChars<label_t>("1e10").error);
+  EXPECT_EQ(ConversionError::INVALID, Conversion::fromChars<label_t>("12abc").error);
+  EXPECT_EQ(ConversionError::INVALID, Conversion::fromChars<label_t>("").error);
+  EXPECT_FALSE(Conversion::fromChars<label_t>("abc").hasValue());
+  EXPECT_EQ(ConversionError::INVALID, Conversion::fromChars<label_t>("+-5").error);
+  EXPECT_EQ(ConversionError::INVALID, Conversion::fromChars<label_t>("-+5").error);
+  EXPECT_EQ(ConversionError::INVALID, Conversion::fromChars<label_t>("++5").error);
+  EXPECT_EQ(ConversionError::INVALID, Conversion::fromChars<std::uint64_t>("-+5").error);
+  EXPECT_EQ(ConversionError::INVALID, Conversion::fromChars<std::uint64_t>("+-5").error);
+}
+
+TEST_F(ConversionTests, testFromCharsFloatingPointAndOthers)
+{
+  auto a = Conversion::fromChars<double>("-1234.5678");
+  EXPECT_TRUE(a.ok());
+  EXPECT_EQ(-1234.5678, a.value);
+  EXPECT_EQ(2.5, Conversion::fromChars<double>("2,5").value);
+  EXPECT_EQ(1e-3, Conversion::fromChars<double>(" +1e-3").value);
+  EXPECT_EQ(ConversionError::OUT_OF_RANGE, Conversion::fromChars<double>("1e400").error);
+  EXPECT_EQ(ConversionError::INVALID, Conversion::fromChars<double>("1,2,3").error);
+  EXPECT_EQ(ConversionError::INVALID, Conversion::fromChars<double>("Hello").error);
+
+  EXPECT_TRUE(Conversion::fromChars<bool>("x").value);
+  EXPECT_FALSE(Conversion::fromChars<bool>("").value);
+  EXPECT_EQ('x', Conversion::fromChars<char>("x").value);
+  EXPECT_EQ(ConversionError::INVALID, Conversion::fromChars<char>("xy").error);
+}
+
+TEST_F(ConversionTests, testNumericCast)
+{
+  EXPECT_EQ(ConversionError::NONE, Conversion::numericCast<label_t>(2.0).error);
+  EXPECT_EQ(ConversionError::PRECISION_LOSS, Conversion::numericCast<label_t>(2.5).error);
+  EXPECT_EQ(ConversionError::OUT_OF_RANGE, Conversion::numericCast<label_t>(3e9).error);
+  EXPECT_EQ(ConversionError::OUT_OF_RANGE, Conversion::numericCast<std::uint64_t>(-1.0).error);
+  EXPECT_EQ(ConversionError::OUT_OF_RANGE,
+            Conversion::numericCast<std::int64_t>(std::numeric_limits<std::uint64_t>::max()).error);
+  EXPECT_EQ(ConversionError::OUT_OF_RANGE, Conversion::numericCast<std::uint64_t>(-1).error);
+  EXPECT_EQ(ConversionError::OUT_OF_RANGE, Conversion::numericCast<char>(300).error);
+  EXPECT_EQ(-5, Conversion::numericCast<label_t>(std::int64_t(-5)).value);
+
+  auto large = Conversion::numericCast<double>((std::int64_t(1) << 53) + 1);
+  EXPECT_EQ(ConversionError::PRECISION_LOSS, large.error);
+  EXPECT_TRUE(Conversion::numericCast<double>(std::int64_t(1) << 60).ok());
+  EXPECT_TRUE(Conversion::numericCast<bool>(7).value);
+}
+
+TEST_F(ConversionTests, testVariantConversion)
+{
+  EXPECT_EQ(ConversionError::PRECISION_LOSS, Variant("2.5").convert<label_t>().error);
+  EXPECT_EQ(ConversionError::INVALID, Variant("two").convert<double>().error);
+  EXPECT_EQ(ConversionError::INVALID, Variant().convert<double>().error);
+  EXPECT_EQ(ConversionError::OUT_OF_RANGE, Variant(std::int64_t(-1)).convert<std::uint64_t>().error);
+
+  // getAs reports invalid strings instead of throwing
+  auto result = Variant("two").getAs<double>();
+  EXPECT_FALSE(result.first);
+
+  // convertTo leaves the variant unchanged if the value does not fit
+  Variant v(std::uint64_t(1) << 40);
+  v.convertTo(Variant::Type::LABEL);
+  EXPECT_EQ(Variant::Type::UINT64, v.getType());
+  v.convertTo(Variant::Type::STRING);
+  v.convertTo(Variant::Type::INT64);
+  EXPECT_EQ(Variant::Type::INT64, v.getType());
+  EXPECT_EQ(std::int64_t(1) << 40, *v.tryGet<std::int64_t>());
+}
@@ -0,0 +1,111 @@
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include "libdutil/datasetcsv.h"
+#include "tests/testbase.h"
+
+using namespace DUTIL;
+
+namespace {
+class DatasetCSVTests : public TestBase
+{};
+
+DatasetCSV::Options withType(Dataset::Type type)
+{
+  DatasetCSV::Options options;
+  options.type = type;
+  return options;
+}
+}  // namespace
+
+TEST_F(DatasetCSVTests, parse_infersType)
+{
+  Dataset ints = DatasetCSV::parse("1,2,3\n-4, +5 ,6\r\n\n# comment\n7,8,9");
+  EXPECT_EQ(ints.getType(), Dataset::Type::INT64);
+  EXPECT_EQ(ints.getCols(), 3);
+  EXPECT_EQ(ints.getValues<int64_t>(), (std::vector<int64_t>{1, 2, 3, -4, 5, 6, 7, 8, 9}));
+
+  Dataset reals = DatasetCSV::parse("1,2\n3.5,4e2\n");
+  EXPECT_EQ(reals.getType(), Dataset::Type::FLOAT64);
+  EXPECT_EQ(reals.getValues<double>(), (std::vector<double>{1.0, 2.0, 3.5, 400.0}));
+
+  // integers beyond the range of int64_t are read as reals
+  EXPECT_EQ(DatasetCSV::parse("18446744073709551615\n").getType(), Dataset::Type::FLOAT64);
+  EXPECT_EQ(DatasetCSV::parse("").getType(), Dataset::Type::EMPTY);
+  EXPECT_EQ(DatasetCSV::parse("# only a comment\n\n").getType(), Dataset::Type::EMPTY);
+}
+
+TEST_F(DatasetCSVTests, parse_givenTypeAndOptions)
+{
+  DatasetCSV::Options options = withType(Dataset::Type::UINT8);
+  options.delimiter = ';';
+  options.skipHeader = true;
+  Dataset ds = DatasetCSV::parse("a;b\n0;255\n7;8\n", options);
+  EXPECT_EQ(ds.getType(), Dataset::Type::UINT8);
+  EXPECT_EQ(ds.getValues<uint8_t>(), (std::vector<uint8_t>{0, 255, 7, 8}));
+
+  EXPECT_EQ(DatasetCSV::parse(" 0.25 ,\t1\r\n", withType(Dataset::Type::FLOAT32)).getValues<float>(),
+            (std::vector<float>{0.25f, 1.0f}));
+  options = withType(Dataset::Type::FLOAT32);
+  options.delimiter = '\t';
+  EXPECT_EQ(DatasetCSV::parse("0.25\t1\n", options).getValues<float>(), (std::vector<float>{0.25f, 1.0f}));
+}
+
+TEST_F(DatasetCSVTests, parse_errorsNameSourceAndLine)
+{
+  D_EXPECT_THROW(DatasetCSV::parse("1,2\n3\n", DatasetCSV::Options(), "prices.csv"),
+                 "prices.csv:2: Expected 2 values, found 1.");
+  D_EXPECT_THROW(DatasetCSV::parse("1,x\n"), "<text>:1: Invalid value 'x'");
+  D_EXPECT_THROW(DatasetCSV::parse("1,,2\n"), "Invalid value ''");
+  D_EXPECT_THROW(DatasetCSV::parse("1\n256\n", withType(Dataset::Type::UINT8)), "<text>:2: Invalid value '256'");
+  D_EXPECT_THROW(DatasetCSV::parse("1.5\n", withType(Dataset::Type::INT32)), "Invalid value '1.5'");
+  D_EXPECT_THROW(DatasetCSV::read("/nonexistent/libd/prices.csv"), "Cannot open file");
+}
+
+TEST_F(DatasetCSVTests, parse_manySmallChunksOnSeveralThreads)
+{
+  std::string text;
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < 5000; ++i) {
+    text += std::to_string(i) + "," + std::to_string(-i) + "\n";
+    expected.push_back(i);
+    expected.push_back(-i);
+  }
+  DatasetCSV::Options options;
+  options.chunkSize = 100;
+  options.threads = 4;
+  Dataset ds = DatasetCSV::parse(text, options);
+  EXPECT_EQ(ds.getRows(), 5000);
+  EXPECT_EQ(ds.getValues<int64_t>(), expected);
+
+  // one real value turns all chunks into reals
+  Dataset reals = DatasetCSV::parse(text + "0.5,1\n", options);
+  EXPECT_EQ(reals.getType(), Dataset::Type::FLOAT64);
+  EXPECT_EQ(reals.getValue<double>(4999, 1), -4999.0);
+  EXPECT_EQ(reals.getValue<double>(5000, 0), 0.5);
+
+  // errors in later chunks report the line in the whole text
+  D_EXPECT_THROW(DatasetCSV::parse(text + "1,2,3\n", options), "<text>:5001: Expected 2 values, found 3.");
+}
+
+TEST_F(DatasetCSVTests, writeAndRead_roundTrip)
+{
+  Dataset const reals(std::vector<double>{0.1, -2.5e-300, 1.0 / 3.0, 1e22, -0.0, 42.0}, 3);
+  DatasetCSV::Options options;
+  options.header = {"open", "high", "low"};
+  std::ostringstream stream;
+  DatasetCSV::write(reals, stream, options);
+  EXPECT_EQ(stream.str().substr(0, 29), "open,high,low\n0.1,-2.5e-300,0");
+
+  auto const path = (std::filesystem::temp_directory_path() / "libd_datasetcsvtests.csv").string();
+  DatasetCSV::write(reals, path, options);
+  options.skipHeader = true;
+  EXPECT_EQ(DatasetCSV::read(path, options), reals);
+
+  Dataset const bytes(std::vector<int8_t>{-128, 0, 127});
+  DatasetCSV::write(bytes, path);
+  EXPECT_EQ(DatasetCSV::read(path, withType(Dataset::Type::INT8)), bytes);
+  std::remove(path.c_str());
+
+  D_EXPECT_THROW(DatasetCSV::write(reals, "/nonexistent/libd/prices.csv"), "Cannot write CSV file");
+}
@@ -0,0 +1,164 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include "libdutil/datasetfile.h"
+#include "libdutil/mappedfile.h"
+#include "tests/testbase.h"
+
+using namespace DUTIL;
+
+namespace {
+class DatasetFileTests : public TestBase
+{
+  protected:
+  void TearDown() override { std::remove(path.c_str()); }
+
+  std::string const path = (std::filesystem::temp_directory_path() / "libd_datasetfiletests.dds").string();
+};
+
+template <typename TYPE>
+void expectRoundTrip(std::string const& path, std::vector<TYPE> values, label_t cols)
+{
+  Dataset const ds(values, cols);
+  DatasetFile::write(ds, path);
+  Dataset const loaded = DatasetFile::load(path);
+  EXPECT_EQ(loaded, ds);
+  EXPECT_EQ(loaded.getType(), Dataset::TypeMap<TYPE>());
+  EXPECT_EQ(loaded.getCols(), cols);
+  EXPECT_EQ(loaded.getValues<TYPE>(), values);
+  EXPECT_TRUE(loaded.isExternal());
+  EXPECT_TRUE(DatasetFile::verify(path));
+}
+}  // namespace
+
+TEST_F(DatasetFileTests, writeAndLoad_allTypes)
+{
+  expectRoundTrip<int8_t>(path, {-128, 0, 127, 5}, 2);
+  expectRoundTrip<uint8_t>(path, {0, 255, 7}, 3);
+  expectRoundTrip<int16_t>(path, {-32768, 32767}, 1);
+  expectRoundTrip<uint16_t>(path, {65535, 1, 2, 3, 4, 5}, 3);
+  expectRoundTrip<int32_t>(path, {-7, 8}, 2);
+  expectRoundTrip<uint32_t>(path, {4294967295u}, 1);
+  expectRoundTrip<int64_t>(path, {-9223372036854775807, 42}, 1);
+  expectRoundTrip<uint64_t>(path, {18446744073709551615u, 0}, 2);
+  expectRoundTrip<float>(path, {1.5f, -2.25f, 3.0f, 4.0f}, 2);
+  expectRoundTrip<double>(path, {0.1, 0.2, 0.3}, 3);
+
+  DatasetFile::write(Dataset(), path);
+  Dataset const empty = DatasetFile::load(path);
+  EXPECT_EQ(empty.getType(), Dataset::Type::EMPTY);
+  EXPECT_EQ(empty, Dataset());
+}
+
+TEST_F(DatasetFileTests, write_selectionOfColumns_storesSelectedValues)
+{
+  Dataset const ds(std::vector<int16_t>{1, 2, 3, 4, 5, 6}, 3);
+  DatasetFile::write(ds.columns({2, 0}).rows(1, 2), path);
+  Dataset const loaded = DatasetFile::load(path);
+  EXPECT_EQ(loaded.getCols(), 2);
+  EXPECT_EQ(loaded.getValues<int16_t>(), (std::vector<int16_t>{6, 4}));
+}
+
+TEST_F(DatasetFileTests, write_concurrentWriters_replaceAtomically)
+{
+  // a left over temporary file of an interrupted run does not get in the way
+  std::filesystem::create_directory(path + ".tmp");
+  Dataset const first(std::vector<double>(5000, 1.0), 5);
+  Dataset const second(std::vector<double>(5000, 2.0), 5);
+  std::vector<std::thread> writers;
+  for (Dataset const* ds : {&first, &second}) {
+    writers.emplace_back([this, ds]() {
+      for (int i = 0; i < 20; ++i) {
+        DatasetFile::write(*ds, path);
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  EXPECT_TRUE(DatasetFile::verify(path));
+  Dataset const loaded = DatasetFile::load(path);
+  EXPECT_TRUE(loaded == first || loaded == second);
+
+  std::filesystem::remove(path + ".tmp");
+  for (auto const& entry : std::filesystem::directory_iterator(std::filesystem::path(path).parent_path())) {
+    std::string const name = entry.path().string();
+    EXPECT_FALSE(name != path && name.rfind(path, 0) == 0) << "left over file " << name;
+  }
+}
+
+TEST_F(DatasetFileTests, load_largeFile_wrapsMappingWithoutCopy)
+{
+  std::vector<double> values(100000);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    values[i] = 0.5 * double(i);
+  }
+  DatasetFile::write(Dataset(values, 4), path);
+  ASSERT_GT(std::filesystem::file_size(path), MappedFile::mappingThreshold);
+
+  DatasetFile::Header const header = DatasetFile::readHeader(path);
+  EXPECT_EQ(header.type, Dataset::Type::FLOAT64);
+  EXPECT_EQ(header.rows, 25000u);
+  EXPECT_EQ(header.cols, 4u);
+  EXPECT_EQ(header.dataOffset % DatasetFile::dataAlignment, 0u);
+  EXPECT_EQ(header.dataSize, values.size() * sizeof(double));
+  EXPECT_EQ(header.checksum, DatasetFile::checksum(values.data(), header.dataSize));
+
+  Dataset loaded = DatasetFile::load(path, true);
+  double const* data = loaded.getRawData<double>();
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(data) % DatasetFile::dataAlignment, 0u);
+  EXPECT_EQ(loaded.getRows(), 25000);
+  EXPECT_EQ(loaded.getValue<double>(24999, 3), 0.5 * 99999);
+  EXPECT_EQ(loaded.getAllocatedSize(), values.size() * sizeof(double));
+
+  // the mapping lives as long as a copy of the Dataset
+  Dataset copy = loaded;
+  loaded = Dataset();
+  EXPECT_EQ(copy.view<double>()(100, 1), 0.5 * 401);
+}
+
+TEST_F(DatasetFileTests, invalidFiles_throw)
+{
+  DatasetFile::write(Dataset(std::vector<int32_t>{1, 2, 3, 4}), path);
+  std::string bytes;
+  {
+    std::ifstream file(path, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  auto const writeBytes = [this](std::string const& content) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+  };
+
+  std::string corrupted = bytes;
+  corrupted.back() ^= 1;
+  writeBytes(corrupted);
+  EXPECT_FALSE(DatasetFile::verify(path));
+  EXPECT_EQ(DatasetFile::load(path).getValue<int32_t>(3, 0), 4 ^ (1 << 24));
+  D_EXPECT_THROW(DatasetFile::load(path, true), "checksum does not match");
+
+  writeBytes(bytes.substr(0, bytes.size() - 1));
+  D_EXPECT_THROW(DatasetFile::load(path), "is truncated");
+  writeBytes("LIBDDSET");
+  D_EXPECT_THROW(DatasetFile::load(path), "is not a Dataset file");
+  writeBytes("x" + bytes.substr(1));
+  D_EXPECT_THROW(DatasetFile::readHeader(path), "is not a Dataset file");
+
+  std::string wrongType = bytes;
+  wrongType[16] = 11;
+  writeBytes(wrongType);
+  D_EXPECT_THROW(DatasetFile::load(path), "unknown data type 11");
+
+  std::string wrongVersion = bytes;
+  wrongVersion[8] = 2;
+  writeBytes(wrongVersion);
+  D_EXPECT_THROW(DatasetFile::load(path), "has version 2");
+
+  std::string wrongSize = bytes;
+  wrongSize[32] = 3;
+  writeBytes(wrongSize);
+  D_EXPECT_THROW(DatasetFile::load(path), "does not match its rows");
+
+  D_EXPECT_THROW(DatasetFile::load("/nonexistent/libd/data.dds"), "Cannot open file");
+  D_EXPECT_THROW(DatasetFile::write(Dataset(1.0), "/nonexistent/libd/data.dds"), "Cannot write Dataset file");
+}
@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "libdutil/datasetrolling.h"
+#include "tests/testbase.h"
+
+using namespace DUTIL;
+
+namespace {
+class DatasetRollingTests : public TestBase
+{};
+
+//! Prices that rise and fall in every column.
+std::vector<double> makePrices(std::size_t rows, std::size_t cols)
+{
+  return TestBase::makeSeries(rows, cols, 100.0, 211, 0.5, 1.0);
+}
+
+//! Recompute every window from scratch.
+template <typename FUNCTION>
+void expectWindows(Dataset const& ds, Dataset const& result, label_t window, FUNCTION const& naive)
+{
+  ASSERT_EQ(result.getType(), Dataset::Type::FLOAT64);
+  ASSERT_EQ(result.getRows(), ds.getRows());
+  ASSERT_EQ(result.getCols(), ds.getCols());
+  for (label_t j = 0; j < ds.getCols(); ++j) {
+    std::vector<double> const column = ds.columns({j}).getValues<double>();
+    for (label_t i = 0; i < ds.getRows(); ++i) {
+      double const value = result.getValue<double>(i, j);
+      if (i + 1 < window) {
+        EXPECT_TRUE(std::isnan(value)) << "row " << i;
+        continue;
+      }
+      std::vector<double> const values(column.begin() + (i + 1 - window), column.begin() + (i + 1));
+      double const expected = naive(values);
+      if (std::isfinite(expected))
+        EXPECT_NEAR(value, expected, 1e-9 * std::abs(expected)) << "row " << i << ", column " << j;
+      else if (std::isnan(expected))
+        EXPECT_TRUE(std::isnan(value)) << "row " << i << ", column " << j;
+      else
+        EXPECT_EQ(value, expected) << "row " << i << ", column " << j;
+    }
+  }
+}
+
+double mean(std::vector<double> const& values)
+{
+  double sum = 0;
+  for (double x : values) {
+    sum += x;
+  }
+  return sum / double(values.size());
+}
+
+double standardDeviation(std::vector<double> const& values)
+{
+  double const m = mean(values);
+  double m2 = 0;
+  for (double x : values) {
+    m2 += (x - m) * (x - m);
+  }
+  return std::sqrt(m2 / double(values.size() - 1));
+}
+
+bool hasNaN(std::vector<double> const& values)
+{
+  return std::any_of(values.begin(), values.end(), [](double x) { return std::isnan(x); });
+}
+
+double minimum(std::vector<double> const& values)
+{
+  return hasNaN(values) ? std::numeric_limits<double>::quiet_NaN() : *std::min_element(values.begin(), values.end());
+}
+
+double maximum(std::vector<double> const& values)
+{
+  return hasNaN(values) ? std::numeric_limits<double>::quiet_NaN() : *std::max_element(values.begin(), values.end());
+}
+}  // namespace
+
+TEST_F(DatasetRollingTests, windows_matchNaiveComputation)
+{
+  for (label_t window : {1, 2, 5, 64}) {
+    for (std::size_t cols : {1u, 3u}) {
+      Dataset const ds(makePrices(300, cols), label_t(cols));
+      expectWindows(ds, DatasetRolling::mean(ds, window), window, mean);
+      expectWindows(ds, DatasetRolling::max(ds, window), window, maximum);
+      if (window > 1)
+        expectWindows(ds, DatasetRolling::standardDeviation(ds, window), window, standardDeviation);
+    }
+  }
+}
+
+TEST_F(DatasetRollingTests, windows_typesSelectionsAndThreads)
+{
+  Dataset const ints(std::vector<int32_t>{5, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5, 8}, 2);
+  std::vector<double> const maxima = DatasetRolling::max(ints, 3).getValues<double>();
+  EXPECT_EQ(std::vector<double>(maxima.begin() + 4, maxima.end()), (std::vector<double>{5, 9, 5, 9, 5, 9, 5, 8}));
+  expectWindows(ints, DatasetRolling::max(ints, 3), 3, maximum);
+  expectWindows(ints, DatasetRolling::min(ints, 2), 2, minimum);
+
+  Dataset const ds(makePrices(500, 20), 20);
+  Dataset const selection = ds.columns(3, 6, 2).rows(100, 500);
+  expectWindows(selection, DatasetRolling::mean(selection, 30), 30, mean);
+
+  // columns are split into groups of 8 for the threads, the results do not depend on them
+  Dataset const wide(makePrices(5000, 20), 20);
+  EXPECT_EQ(DatasetRolling::standardDeviation(wide, 50, 3).rows(49, 5000),
+            DatasetRolling::standardDeviation(wide, 50, 1).rows(49, 5000));
+  expectWindows(wide, DatasetRolling::min(wide, 100, 3), 100, minimum);
+
+  Dataset const all = DatasetRolling::mean(ds, 1000);
+  EXPECT_TRUE(std::isnan(all.getValue<double>(499, 19)));
+  EXPECT_EQ(DatasetRolling::mean(Dataset(), 3).getType(), Dataset::Type::EMPTY);
+  D_EXPECT_THROW(DatasetRolling::mean(ds, 0), "Rolling window must be positive, got 0.");
+  D_EXPECT_THROW(DatasetRolling::standardDeviation(ds, 1), "Rolling window of a standard deviation must be at least 2, got 1.");
+}
+
+TEST_F(DatasetRollingTests, windows_longerThanTheSeries)
+{
+  // the state only grows with the rows, a huge window must not allocate for its full length
+  Dataset const ds(std::vector<double>{4, 1, 3, 2, 8, 5, 6, 7}, 2);
+  label_t const window = label_t(1) << 30;
+  for (Dataset const& result : {DatasetRolling::mean(ds, window), DatasetRolling::standardDeviation(ds, window),
+                                DatasetRolling::min(ds, window), DatasetRolling::max(ds, window)}) {
+    ASSERT_EQ(result.getRows(), 4);
+    for (double value : result.getValues<double>()) {
+      EXPECT_TRUE(std::isnan(value));
+    }
+  }
+  expectWindows(ds, DatasetRolling::max(ds, 5), 5, maximum);
+  expectWindows(ds, DatasetRolling::standardDeviation(ds, 5), 5, standardDeviation);
+
+  Dataset const none = DatasetRolling::mean(ds.rows(0, 0), 3);
+  EXPECT_EQ(none.getType(), Dataset::Type::FLOAT64);
+  EXPECT_EQ(none.getRows(), 0);
+  EXPECT_EQ(none.getCols(), 2);
+}
+
+TEST_F(DatasetRollingTests, windows_nonFiniteValuesOnlyAffectTheirWindows)
+{
+  std::vector<double> prices = makePrices(200, 2);
+  double const infinity = std::numeric_limits<double>::infinity();
+  prices[2 * 50] = std::numeric_limits<double>::quiet_NaN();
+  prices[2 * 120] = infinity;
+  prices[2 * 80 + 1] = infinity;
+  prices[2 * 83 + 1] = -infinity;
+  prices[2 * 150 + 1] = -infinity;
+  Dataset const ds(prices, 2);
+  for (label_t window : {2, 5, 20}) {
+    Dataset const means = DatasetRolling::mean(ds, window);
+    expectWindows(ds, means, window, mean);
+    expectWindows(ds, DatasetRolling::standardDeviation(ds, window), window, standardDeviation);
+    expectWindows(ds, DatasetRolling::min(ds, window), window, minimum);
+    expectWindows(ds, DatasetRolling::max(ds, window), window, maximum);
+    EXPECT_TRUE(std::isnan(means.getValue<double>(50, 0)));
+    EXPECT_TRUE(std::isfinite(means.getValue<double>(50 + window, 0)));
+  }
+  // a NaN is neither skipped nor does it clear the values before it
+  Dataset const gap(std::vector<double>{5, 1, std::nan(""), 3, 4, 2});
+  EXPECT_TRUE(std::isnan(DatasetRolling::min(gap, 3).getValue<double>(3, 0)));
+  EXPECT_EQ(DatasetRolling::min(gap, 3).getValue<double>(5, 0), 2.0);
+  EXPECT_EQ(DatasetRolling::max(gap, 3).getValue<double>(5, 0), 4.0);
+}
+
+TEST_F(DatasetRollingTests, emaAndReturns)
+{
+  Dataset const ds(std::vector<float>{100, 10, 110, 20, 99, 30, 108.9f, 60}, 2);
+  EXPECT_EQ(DatasetRolling::ema(ds, 1.0), Dataset(ds.getValues<double>(), 2));
+  std::vector<double> const ema = DatasetRolling::ema(ds, 0.5).getValues<double>();
+  EXPECT_EQ(ema, (std::vector<double>{100, 10, 105, 15, 102, 22.5, 0.5 * (102 + double(108.9f)), 41.25}));
+
+  std::vector<double> const returns = DatasetRolling::returns(ds).getValues<double>();
+  EXPECT_TRUE(std::isnan(returns[0]) && std::isnan(returns[1]));
+  EXPECT_NEAR(returns[2], 0.1, 1e-12);
+  EXPECT_NEAR(returns[3], 1.0, 1e-12);
+  EXPECT_NEAR(returns[4], -0.1, 1e-12);
+  EXPECT_NEAR(returns[5], 0.5, 1e-12);
+
+  std::vector<double> const logReturns = DatasetRolling::logReturns(ds, 2).getValues<double>();
+  EXPECT_TRUE(std::isnan(logReturns[3]));
+  EXPECT_NEAR(logReturns[4], std::log(0.99), 1e-12);
+  EXPECT_NEAR(logReturns[7], std::log(3.0), 1e-12);
+
+  // a NaN value spoils all later rows of its column only
+  Dataset const gap(std::vector<double>{1, 10, std::nan(""), 20, 3, 30}, 2);
+  std::vector<double> const gapEma = DatasetRolling::ema(gap, 0.5).getValues<double>();
+  EXPECT_TRUE(std::isnan(gapEma[2]) && std::isnan(gapEma[4]));
+  EXPECT_EQ(gapEma[5], 22.5);
+
+  D_EXPECT_THROW(DatasetRolling::ema(ds, 0.0), "Smoothing factor alpha must be in (0, 1]");
+  D_EXPECT_THROW(DatasetRolling::returns(ds, 0), "Lag of returns must be positive");
+}
+
+TEST_F(DatasetRollingTests, longSeries_staysAccurate)
+{
+  // running sums over a long series with a large offset must not drift
+  std::size_t const rows = 200000;
+  std::vector<double> prices(rows);
+  for (std::size_t i = 0; i < rows; ++i) {
+    prices[i] = 1e6 + double((i * 37) % 1000) * 1e-3;
+  }
+  Dataset const ds(prices);
+  Dataset const means = DatasetRolling::mean(ds, 10);
+  Dataset const deviations = DatasetRolling::standardDeviation(ds, 10);
+  for (std::size_t last : {rows - 5, rows - 1}) {
+    std::vector<double> const window(prices.begin() + std::ptrdiff_t(last - 9), prices.begin() + std::ptrdiff_t(last + 1));
+    EXPECT_NEAR(means.getValue<double>(label_t(last), 0), mean(window), 1e-9);
+    EXPECT_NEAR(deviations.getValue<double>(label_t(last), 0), standardDeviation(window), 1e-8);
+  }
+}
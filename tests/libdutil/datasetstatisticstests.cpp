@@ -0,0 +1,170 @@
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "libdutil/datasetstatistics.h"
+#include "libdutil/simd.h"
+#include "tests/testbase.h"
+
+using namespace DUTIL;
+
+namespace {
+class DatasetStatisticsTests : public TestBase
+{
+  protected:
+  void TearDown() override { SIMD::setActiveInstructionSet(SIMD::supportedInstructionSet()); }
+};
+
+//! Values that differ in every column and row, with a large offset to challenge the variance.
+std::vector<double> makeValues(std::size_t rows, std::size_t cols)
+{
+  return TestBase::makeSeries(rows, cols, 1e6, 1009, 0.25, -1.0);
+}
+
+//! Compare with a two pass computation column by column.
+void expectStatistics(Dataset const& ds, std::vector<DatasetStatistics::Column> const& columns)
+{
+  ASSERT_EQ(columns.size(), std::size_t(ds.getCols()));
+  for (label_t j = 0; j < ds.getCols(); ++j) {
+    std::vector<double> const column = ds.columns({j}).getValues<double>();
+    double sum = 0;
+    for (double x : column) {
+      sum += x;
+    }
+    double const mean = sum / double(column.size());
+    double m2 = 0;
+    for (double x : column) {
+      m2 += (x - mean) * (x - mean);
+    }
+    auto const& result = columns[std::size_t(j)];
+    EXPECT_EQ(result.count, ds.getRows());
+    EXPECT_NEAR(result.sum, sum, 1e-12 * std::abs(sum));
+    EXPECT_NEAR(result.mean, mean, 1e-12 * std::abs(mean));
+    EXPECT_NEAR(result.variance, m2 / double(column.size() - 1), 1e-9 * m2 / double(column.size()));
+    EXPECT_EQ(result.min, *std::min_element(column.begin(), column.end()));
+    EXPECT_EQ(result.max, *std::max_element(column.begin(), column.end()));
+  }
+}
+}  // namespace
+
+TEST_F(DatasetStatisticsTests, compute_smallDataset)
+{
+  Dataset const ds(std::vector<int32_t>{1, 10, 2, 20, 3, 30, 6, 60}, 2);
+  auto const columns = DatasetStatistics::compute(ds);
+  ASSERT_EQ(columns.size(), 2u);
+  EXPECT_EQ(columns[0].count, 4);
+  EXPECT_EQ(columns[0].sum, 12.0);
+  EXPECT_EQ(columns[0].min, 1.0);
+  EXPECT_EQ(columns[0].max, 6.0);
+  EXPECT_EQ(columns[0].mean, 3.0);
+  EXPECT_DOUBLE_EQ(columns[0].variance, 14.0 / 3.0);
+  EXPECT_EQ(columns[1].sum, 120.0);
+  EXPECT_DOUBLE_EQ(columns[1].variance, 1400.0 / 3.0);
+
+  auto const single = DatasetStatistics::compute(Dataset(2.5f));
+  EXPECT_EQ(single[0].mean, 2.5);
+  EXPECT_TRUE(std::isnan(single[0].variance));
+  EXPECT_TRUE(DatasetStatistics::compute(Dataset()).empty());
+
+  // min and max are NaN without any value other than NaN
+  double const nan = std::numeric_limits<double>::quiet_NaN();
+  Dataset const gaps(std::vector<double>{nan, 4, nan, -2, nan, 7}, 2);
+  auto const partial = DatasetStatistics::compute(gaps);
+  EXPECT_TRUE(std::isnan(partial[0].min));
+  EXPECT_TRUE(std::isnan(partial[0].max));
+  EXPECT_EQ(partial[1].min, -2.0);
+  EXPECT_EQ(partial[1].max, 7.0);
+  auto const none = DatasetStatistics::compute(gaps.rows(1, 1));
+  ASSERT_EQ(none.size(), 2u);
+  EXPECT_EQ(none[1].count, 0);
+  EXPECT_TRUE(std::isnan(none[1].min));
+  EXPECT_TRUE(std::isnan(none[1].max));
+}
+
+TEST_F(DatasetStatisticsTests, compute_columnCountsTypesAndSelections)
+{
+  for (std::size_t cols : {1u, 3u, 16u, 40u}) {
+    Dataset const ds(makeValues(1000, cols), label_t(cols));
+    expectStatistics(ds, DatasetStatistics::compute(ds));
+    expectStatistics(ds.rows(17, 900), DatasetStatistics::compute(ds.rows(17, 900)));
+  }
+  Dataset const ds(makeValues(999, 6), 6);
+  for (Dataset const& selection : {ds.columns(1, 3), ds.columns(5, 3, -2), ds.columns({4})}) {
+    expectStatistics(selection, DatasetStatistics::compute(selection, DatasetStatistics::Summation::KAHAN));
+  }
+  Dataset const floats(std::vector<float>{0.5f, -1.5f, 8.0f});
+  expectStatistics(floats, DatasetStatistics::compute(floats));
+  Dataset const bytes(std::vector<uint8_t>(700, 255), 7);
+  expectStatistics(bytes, DatasetStatistics::compute(bytes));
+}
+
+TEST_F(DatasetStatisticsTests, compute_summationsAndThreads)
+{
+  std::vector<double> tenths(std::size_t(1) << 20, 0.1);
+  Dataset const ds(std::move(tenths), 2);
+  double const exact = 0.1 * double(std::size_t(1) << 19);
+  double const plain = DatasetStatistics::compute(ds, DatasetStatistics::Summation::PLAIN)[0].sum;
+  for (auto summation : {DatasetStatistics::Summation::KAHAN, DatasetStatistics::Summation::PAIRWISE}) {
+    // the sums of the ranges of several threads are added with the summation as well
+    for (unsigned threads : {1u, 4u}) {
+      double const stable = DatasetStatistics::compute(ds, summation, threads)[1].sum;
+      EXPECT_LE(std::abs(stable - exact), std::abs(plain - exact));
+      EXPECT_NEAR(stable, exact, 1e-9);
+    }
+  }
+
+  // threads work on whole blocks, more threads give nearly the same results
+  Dataset const large(makeValues(200000, 3), 3);
+  auto const one = DatasetStatistics::compute(large, DatasetStatistics::Summation::PAIRWISE, 1);
+  auto const three = DatasetStatistics::compute(large, DatasetStatistics::Summation::PAIRWISE, 3);
+  expectStatistics(large, three);
+  for (std::size_t j = 0; j < 3; ++j) {
+    EXPECT_EQ(one[j].min, three[j].min);
+    EXPECT_NEAR(one[j].sum, three[j].sum, 1e-12 * one[j].sum);
+    EXPECT_NEAR(one[j].variance, three[j].variance, 1e-10 * one[j].variance);
+  }
+}
+
+TEST_F(DatasetStatisticsTests, compute_sameResultsForAllInstructionSets)
+{
+  Dataset const ds(makeValues(3001, 5), 5);
+  auto const expected = DatasetStatistics::compute(ds);
+  for (label_t set = SIMD::InstructionSet::SCALAR; set <= SIMD::supportedInstructionSet(); ++set) {
+    SIMD::setActiveInstructionSet(SIMD::InstructionSet(set));
+    auto const columns = DatasetStatistics::compute(ds);
+    for (std::size_t j = 0; j < columns.size(); ++j) {
+      EXPECT_EQ(columns[j].sum, expected[j].sum);
+      EXPECT_EQ(columns[j].variance, expected[j].variance);
+    }
+  }
+}
+
+TEST_F(DatasetStatisticsTests, covariance_matchesTwoPassComputation)
+{
+  std::size_t const rows = 1500;
+  std::vector<double> values(rows * 3);
+  for (std::size_t i = 0; i < rows; ++i) {
+    double const x = double((i * 37) % 101);
+    values[3 * i] = 1e5 + x;
+    values[3 * i + 1] = -2 * x + double(i % 7);
+    values[3 * i + 2] = double(i % 13);
+  }
+  Dataset const ds(values, 3);
+  Dataset const covariance = DatasetStatistics::covariance(ds);
+  EXPECT_EQ(covariance.getRows(), 3);
+  EXPECT_EQ(covariance.getCols(), 3);
+
+  auto const columns = DatasetStatistics::compute(ds);
+  for (label_t j = 0; j < 3; ++j) {
+    for (label_t k = 0; k < 3; ++k) {
+      double expected = 0;
+      for (std::size_t i = 0; i < rows; ++i) {
+        expected += (values[3 * i + std::size_t(j)] - columns[std::size_t(j)].mean)
+                    * (values[3 * i + std::size_t(k)] - columns[std::size_t(k)].mean);
+      }
+      expected /= double(rows - 1);
+      EXPECT_NEAR(covariance.getValue<double>(j, k), expected, 1e-9 * std::abs(expected) + 1e-9);
+    }
+    EXPECT_NEAR(covariance.getValue<double>(j, j), columns[std::size_t(j)].variance, 1e-9);
+  }
+  EXPECT_EQ(DatasetStatistics::covariance(Dataset()).getType(), Dataset::Type::EMPTY);
+}
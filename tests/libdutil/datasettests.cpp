@@ -1,3 +1,4 @@
+#include <thread>
 #include "libd/libdutil/constructiondata.h"
 #include "libd/libdutil/dataset.h"
 #include "libd/tests/testbase.h"
@@ -28,6 +29,40 @@ TEST_F(DatasetTests, TypeMap_forLong_returnsEitherInt64OrInt32)
     ASSERT_TRUE(Dataset::Type::INT32 == Dataset::TypeMap<long>() || Dataset::Type::INT64 == Dataset::TypeMap<long>());
 }
 
+TEST_F(DatasetTests, dispatch_forKnownTypes_passesMatchingTypeTag)
+{
+    for (auto t : {Dataset::Type::INT8, Dataset::Type::UINT16, Dataset::Type::INT64, Dataset::Type::FLOAT32,
+                   Dataset::Type::FLOAT64}) {
+        auto mapped = Dataset::dispatch(t, [](auto tag) { return Dataset::TypeMap<typename decltype(tag)::type>(); });
+        ASSERT_EQ(t, mapped);
+    }
+    D_EXPECT_THROW(Dataset::dispatch(Dataset::Type::EMPTY, [](auto) { return 0; }), "has no value type");
+}
+
+TEST_F(DatasetTests, visit_typedDataset_passesTypedView)
+{
+    Dataset ds(std::vector<int16_t>{1, -2, 3});
+    auto sum = ds.visit([](auto const& view) {
+        using T = typename std::decay_t<decltype(view)>::value_type;
+        EXPECT_TRUE((std::is_same_v<T, int16_t>));
+        double result = 0;
+        for (label_t i = 0; i < view.rows(); ++i) {
+            result += view.at(i, 0);
+        }
+        return result;
+    });
+    ASSERT_EQ(2.0, sum);
+    D_EXPECT_THROW(Dataset().visit([](auto const&) { return 0; }), "has no value type");
+}
+
+TEST_F(DatasetTests, getAllocatedSize_emptyAndTypedDatasets_countValueBytes)
+{
+    // EMPTY is handled before dispatching, which would throw
+    EXPECT_EQ(0u, Dataset().getAllocatedSize());
+    Dataset ds(std::vector<int16_t>{1, -2, 3});
+    EXPECT_EQ(3 * sizeof(int16_t), ds.getAllocatedSize());
+}
+
 TEST_F(DatasetTests, defaultConstruct_propertiesAsExpected)
 {
     Dataset dt;
@@ -569,3 +604,255 @@ TEST_F(DatasetTests, equality_identicalValuesContentForFLOAT64_returnsTrue)
 {
     ASSERT_EQ(Dataset(std::vector<double>{2.3, 6.4}), Dataset(std::vector<double>{2.3, 6.4}));
 }
+
+TEST_F(DatasetTests, externalBuffer_isWrappedWithoutCopy_andReleasedWithLastCopy)
+{
+    int released = 0;
+    double* buffer = new double[6]{1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    {
+        Dataset ds(buffer, 6, std::shared_ptr<void const>(buffer, [&released](void const* p) {
+                       ++released;
+                       delete[] static_cast<double const*>(p);
+                   }),
+                   3);
+        EXPECT_TRUE(ds.isExternal());
+        EXPECT_EQ(ds.getType(), Dataset::Type::FLOAT64);
+        EXPECT_EQ(ds.getRows(), 2);
+        EXPECT_EQ(ds.getRawData<double>(), buffer);
+        EXPECT_EQ(ds.getValue<double>(1, 2), 6.0);
+        EXPECT_EQ(ds.getAllocatedSize(), 6 * sizeof(double));
+        EXPECT_EQ(ds.getNumberOfCurrentlyStoredData(), 6 * sizeof(double));
+
+        // values are copied on request only
+        EXPECT_EQ(ds.getValues<double>(), (std::vector<double>{1.0, 2.0, 3.0, 4.0, 5.0, 6.0}));
+        EXPECT_EQ(ds.getValues<int>(), (std::vector<int>{1, 2, 3, 4, 5, 6}));
+        EXPECT_NE(ds.getPointerToValues<double>()->data(), buffer);
+
+        Dataset copy = ds;
+        ds = Dataset();
+        EXPECT_EQ(released, 0);
+        EXPECT_EQ(copy.getRawData<double>(), buffer);
+        EXPECT_EQ(copy, Dataset(std::vector<double>{1.0, 2.0, 3.0, 4.0, 5.0, 6.0}, 3));
+    }
+    EXPECT_EQ(released, 1);
+}
+
+TEST_F(DatasetTests, externalBuffer_aliasingOwner_keepsOwnerAlive)
+{
+    auto owner = std::make_shared<std::vector<int16_t>>(std::vector<int16_t>{-1, 2, -3});
+    Dataset ds(owner->data(), owner->size(), owner);
+    std::weak_ptr<std::vector<int16_t>> weak = owner;
+    owner.reset();
+    EXPECT_FALSE(weak.expired());
+    EXPECT_EQ(ds.getValues<int16_t>(), (std::vector<int16_t>{-1, 2, -3}));
+    ds = Dataset();
+    EXPECT_TRUE(weak.expired());
+
+    Dataset empty(static_cast<float const*>(nullptr), 0, nullptr);
+    EXPECT_EQ(empty.getType(), Dataset::Type::EMPTY);
+    EXPECT_FALSE(empty.isExternal());
+}
+
+TEST_F(DatasetTests, externalBuffer_selectionsReportWholeBuffer)
+{
+    // selections keep the whole buffer alive and count it like selections of a vector
+    auto owner = std::make_shared<std::vector<double>>(std::vector<double>{1, 2, 3, 4, 5, 6, 7, 8});
+    Dataset ds(owner->data(), owner->size(), owner, 2);
+    EXPECT_EQ(ds.rows(1, 2).getAllocatedSize(), 8 * sizeof(double));
+    EXPECT_EQ(ds.columns({1}).getAllocatedSize(), 8 * sizeof(double));
+    EXPECT_EQ(ds.rows(1, 2).getNumberOfCurrentlyStoredData(), 2 * sizeof(double));
+
+    Dataset vector(std::vector<double>(8, 1.0), 2);
+    EXPECT_EQ(vector.rows(1, 2).getAllocatedSize(), ds.rows(1, 2).getAllocatedSize());
+}
+
+TEST_F(DatasetTests, vectorConstructor_movesValuesIn)
+{
+    std::vector<float> values(1000, 0.5f);
+    float const* data = values.data();
+    Dataset ds(std::move(values), 10);
+    EXPECT_FALSE(ds.isExternal());
+    EXPECT_EQ(ds.getRawData<float>(), data);
+    EXPECT_EQ(ds.getPointerToValues<float>()->data(), data);
+    EXPECT_EQ(ds.getRows(), 100);
+}
+
+TEST_F(DatasetTests, getRawData_checksType)
+{
+    Dataset ds(std::vector<int32_t>{1, 2});
+    EXPECT_EQ(ds.getRawData<int32_t>()[1], 2);
+    D_EXPECT_THROW(ds.getRawData<int64_t>(), "requested type is INT64");
+    EXPECT_EQ(Dataset().getRawData<double>(), nullptr);
+    EXPECT_EQ(Dataset().getAllocatedSize(), 0u);
+}
+
+TEST_F(DatasetTests, view_matchingType_accessesValuesInPlace)
+{
+    Dataset ds(std::vector<int32_t>{1, 2, 3, 4, 5, 6}, 3);
+    DatasetView<int32_t> v = ds.view<int32_t>();
+    EXPECT_EQ(v.data(), ds.getRawData<int32_t>());
+    EXPECT_EQ(v.rows(), 2);
+    EXPECT_EQ(v.cols(), 3);
+    EXPECT_EQ(v.rowStride(), 3);
+    EXPECT_EQ(v.colStride(), 1);
+    EXPECT_EQ(v.size(), 6u);
+    EXPECT_TRUE(v.isContiguous());
+    EXPECT_EQ(v(1, 2), 6);
+    EXPECT_EQ(v.at(0, 1), 2);
+    D_EXPECT_THROW(v.at(2, 0), "illegal row index 2");
+    D_EXPECT_THROW(v.at(0, 3), "illegal column index 3");
+
+    DatasetView<int32_t> column = v.column(1);
+    EXPECT_EQ(column.rows(), 2);
+    EXPECT_EQ(column.cols(), 1);
+    EXPECT_EQ(column(0, 0), 2);
+    EXPECT_EQ(column(1, 0), 5);
+    EXPECT_FALSE(column.isContiguous());
+    DatasetView<int32_t> row = v.row(1);
+    EXPECT_EQ(row.at(0, 2), 6);
+    EXPECT_TRUE(row.isContiguous());
+    D_EXPECT_THROW(v.column(3), "illegal column index");
+}
+
+TEST_F(DatasetTests, view_otherType_throws)
+{
+    Dataset ds(std::vector<float>{1.5f, 2.5f});
+    D_EXPECT_THROW(ds.view<double>(), "requested type is FLOAT64");
+    EXPECT_TRUE(Dataset().view<double>().empty());
+    EXPECT_EQ(Dataset().view<double>().data(), nullptr);
+}
+
+TEST_F(DatasetTests, getValue_otherType_convertsSingleItem)
+{
+    Dataset ds(std::vector<float>{1.5f, -2.5f, 3.0f, 4.0f}, 2);
+    EXPECT_EQ(ds.getValue<double>(0, 1), -2.5);
+    EXPECT_EQ(ds.getValue<int64_t>(1, 0), 3);
+    D_EXPECT_THROW(ds.getValue<double>(2, 0), "illegal row index");
+}
+
+TEST_F(DatasetTests, conversionCache_convertsOncePerType)
+{
+    Dataset ds(std::vector<float>{1.5f, 2.5f, 3.5f, 4.5f}, 2);
+    EXPECT_NE(ds.getPointerToValues<double>(), ds.getPointerToValues<double>());
+    EXPECT_EQ(ds.getAllocatedSize(), 4 * sizeof(float));
+
+    ds.enableConversionCache();
+    EXPECT_TRUE(ds.hasConversionCache());
+    auto doubles = ds.getPointerToValues<double>();
+    EXPECT_EQ(*doubles, (std::vector<double>{1.5, 2.5, 3.5, 4.5}));
+    EXPECT_EQ(ds.getPointerToValues<double>(), doubles);
+    EXPECT_EQ(ds.getValues<double>(), *doubles);
+    EXPECT_EQ(ds.getAllocatedSize(), 4 * sizeof(float) + 4 * sizeof(double));
+
+    // the stored type needs no conversion and is not cached
+    EXPECT_EQ(ds.getPointerToValues<float>()->data(), ds.getRawData<float>());
+    EXPECT_EQ(ds.getAllocatedSize(), 4 * sizeof(float) + 4 * sizeof(double));
+
+    // copies share the cache
+    Dataset copy = ds;
+    EXPECT_EQ(copy.getPointerToValues<double>(), doubles);
+    auto ints = copy.getPointerToValues<int32_t>();
+    EXPECT_EQ(ds.getPointerToValues<int32_t>(), ints);
+    EXPECT_EQ(ds.getAllocatedSize(), 4 * sizeof(float) + 4 * sizeof(double) + 4 * sizeof(int32_t));
+}
+
+TEST_F(DatasetTests, conversionCache_externalValuesAndConcurrentReaders)
+{
+    auto owner = std::make_shared<std::vector<int32_t>>(std::vector<int32_t>(1000, 7));
+    Dataset ds(owner->data(), owner->size(), owner);
+    ds.enableConversionCache();
+    auto copy = ds.getPointerToValues<int32_t>();
+    EXPECT_NE(copy->data(), owner->data());
+    EXPECT_EQ(ds.getPointerToValues<int32_t>(), copy);
+
+    std::vector<std::shared_ptr<const std::vector<double>>> results(4);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < results.size(); ++t) {
+        threads.emplace_back([&ds, &results, t]() { results[t] = ds.getPointerToValues<double>(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (auto const& result : results) {
+        EXPECT_EQ(result, results.front());
+    }
+    EXPECT_EQ(results.front()->at(999), 7.0);
+}
+
+TEST_F(DatasetTests, rows_sharesValuesOfRange)
+{
+    Dataset ds(std::vector<int32_t>{1, 2, 3, 4, 5, 6, 7, 8}, 2);
+    Dataset middle = ds.rows(1, 3);
+    EXPECT_EQ(middle.getRows(), 2);
+    EXPECT_EQ(middle.getCols(), 2);
+    EXPECT_TRUE(middle.isContiguous());
+    EXPECT_EQ(middle.getRawData<int32_t>(), ds.getRawData<int32_t>() + 2);
+    EXPECT_EQ(middle.getUseCount(), 2);
+    EXPECT_EQ(middle.getValue<int32_t>(1, 1), 6);
+    D_EXPECT_THROW(middle.getValue<int32_t>(2, 0), "illegal row index 2");
+    EXPECT_EQ(middle.getValues<int32_t>(), (std::vector<int32_t>{3, 4, 5, 6}));
+    EXPECT_EQ(middle.rows(1, 2).getValues<double>(), (std::vector<double>{5, 6}));
+    EXPECT_EQ(middle, Dataset(std::vector<int32_t>{3, 4, 5, 6}, 2));
+
+    Dataset const none = ds.rows(4, 4);
+    EXPECT_EQ(none.getType(), Dataset::Type::INT32);
+    EXPECT_EQ(none.getRows(), 0);
+    EXPECT_EQ(none.getCols(), 2);
+    EXPECT_TRUE(none.getValues<double>().empty());
+    EXPECT_EQ(none.columns({1}).getType(), Dataset::Type::INT32);
+    EXPECT_EQ(none, ds.rows(1, 1));
+    EXPECT_EQ(ds.rows(0, 4).getRawData<int32_t>(), ds.getRawData<int32_t>());
+    D_EXPECT_THROW(ds.rows(3, 5), "illegal row range [3, 5), number of rows is currently 4");
+    D_EXPECT_THROW(ds.rows(2, 1), "illegal row range");
+}
+
+TEST_F(DatasetTests, columns_stridedSelectionsShareValues)
+{
+    Dataset ds(std::vector<double>{1, 2, 3, 4, 5, 6, 7, 8, 9}, 3);
+    Dataset last = ds.columns({2});
+    EXPECT_EQ(last.getCols(), 1);
+    EXPECT_FALSE(last.isContiguous());
+    EXPECT_EQ(last.view<double>().data(), ds.getRawData<double>() + 2);
+    EXPECT_EQ(last.view<double>().rowStride(), 3);
+    EXPECT_EQ(last.getValues<double>(), (std::vector<double>{3, 6, 9}));
+    D_EXPECT_THROW(last.getRawData<double>(), "Dataset values are not contiguous");
+
+    Dataset reversed = ds.columns({2, 1, 0}).rows(1, 3);
+    EXPECT_EQ(reversed.getValues<int32_t>(), (std::vector<int32_t>{6, 5, 4, 9, 8, 7}));
+    EXPECT_EQ(reversed.getValue<double>(1, 2), 7);
+    EXPECT_EQ(ds.columns(0, 2, 2).getValues<float>(), (std::vector<float>{1, 3, 4, 6, 7, 9}));
+    EXPECT_EQ(ds.columns(1, 2).columns({1}).getValues<double>(), (std::vector<double>{3, 6, 9}));
+    EXPECT_EQ(ds.columns(0, 3), ds);
+    D_EXPECT_THROW(ds.columns(1, 3), "illegal selection of 3 columns from column 1 with step 1");
+    D_EXPECT_THROW(ds.columns({}), "no columns selected");
+}
+
+TEST_F(DatasetTests, columns_unevenSelectionIsCopied)
+{
+    Dataset ds(std::vector<uint8_t>{1, 2, 3, 4, 5, 6, 7, 8}, 4);
+    Dataset picked = ds.columns(std::vector<label_t>{3, 0, 1});
+    EXPECT_TRUE(picked.isContiguous());
+    EXPECT_EQ(picked.getUseCount(), 1);
+    EXPECT_EQ(picked.getValues<uint8_t>(), (std::vector<uint8_t>{4, 1, 2, 8, 5, 6}));
+    D_EXPECT_THROW(ds.columns({0, 1, 4}), "illegal column index 4");
+}
+
+TEST_F(DatasetTests, slices_cacheAndContiguousCopy)
+{
+    Dataset ds(std::vector<float>{1, 2, 3, 4, 5, 6}, 2);
+    ds.enableConversionCache();
+    Dataset column = ds.columns({1});
+    EXPECT_FALSE(column.hasConversionCache());
+    column.enableConversionCache();
+    auto floats = column.getPointerToValues<float>();
+    EXPECT_EQ(*floats, (std::vector<float>{2, 4, 6}));
+    EXPECT_EQ(column.getPointerToValues<float>(), floats);
+    EXPECT_EQ(ds.getPointerToValues<float>()->size(), 6u);
+
+    Dataset copy = column.contiguous();
+    EXPECT_TRUE(copy.isContiguous());
+    EXPECT_EQ(copy, column);
+    EXPECT_EQ(copy.getRawData<float>()[2], 6.0f);
+    Dataset rows = ds.rows(1, 2);
+    EXPECT_EQ(rows.contiguous().getRawData<float>(), rows.getRawData<float>());
+}
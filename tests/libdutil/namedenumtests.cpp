@@ -79,6 +79,16 @@ TEST_F(NamedEnumTests, testConstructionWorksAsExpected)
     EXPECT_THAT(result, testing::HasSubstr("is not registered as an enum value"));
     result = D_EXPECT_THROW(TestDummy::WEEKDAY e_wd(100), "Attempted initialization of named enum");
     EXPECT_THAT(result, testing::HasSubstr("Attempted initialization of named enum"));
+    D_EXPECT_THROW(TestDummy::WEEKDAY e_wd(std::string("HOLIDAY")), "is not registered as an enum value");
+  }
+
+  // strings and variants are looked up alike: surrounding whitespace is ignored, empty names yield
+  // the default value
+  {
+    EXPECT_EQ(TestDummy::WEEKDAY(std::string(" FRIDAY\t")), TestDummy::WEEKDAY::FRIDAY);
+    EXPECT_EQ(TestDummy::WEEKDAY(DUTIL::Variant(" FRIDAY\t")), TestDummy::WEEKDAY::FRIDAY);
+    EXPECT_EQ(TestDummy::WEEKDAY(std::string(" ")), TestDummy::WEEKDAY());
+    EXPECT_EQ(TestDummy::WEEKDAY(DUTIL::Variant("")), TestDummy::WEEKDAY());
   }
 }
 
@@ -178,3 +188,10 @@ TEST_F(NamedEnumTests, testIterateOverEnumValues)
     ASSERT_TRUE(static_cast<int>(colors.size()) == TestDummy::COLOR::size());
   }
 }
+
+TEST_F(NamedEnumTests, testEnumNameHashIsComputedAtCompileTime)
+{
+  static_assert(States::getEnumNameHash() == Hash::fnv1a("States"));
+  EXPECT_EQ(Hash::fnv1a(LIBD::TESTS::TestDummy::COLOR::getEnumName()),
+            LIBD::TESTS::TestDummy::COLOR::getEnumNameHash());
+}
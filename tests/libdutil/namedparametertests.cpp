@@ -116,3 +116,11 @@ TEST_F(NamedParameterTests, testNamedRealWorksAsExpected)
         ASSERT_EQ(var.toReal(), rwn.value());
     }
 }
+
+TEST_F(NamedParameterTests, testParameterNameHashIsComputedAtCompileTime)
+{
+    static_assert(RealWithName::getParameterNameHash() == Hash::fnv1a("RealWithName"));
+    static_assert(StringWithName::getParameterNameHash() == Hash::fnv1a("StringWithName"));
+    static_assert(TestClass::TestClass_Label::getParameterNameHash() != LabelWithName::getParameterNameHash());
+    EXPECT_EQ(Hash::fnv1a(BoolWithName::getParameterName()), BoolWithName::getParameterNameHash());
+}
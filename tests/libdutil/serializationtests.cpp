@@ -0,0 +1,199 @@
+#include "libd/libdutil/serialization.h"
+#include "libd/libdutil/settingrule.h"
+#include "libd/libdutil/settings.h"
+#include "tests/libtesting/testdummy.h"
+#include "tests/testbase.h"
+
+#include <limits>
+#include <memory_resource>
+#include <string>
+
+using namespace DUTIL;
+
+namespace {
+class SerializationTests : public TestBase
+{};
+
+D_NAMED_ENUM(Shape, CIRCLE, SQUARE, TRIANGLE)
+
+template <typename T>
+T roundTrip(T const& object)
+{
+  ByteBuffer buffer;
+  BinaryWriter writer(buffer);
+  object.serialize(writer);
+  BinaryReader reader(buffer);
+  T result = T::deserialize(reader);
+  EXPECT_TRUE(reader.atEnd());
+  return result;
+}
+}  // namespace
+
+TEST_F(SerializationTests, testVarintEncoding)
+{
+  ByteBuffer buffer;
+  BinaryWriter writer(buffer);
+  writer.writeVarint(0);
+  writer.writeVarint(127);
+  writer.writeVarint(128);
+  writer.writeVarint(std::numeric_limits<std::uint64_t>::max());
+  writer.writeSignedVarint(-1);
+  writer.writeSignedVarint(std::numeric_limits<std::int64_t>::min());
+  writer.writeDouble(-0.125);
+  writer.writeString("abc");
+  // one byte for 0, 127 and -1, two bytes for 128, ten bytes for 64 bit extremes
+  ASSERT_EQ(1u + 1u + 2u + 10u + 1u + 10u + 8u + 4u, buffer.size());
+
+  BinaryReader reader(buffer);
+  EXPECT_EQ(0u, reader.readVarint());
+  EXPECT_EQ(127u, reader.readVarint());
+  EXPECT_EQ(128u, reader.readVarint());
+  EXPECT_EQ(std::numeric_limits<std::uint64_t>::max(), reader.readVarint());
+  EXPECT_EQ(-1, reader.readSignedVarint());
+  EXPECT_EQ(std::numeric_limits<std::int64_t>::min(), reader.readSignedVarint());
+  EXPECT_EQ(-0.125, reader.readDouble());
+  EXPECT_EQ("abc", reader.readString());
+  EXPECT_TRUE(reader.atEnd());
+  D_EXPECT_THROW(reader.readByte(), "truncated");
+
+  // ten bytes may only carry 64 bits
+  ByteBuffer overflow(9, 0xFF);
+  overflow.push_back(0x02);
+  BinaryReader overflowReader(overflow);
+  D_EXPECT_THROW(overflowReader.readVarint(), "Malformed varint");
+}
+
+TEST_F(SerializationTests, testVariantRoundTrip)
+{
+  std::vector<Variant> values{Variant(),
+                              Variant(-42),
+                              Variant(std::int64_t(1) << 40),
+                              Variant(std::numeric_limits<std::uint64_t>::max()),
+                              Variant(3.14159),
+                              Variant(true),
+                              Variant('x'),
+                              Variant("short"),
+                              Variant("A string which is too long to be stored inline.")};
+  for (auto const& v : values) {
+    Variant result = roundTrip(v);
+    EXPECT_EQ(v, result);
+    EXPECT_EQ(v.getType(), result.getType());
+  }
+
+  // named enums keep their type if it is known and unique, otherwise they are restored as strings
+  Variant shape(Shape::SQUARE);
+  EXPECT_EQ(shape, roundTrip(shape));
+  using LIBD::TESTS::TestDummy;
+  EXPECT_EQ(TestDummy::COLOR(roundTrip(Variant(TestDummy::COLOR::GREEN))), TestDummy::COLOR::GREEN);
+  ByteBuffer buffer;
+  BinaryWriter writer(buffer);
+  writer.writeByte(Variant::Type::ENUM);
+  writer.writeString("UNKNOWN_ENUM");
+  writer.writeString("VALUE");
+  BinaryReader enumReader(buffer);
+  EXPECT_EQ(Variant("VALUE"), Variant::deserialize(enumReader));
+
+  ByteBuffer corrupt{200};
+  BinaryReader reader(corrupt);
+  D_EXPECT_THROW(Variant::deserialize(reader), "unknown variant type tag");
+}
+
+TEST_F(SerializationTests, testSettingsRoundTrip)
+{
+  Settings s = Settings()
+                   .set("label", 7)
+                   .set("real", 0.5)
+                   .set("name", "A string which is too long to be stored inline.")
+                   .set("flag", false);
+  Settings result = roundTrip(s);
+  EXPECT_EQ(s, result);
+  EXPECT_EQ(s.keys(), result.keys());
+  EXPECT_TRUE(roundTrip(Settings()).empty());
+
+  // a truncated blob must not be accepted
+  ByteBuffer buffer;
+  BinaryWriter writer(buffer);
+  s.serialize(writer);
+  buffer.resize(buffer.size() - 3);
+  BinaryReader reader(buffer);
+  D_EXPECT_THROW(Settings::deserialize(reader), "truncated");
+
+  // an announced number of entries which cannot be contained in the data is rejected before allocating
+  ByteBuffer huge;
+  BinaryWriter(huge).writeVarint(std::uint64_t(1) << 60);
+  BinaryReader hugeReader(huge);
+  D_EXPECT_THROW(Settings::deserialize(hugeReader), "exceeds the size");
+}
+
+TEST_F(SerializationTests, testSettingsDeserializationAllocations)
+{
+  struct CountingResource : std::pmr::memory_resource
+  {
+    std::size_t allocations = 0;
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+      ++allocations;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+      std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+    {
+      return this == &other;
+    }
+  };
+
+  // storage, entry vector and key hashes, the index table beyond indexThreshold entries and the
+  // binding of each value to the resource
+  for (std::size_t entries : {std::size_t(5), Settings::indexThreshold + 1, std::size_t(200)}) {
+    Settings s;
+    for (std::size_t i = 0; i < entries; ++i) {
+      s.set("key" + std::to_string(i), int(i));
+    }
+    ByteBuffer buffer;
+    BinaryWriter writer(buffer);
+    s.serialize(writer);
+    BinaryReader reader(buffer);
+    CountingResource counting;
+    Settings result = Settings::deserialize(reader, &counting);
+    EXPECT_EQ(s, result);
+    std::size_t const blocks = entries > Settings::indexThreshold ? 4 : 3;
+    EXPECT_EQ(counting.allocations, blocks + entries) << entries << " entries";
+  }
+}
+
+TEST_F(SerializationTests, testSettingRuleRoundTrip)
+{
+  SettingRule sr;
+  sr.usage = SettingRule::Usage::MANDATORY_WITH_DEFAULT;
+  sr.key = "key";
+  sr.description = "a setting rule";
+  sr.listOfPossibleValues = {"a", "b", "c"};
+  sr.type = Variant::Type::STRING;
+  sr.defaultValue = Variant("a");
+  sr.minimalStringLength = 1;
+  SettingRule result = roundTrip(sr);
+  EXPECT_EQ(sr.usage, result.usage);
+  EXPECT_EQ(sr.key, result.key);
+  EXPECT_EQ(sr.description, result.description);
+  EXPECT_EQ(sr.listOfPossibleValues, result.listOfPossibleValues);
+  EXPECT_EQ(sr.type, result.type);
+  EXPECT_EQ(sr.defaultValue, result.defaultValue);
+  EXPECT_TRUE(result.minimalValue.isMonostate());
+  EXPECT_EQ(sr.minimalStringLength, result.minimalStringLength);
+
+  sr.type = Variant::Type::DOUBLE;
+  sr.minimalValue = Variant(-1.5);
+  sr.maximalValue = Variant(1.5);
+  result = roundTrip(sr);
+  EXPECT_EQ(sr.minimalValue, result.minimalValue);
+  EXPECT_EQ(sr.maximalValue, result.maximalValue);
+
+  // an ordinal beyond label_t must not wrap around to a valid one
+  ByteBuffer buffer;
+  BinaryWriter(buffer).writeVarint(std::uint64_t(1) << 32);
+  BinaryReader reader(buffer);
+  D_EXPECT_THROW(SettingRule::deserialize(reader), "setting usage which is out of range");
+}
@@ -44,7 +44,7 @@ TEST_F(SettingRuleTests, testCreateSettingRuleForNamedEnumWorksAsExpected)
     ASSERT_EQ(sr.maximalValue, Variant());
     ASSERT_EQ(sr.minimalStringLength, 0);
     ASSERT_EQ(sr.listOfPossibleValues, Weekday::getAllowedNames());
-    ASSERT_EQ(sr.type, Variant::Type::STRING);
+    ASSERT_EQ(sr.type, Variant::Type::ENUM);
 }
 
 TEST_F(SettingRuleTests, testCreateSettingRuleForNamedParameterWorksAsExpected)
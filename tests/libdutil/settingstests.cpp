@@ -4,6 +4,8 @@
 #include "tests/libtesting/testdummy.h"
 #include "tests/testbase.h"
 
+#include <thread>
+
 using namespace DUTIL;
 
 namespace {
@@ -48,6 +50,10 @@ TEST_F(SettingsTests, testSetEnumWorksAsExpected)
 
   auto value = s.value("WEEKDAY");
   EXPECT_EQ(WEEKDAY(value), wd);
+
+  // enums equal their names, e.g. as read from a text file
+  EXPECT_EQ(s, Settings().set("WEEKDAY", "FRIDAY"));
+  EXPECT_NE(s, Settings().set("WEEKDAY", "SATURDAY"));
 }
 
 TEST_F(SettingsTests, testGetEnumWorksAsExpected)
@@ -61,6 +67,54 @@ TEST_F(SettingsTests, testGetEnumWorksAsExpected)
   ASSERT_EQ(WEEKDAY::FRIDAY, settingsEnum);
 }
 
+TEST_F(SettingsTests, testStringViewKeysAndTryGet)
+{
+  std::string const buffer = "SomeLongKeyWhichIsNotStoredInline,AnotherKey";
+  std::string_view const key = std::string_view(buffer).substr(0, buffer.find(','));
+  std::string_view const otherKey = std::string_view(buffer).substr(buffer.find(',') + 1);
+
+  Settings s = Settings().set(key, 1.5).set(otherKey, "value");
+  EXPECT_TRUE(s.hasKey(key));
+  EXPECT_TRUE(s.hasKey("AnotherKey"));
+  EXPECT_FALSE(s.hasKey(key.substr(1)));
+  EXPECT_EQ(Variant(1.5), s.value(key));
+
+  Variant const* v = s.tryGet(otherKey);
+  ASSERT_NE(nullptr, v);
+  EXPECT_EQ("value", v->asStringView());
+  EXPECT_EQ(nullptr, s.tryGet("value"));
+  EXPECT_EQ(nullptr, s.tryGet(""));
+
+  s.erase(key);
+  EXPECT_FALSE(s.hasKey(key));
+  EXPECT_EQ(Variant(label_t(7)), s.value(key, Variant(label_t(7))));
+
+  // typed accessors behave as before for missing keys
+  D_EXPECT_THROW(s.getEnum<WEEKDAY>(), "Variant parameter does not hold a std::string value.");
+  D_EXPECT_THROW(s.getParameter<RealWithName>(), "Variant type is not convertible");
+}
+
+TEST_F(SettingsTests, testTryGetWithKeyHash)
+{
+  for (std::size_t size : {std::size_t(1), 4 * Settings::indexThreshold}) {
+    Settings s;
+    for (std::size_t i = 1; i < size; ++i) {
+      s.set("key" + std::to_string(i), label_t(i));
+    }
+    s.setParameter(RealWithName(2.5)).setEnum(WEEKDAY::SUNDAY);
+
+    Variant const* v = s.tryGet(RealWithName::getParameterName(), RealWithName::getParameterNameHash());
+    ASSERT_NE(nullptr, v);
+    EXPECT_EQ(Variant(2.5), *v);
+    EXPECT_EQ(WEEKDAY::SUNDAY, s.getEnum<WEEKDAY>());
+    EXPECT_EQ(2.5, s.getParameter<RealWithName>().value());
+    EXPECT_EQ(nullptr, s.tryGet(LabelWithName::getParameterName(), LabelWithName::getParameterNameHash()));
+
+    // a hit on the hash alone is not enough, the key has to match as well
+    EXPECT_EQ(nullptr, s.tryGet("OtherName", RealWithName::getParameterNameHash()));
+  }
+}
+
 TEST_F(SettingsTests, testHasKeysWorksAsExpected)
 {
   Settings s = Settings().setEnum(COLOR::GREEN);
@@ -180,3 +234,257 @@ TEST_F(SettingsTests, testSetConcreteClassWorksAsExpected)
   auto ccp = s.getParameter<TestDummy::Ware::DUTIL_Ware_Type>();
   ASSERT_EQ(td.getClassName(), ccp.value());
 }
+
+TEST_F(SettingsTests, testLargeSettingsKeepInsertionOrder)
+{
+  // exceed the threshold for linear search several times
+  std::size_t const size = 10 * Settings::indexThreshold;
+  Settings s;
+  StringList expectedKeys;
+  for (std::size_t i = 0; i < size; ++i) {
+    expectedKeys.push_back("key" + std::to_string(i));
+    s.set(expectedKeys.back(), label_t(i));
+  }
+  ASSERT_EQ(expectedKeys, s.keys());
+  for (std::size_t i = 0; i < size; ++i) {
+    ASSERT_TRUE(s.hasKey(expectedKeys[i]));
+    ASSERT_EQ(Variant(label_t(i)), s.value(expectedKeys[i]));
+  }
+  EXPECT_FALSE(s.hasKey("key"));
+  EXPECT_FALSE(s.hasKey("key" + std::to_string(size)));
+
+  // overriding keeps the position of the key
+  s.set("key7", "seven");
+  EXPECT_EQ(expectedKeys, s.keys());
+  EXPECT_EQ("seven", s.value("key7").toString());
+  s.set("key7", label_t(7));
+
+  // erasing entries keeps the order of the remaining ones, until the object is small again
+  for (std::size_t i = 0; i + 4 < size; ++i) {
+    s.erase(expectedKeys[i]);
+    EXPECT_FALSE(s.hasKey(expectedKeys[i]));
+    ASSERT_EQ(Variant(label_t(i + 1)), s.value(expectedKeys[i + 1]));
+    ASSERT_EQ(Variant(label_t(size - 1)), s.value(expectedKeys[size - 1]));
+  }
+  EXPECT_EQ(StringList(expectedKeys.end() - 4, expectedKeys.end()), s.keys());
+
+  // erasing from the middle of the index finds all remaining entries
+  Settings sparse;
+  for (std::size_t i = 0; i < size; ++i) {
+    sparse.set(expectedKeys[i], label_t(i));
+  }
+  StringList remainingKeys;
+  for (std::size_t i = 0; i < size; ++i) {
+    if (i % 3 == 1)
+      sparse.erase(expectedKeys[i]);
+    else
+      remainingKeys.push_back(expectedKeys[i]);
+  }
+  EXPECT_EQ(remainingKeys, sparse.keys());
+  for (std::size_t i = 0; i < size; ++i) {
+    ASSERT_EQ(i % 3 != 1, sparse.hasKey(expectedKeys[i])) << expectedKeys[i];
+  }
+  sparse.set(expectedKeys[1], "again");
+  EXPECT_EQ("again", sparse.value(expectedKeys[1]).toString());
+
+  // erasing many keys at once, unknown ones are skipped
+  StringList erasedKeys{"unknown", ""};
+  for (std::size_t i = 0; i < size; i += 2) {
+    erasedKeys.push_back(expectedKeys[i]);
+  }
+  Settings const shared = sparse;
+  sparse.erase(erasedKeys);
+  for (std::size_t i = 0; i < size; ++i) {
+    // key1 has been set again above
+    ASSERT_EQ(i % 2 == 1 && (i % 3 != 1 || i == 1), sparse.hasKey(expectedKeys[i])) << expectedKeys[i];
+  }
+  EXPECT_EQ(Variant(label_t(5)), sparse.value("key5"));
+  EXPECT_EQ(Variant(label_t(2)), shared.value("key2"));
+  EXPECT_EQ(sparse, Settings(sparse).erase(StringList{"unknown"}));
+
+  // copies and copies into other memory resources carry the index along
+  for (std::size_t i = 0; i < size; ++i) {
+    s.set(expectedKeys[i], label_t(i));
+  }
+  std::pmr::monotonic_buffer_resource arena;
+  for (Settings const& copy : {Settings(s), Settings(s, &arena)}) {
+    EXPECT_EQ(s, copy);
+    for (std::size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(Variant(label_t(i)), copy.value(expectedKeys[i]));
+    }
+  }
+}
+
+TEST_F(SettingsTests, testEqualityAndFingerprintIgnoreOrder)
+{
+  for (std::size_t size : {std::size_t(3), 4 * Settings::indexThreshold}) {
+    Settings s1;
+    Settings s2;
+    for (std::size_t i = 0; i < size; ++i) {
+      s1.set("key" + std::to_string(i), label_t(i));
+      s2.set("key" + std::to_string(size - 1 - i), label_t(size - 1 - i));
+    }
+    s1.setEnum(WEEKDAY::SUNDAY).set("text", "A string which is too long to be stored inline.");
+    s2.set("text", "A string which is too long to be stored inline.").setEnum(WEEKDAY::SUNDAY);
+    EXPECT_EQ(s1, s2);
+    EXPECT_EQ(s1.fingerprint(), s2.fingerprint());
+    EXPECT_EQ(s1.fingerprint(), Settings(s1).fingerprint());
+
+    // changes invalidate the cached fingerprint
+    auto const fingerprint = s1.fingerprint();
+    s1.set("key1", 0.0);
+    EXPECT_NE(s1, s2);
+    EXPECT_NE(fingerprint, s1.fingerprint());
+    s1.set("key1", label_t(1));
+    EXPECT_EQ(s1, s2);
+    EXPECT_EQ(fingerprint, s1.fingerprint());
+    s1.erase("text");
+    EXPECT_NE(s1, s2);
+    EXPECT_NE(fingerprint, s1.fingerprint());
+    s2.erase("text");
+    EXPECT_EQ(s1, s2);
+    EXPECT_EQ(s1.fingerprint(), s2.fingerprint());
+
+    // same keys with other values and other keys with the same values differ
+    s2.set("key0", label_t(1)).set("key1", label_t(0));
+    EXPECT_NE(s1, s2);
+    EXPECT_NE(s1.fingerprint(), s2.fingerprint());
+    Settings s3 = Settings(s1).erase("key0").set("otherKey", label_t(0));
+    EXPECT_NE(s1, s3);
+    EXPECT_NE(s1.fingerprint(), s3.fingerprint());
+  }
+
+  // values comparing equal have equal fingerprints
+  EXPECT_EQ(Settings().set("zero", 0.0), Settings().set("zero", -0.0));
+  EXPECT_EQ(Settings().set("zero", 0.0).fingerprint(), Settings().set("zero", -0.0).fingerprint());
+  EXPECT_NE(Settings().fingerprint(), Settings().set("empty", Variant()).fingerprint());
+
+  // enums equal their names, e.g. as read from a text file
+  Settings const fromText = Settings().set("WEEKDAY", "FRIDAY");
+  EXPECT_EQ(Settings().setEnum(WEEKDAY::FRIDAY), fromText);
+  EXPECT_EQ(Settings().setEnum(WEEKDAY::FRIDAY).fingerprint(), fromText.fingerprint());
+  EXPECT_NE(Settings().setEnum(WEEKDAY::SATURDAY), fromText);
+}
+
+TEST_F(SettingsTests, testCopiesShareEntriesUntilChanged)
+{
+  std::string const text = "A string which is too long to be stored inline.";
+  Settings s1 = Settings().set("text", text).set("number", 1.5);
+  Settings s2 = s1;
+  Settings s3;
+  s3 = s1;
+  // copies refer to the same entries
+  EXPECT_EQ(s1.tryGet("text"), s2.tryGet("text"));
+  EXPECT_EQ(s1.tryGet("text"), s3.tryGet("text"));
+
+  // the first change clones the entries, the other copies are not affected
+  s2.set("number", 2.5);
+  EXPECT_NE(s1.tryGet("text"), s2.tryGet("text"));
+  EXPECT_EQ(Variant(1.5), s1.value("number"));
+  EXPECT_EQ(Variant(1.5), s3.value("number"));
+  EXPECT_EQ(Variant(2.5), s2.value("number"));
+  s3.erase("text");
+  EXPECT_EQ(text, s1.value("text").toString());
+  EXPECT_FALSE(s3.hasKey("text"));
+  // erasing a missing key does not clone
+  Settings s4 = s1;
+  s4.erase("missing");
+  EXPECT_EQ(s1.tryGet("text"), s4.tryGet("text"));
+
+  // entries are only shared between objects using the same memory resource
+  std::pmr::monotonic_buffer_resource arena;
+  Settings inArena(s1, &arena);
+  EXPECT_NE(s1.tryGet("text"), inArena.tryGet("text"));
+  EXPECT_EQ(&arena, inArena.tryGet("text")->memoryResource());
+  Settings arenaCopy(inArena, &arena);
+  EXPECT_EQ(inArena.tryGet("text"), arenaCopy.tryGet("text"));
+  Settings plainCopy = inArena;
+  EXPECT_NE(inArena.tryGet("text"), plainCopy.tryGet("text"));
+  EXPECT_EQ(std::pmr::get_default_resource(), plainCopy.tryGet("text")->memoryResource());
+  plainCopy = std::move(arenaCopy);
+  EXPECT_EQ(std::pmr::get_default_resource(), plainCopy.get_allocator().resource());
+  EXPECT_EQ(std::pmr::get_default_resource(), plainCopy.tryGet("text")->memoryResource());
+  EXPECT_EQ(s1, plainCopy);
+
+  // the last owner changes the entries in place, also after its copies went away or moved
+  Settings owner = Settings().set("text", text).set("number", 1);
+  Settings moved = std::move(owner);
+  Variant const* entry = moved.tryGet("text");
+  moved.set("number", 2);
+  EXPECT_EQ(entry, moved.tryGet("text"));
+  Settings copy = moved;
+  copy = Settings();
+  moved.set("number", 3);
+  EXPECT_EQ(entry, moved.tryGet("text"));
+}
+
+TEST_F(SettingsTests, testCopiesChangeIndependentlyOnThreads)
+{
+  Settings const original =
+      Settings().set("text", "A string which is too long to be stored inline.").set("number", 0);
+  std::vector<Settings> results(4);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    threads.emplace_back([&original, &result = results[i], i]() {
+      Settings copy = original;
+      for (label_t k = 0; k < 1000; ++k) {
+        Settings temporary = copy;
+        copy.set("number", k);
+        temporary.set("text", "changed");
+      }
+      copy.set("thread", label_t(i));
+      result = copy;
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(Variant(0), original.value("number"));
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(Variant(label_t(999)), results[i].value("number"));
+    EXPECT_EQ(Variant(label_t(i)), results[i].value("thread"));
+    EXPECT_EQ(original.value("text"), results[i].value("text"));
+  }
+}
+
+TEST_F(SettingsTests, testDiffAndApply)
+{
+  Settings base;
+  for (int i = 0; i < 40; ++i) {
+    base.set("key" + std::to_string(i), i);
+  }
+  base.setEnum(WEEKDAY::FRIDAY);
+
+  // copies sharing their entries have an empty diff
+  Settings target = base;
+  EXPECT_TRUE(base.diff(target).empty());
+
+  target.set("key3", 33);
+  target.erase("key7");
+  target.set("added", "new value");
+  target.setEnum(WEEKDAY::SUNDAY);
+  Settings::Patch const patch = base.diff(target);
+  EXPECT_FALSE(patch.empty());
+  EXPECT_EQ(patch.added.keys(), StringList{"added"});
+  EXPECT_EQ(patch.changed.keys(), (StringList{"key3", "WEEKDAY"}));
+  EXPECT_EQ(patch.removed, StringList{"key7"});
+  EXPECT_EQ(patch.keys(), (StringList{"added", "key3", "WEEKDAY", "key7"}));
+  EXPECT_EQ(patch.changed.value("key3"), Variant(33));
+
+  // applying the patch yields the target, the inverse patch restores the base
+  Settings patched = base;
+  patched.apply(patch);
+  EXPECT_EQ(patched, target);
+  EXPECT_TRUE(patched.diff(target).empty());
+  patched.apply(target.diff(base));
+  EXPECT_EQ(patched, base);
+
+  // an empty patch does not unshare the entries
+  Settings copy = base;
+  copy.apply(base.diff(copy));
+  EXPECT_EQ(base.tryGet("key0"), copy.tryGet("key0"));
+
+  // diffs against empty objects
+  EXPECT_EQ(Settings().diff(base).added, base);
+  EXPECT_EQ(base.diff(Settings()).removed.size(), 41u);
+}
@@ -0,0 +1,136 @@
+#include "libdutil/constructionvalidator.h"
+#include "libdutil/namedparameter.h"
+#include "libdutil/settingsview.h"
+#include "tests/testbase.h"
+
+using namespace DUTIL;
+
+namespace {
+class SettingsViewTests : public TestBase
+{};
+
+D_NAMED_ENUM(Detector, SCINTILLATOR, GAS_COUNTER, SEMICONDUCTOR)
+D_NAMED_REAL(Gain)
+D_NAMED_LABEL(Channels)
+
+Settings makeDefaults()
+{
+  Settings defaults;
+  defaults.setEnum(Detector::SCINTILLATOR);
+  defaults.setParameter(Gain(1.0));
+  defaults.setParameter(Channels(64));
+  defaults.set("comment", "default instrument");
+  return defaults;
+}
+
+}  // namespace
+
+TEST_F(SettingsViewTests, testEmptyView)
+{
+  SettingsView view;
+  EXPECT_TRUE(view.empty());
+  EXPECT_EQ(view.layerCount(), 0u);
+  EXPECT_TRUE(view.keys().empty());
+  EXPECT_EQ(view.tryGet("comment"), nullptr);
+  EXPECT_FALSE(view.value("comment").isValid());
+  EXPECT_TRUE(view.materialize().empty());
+}
+
+TEST_F(SettingsViewTests, testLookupsFallThroughLayers)
+{
+  Settings overrides;
+  overrides.setParameter(Gain(2.5));
+  overrides.set("serial", "A-17");
+  SettingsView view = SettingsView(makeDefaults()).overlay(overrides);
+
+  EXPECT_EQ(view.layerCount(), 2u);
+  EXPECT_FALSE(view.empty());
+  EXPECT_EQ(view.getParameter<Gain>().value(), 2.5);
+  EXPECT_EQ(view.getParameter<Channels>().value(), 64);
+  EXPECT_EQ(view.getEnum<Detector>(), Detector::SCINTILLATOR);
+  EXPECT_EQ(view.value("serial").toString(), "A-17");
+  EXPECT_EQ(view.value("missing", Variant(3)).toString(), "3");
+  EXPECT_TRUE(view.hasKey("comment"));
+  EXPECT_FALSE(view.hasKey("missing"));
+
+  // hashed lookups give the same results
+  EXPECT_EQ(view.tryGet("Gain", Gain::getParameterNameHash()), view.tryGet("Gain"));
+  EXPECT_EQ(view.tryGet("missing", Hash::fnv1a("missing")), nullptr);
+
+  // keys of the top layer come first, hidden keys are listed once
+  StringList const expected{"Gain", "serial", "Detector", "Channels", "comment"};
+  EXPECT_EQ(view.keys(), expected);
+}
+
+TEST_F(SettingsViewTests, testLayersShareEntriesWithOriginals)
+{
+  Settings defaults = makeDefaults();
+  Settings overrides;
+  overrides.setParameter(Channels(128));
+  SettingsView view = SettingsView(defaults).overlay(overrides);
+
+  // no entry is copied, the view points into the original storage
+  EXPECT_EQ(view.tryGet("comment"), defaults.tryGet("comment"));
+  EXPECT_EQ(view.tryGet("Channels"), overrides.tryGet("Channels"));
+
+  // changing the originals afterwards does not change the view
+  defaults.set("comment", "changed");
+  overrides.setParameter(Channels(256));
+  EXPECT_EQ(view.value("comment").toString(), "default instrument");
+  EXPECT_EQ(view.getParameter<Channels>().value(), 128);
+}
+
+TEST_F(SettingsViewTests, testMaterializeMergesLayers)
+{
+  Settings overrides;
+  overrides.setEnum(Detector::SEMICONDUCTOR);
+  overrides.set("serial", "B-3");
+  Settings top;
+  top.set("serial", "B-4");
+  SettingsView view = SettingsView(makeDefaults()).overlay(overrides).overlay(top);
+
+  Settings merged = view.materialize();
+  Settings expected = makeDefaults();
+  expected.setEnum(Detector::SEMICONDUCTOR);
+  expected.set("serial", "B-4");
+  EXPECT_EQ(merged, expected);
+  StringList const keys{"Detector", "Gain", "Channels", "comment", "serial"};
+  EXPECT_EQ(merged.keys(), keys);
+
+  // a single layer is materialized without copying its entries
+  SettingsView single(makeDefaults());
+  EXPECT_EQ(single.materialize().tryGet("Gain"), single.tryGet("Gain"));
+}
+
+TEST_F(SettingsViewTests, testValidatorAcceptsViews)
+{
+  SettingRule gainRule = SettingRule::forNamedParameter<Gain>(SettingRule::Usage::OPTIONAL, "gain");
+  gainRule.minimalValue = 0.5;
+  gainRule.maximalValue = 4.0;
+  ConstructionValidator cv(
+      {SettingRule::forNamedEnum<Detector>(SettingRule::Usage::MANDATORY_NO_DEFAULT, "detector"),
+       gainRule,
+       SettingRule::forNamedParameter<Channels>(SettingRule::Usage::OPTIONAL, "channels")});
+
+  Settings defaults;
+  defaults.setEnum(Detector::GAS_COUNTER);
+  defaults.setParameter(Gain(1.0));
+  Settings overrides;
+  overrides.setParameter(Gain(3.0));
+  SettingsView view = SettingsView(defaults).overlay(overrides);
+
+  EXPECT_TRUE(cv.checkSettings(view).empty());
+  EXPECT_EQ(cv.validateNamedEnum<Detector>(view), Detector::GAS_COUNTER);
+  EXPECT_EQ(cv.validateNamedParameter<Gain>(view).value(), 3.0);
+
+  // an override out of range is rejected although the default is fine
+  overrides.setParameter(Gain(8.0));
+  SettingsView invalid = SettingsView(defaults).overlay(overrides);
+  EXPECT_FALSE(cv.checkSettings(invalid).empty());
+  EXPECT_THROW(cv.validateNamedParameter<Gain>(invalid), Exception);
+
+  // a mandatory key missing in all layers is reported
+  SettingsView missing = SettingsView(Settings()).overlay(overrides);
+  EXPECT_FALSE(cv.checkSettings(missing).empty());
+  EXPECT_THROW(cv.validateNamedEnum<Detector>(missing), Exception);
+}
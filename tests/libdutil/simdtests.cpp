@@ -0,0 +1,87 @@
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "libdutil/simd.h"
+#include "tests/testbase.h"
+
+using namespace DUTIL;
+
+namespace {
+class SIMDTests : public TestBase
+{
+  protected:
+  void TearDown() override { SIMD::setActiveInstructionSet(SIMD::supportedInstructionSet()); }
+};
+
+//! Sizes around the vector widths, so that both the vector loops and the remainders are used.
+std::vector<std::size_t> const sizes = {0, 1, 3, 4, 7, 8, 9, 31, 100};
+
+template <typename RESULT, typename INTERNAL>
+void expectSameAsStaticCast(std::vector<INTERNAL> const& pattern)
+{
+  for (std::size_t n : sizes) {
+    std::vector<INTERNAL> src(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      src[i] = pattern[(i * 7) % pattern.size()];
+    }
+    std::vector<RESULT> dst(n + 1, RESULT(42));
+    SIMD::convert(src.data(), dst.data(), n);
+    for (std::size_t i = 0; i < n; ++i) {
+      ASSERT_EQ(dst[i], static_cast<RESULT>(src[i])) << "size " << n << ", index " << i;
+    }
+    // nothing is written past the end
+    ASSERT_EQ(dst[n], RESULT(42));
+  }
+}
+
+template <typename INTERNAL>
+std::vector<INTERNAL> integerPattern()
+{
+  using Limits = std::numeric_limits<INTERNAL>;
+  return {Limits::min(), Limits::max(), INTERNAL(0), INTERNAL(1), INTERNAL(Limits::max() / 3),
+          INTERNAL(Limits::min() / 5), INTERNAL(Limits::max() - 1), INTERNAL(100)};
+}
+
+template <typename INTERNAL>
+void expectIntegerConversions()
+{
+  expectSameAsStaticCast<float>(integerPattern<INTERNAL>());
+  expectSameAsStaticCast<double>(integerPattern<INTERNAL>());
+}
+}  // namespace
+
+TEST_F(SIMDTests, activeInstructionSet_canBeRestricted)
+{
+  EXPECT_EQ(SIMD::activeInstructionSet(), SIMD::supportedInstructionSet());
+  SIMD::setActiveInstructionSet(SIMD::InstructionSet::SCALAR);
+  EXPECT_EQ(SIMD::activeInstructionSet(), SIMD::InstructionSet::SCALAR);
+  if (SIMD::supportedInstructionSet() != SIMD::InstructionSet::AVX2) {
+    D_EXPECT_THROW(SIMD::setActiveInstructionSet(SIMD::InstructionSet::AVX2), "is not supported");
+  }
+}
+
+TEST_F(SIMDTests, convert_allInstructionSets_matchStaticCast)
+{
+  for (label_t set = 0; set <= label_t(SIMD::supportedInstructionSet()); ++set) {
+    SIMD::setActiveInstructionSet(SIMD::InstructionSet(set));
+    SCOPED_TRACE(SIMD::activeInstructionSet().toString());
+
+    expectIntegerConversions<int8_t>();
+    expectIntegerConversions<uint8_t>();
+    expectIntegerConversions<int16_t>();
+    expectIntegerConversions<uint16_t>();
+    expectIntegerConversions<int32_t>();
+    expectIntegerConversions<uint32_t>();
+    expectIntegerConversions<int64_t>();
+
+    std::vector<double> const doubles = {0.0, -0.0, 1.5, -2.75, 1e-3, -123456.789, 2147483520.0, -2147483648.0};
+    expectSameAsStaticCast<float>(doubles);
+    expectSameAsStaticCast<int32_t>(doubles);
+    expectSameAsStaticCast<int64_t>(doubles);
+    std::vector<float> const floats = {0.0f, -0.0f, 1.5f, -2.75f, 1e-3f, -123456.79f, 2147483520.0f, -2147483648.0f};
+    expectSameAsStaticCast<double>(floats);
+    expectSameAsStaticCast<int32_t>(floats);
+    expectSameAsStaticCast<uint16_t>(std::vector<float>{0.0f, 1.0f, 65535.0f, 12.5f});
+    expectSameAsStaticCast<int8_t>(std::vector<int32_t>{0, -1, 127, -128});
+  }
+}
@@ -83,8 +83,14 @@ TEST_F(UtilityTests, testStringToArithmeticWorksAsExpedted)
     EXPECT_EQ(1234, stringToArithmetic<std::uint64_t>(str));
 
     str = "Hello World!";
-    auto result = D_EXPECT_THROW(stringToArithmetic<double>(str), "stod");
-    EXPECT_THAT(result, testing::HasSubstr("stod"));
+    auto result = D_EXPECT_THROW(stringToArithmetic<double>(str), "invalid number");
+    EXPECT_THAT(result, testing::HasSubstr("invalid number"));
+
+    // input is not modified anymore and decimal commas are accepted
+    str = "12,5";
+    EXPECT_EQ(12.5, stringToArithmetic<double>(str));
+    EXPECT_EQ("12,5", str);
+    D_EXPECT_THROW(stringToArithmetic<std::int64_t>("99999999999999999999"), "out of range");
 }
 
 TEST_F(UtilityTests, testTrimStringWorksAsExpected)
@@ -97,6 +103,18 @@ TEST_F(UtilityTests, testTrimStringWorksAsExpected)
     std::string str2 = "     Hallo";
     s1 = trimMove(std::move(str2));
     EXPECT_EQ("Hallo", s1);
+    std::string_view const view("\t\n Hallo \r\v");
+    EXPECT_EQ("Hallo", trim(view));
+    EXPECT_EQ(view.data() + 3, trim(view).data());
+    EXPECT_TRUE(trim(std::string_view(" \f ")).empty());
+    // string literals and character pointers give a std::string like std::string arguments
+    std::string const fromLiteral = trim(" a ");
+    EXPECT_EQ("a", fromLiteral);
+    char const* pointer = "\tb\n";
+    EXPECT_EQ("b", trim(pointer));
+    str = "   ";
+    trimThis(str);
+    EXPECT_TRUE(str.empty());
 }
 
 TEST_F(UtilityTests, testSplitWorksAsExpected)
@@ -0,0 +1,105 @@
+#include "libd/libdutil/variantcolumn.h"
+#include "tests/testbase.h"
+
+#include <cmath>
+#include <limits>
+#include <memory_resource>
+
+using namespace DUTIL;
+
+namespace {
+class VariantColumnTests : public TestBase
+{};
+}  // namespace
+
+TEST_F(VariantColumnTests, testFromSettings)
+{
+  std::vector<Settings> settings(4);
+  for (std::size_t i = 0; i < settings.size(); ++i) {
+    settings[i].set("wavelength", 400.0 + double(i)).set("index", label_t(i));
+  }
+  settings[2].erase("index");
+
+  auto wavelengths = VariantColumn::fromSettings(settings, "wavelength");
+  EXPECT_EQ(4u, wavelengths.size());
+  EXPECT_TRUE(wavelengths.isUniform());
+  EXPECT_EQ(Variant::Type::DOUBLE, wavelengths.getType());
+  EXPECT_EQ(std::vector<double>({400.0, 401.0, 402.0, 403.0}), wavelengths.toVector<double>());
+
+  // the missing key yields an empty variant which cannot be converted
+  auto indices = VariantColumn::fromSettings(settings, "index");
+  EXPECT_FALSE(indices.isUniform());
+  EXPECT_EQ(Variant::Type::MONOSTATE, indices.getType());
+  EXPECT_TRUE(indices[2].isMonostate());
+  D_EXPECT_THROW(indices.toVector<label_t>(), "Value 2 of the variant column");
+
+  std::vector<label_t> values(indices.size());
+  EXPECT_EQ(1u, indices.convertInto(values.data(), label_t(-1)));
+  EXPECT_EQ(std::vector<label_t>({0, 1, -1, 3}), values);
+}
+
+TEST_F(VariantColumnTests, testUniformConversions)
+{
+  VariantColumn labels({Variant(1), Variant(-2), Variant(300)});
+  EXPECT_EQ(std::vector<double>({1.0, -2.0, 300.0}), labels.toVector<double>());
+  EXPECT_EQ(std::vector<std::int64_t>({1, -2, 300}), labels.toVector<std::int64_t>());
+
+  // conversions which may fail are still range checked
+  D_EXPECT_THROW(labels.toVector<std::uint32_t>(), "out of range");
+  D_EXPECT_THROW(labels.toVector<std::int8_t>(), "out of range");
+  std::vector<std::int8_t> bytes(labels.size());
+  EXPECT_EQ(1u, labels.convertInto(bytes.data(), std::int8_t(0)));
+  EXPECT_EQ(std::vector<std::int8_t>({1, -2, 0}), bytes);
+
+  // a loss of precision is accepted
+  VariantColumn reals({Variant(1.5), Variant(-2.25)});
+  EXPECT_EQ(std::vector<label_t>({1, -2}), reals.toVector<label_t>());
+  EXPECT_EQ(std::vector<float>({1.5f, -2.25f}), reals.toVector<float>());
+  VariantColumn huge({Variant(1e300)});
+  D_EXPECT_THROW(huge.toVector<float>(), "out of range");
+
+  // values bound to a memory resource keep their value outside of the variant
+  std::pmr::monotonic_buffer_resource arena;
+  VariantColumn bound;
+  bound.push_back(Variant(2.5));
+  bound.push_back(Variant(-4.0, &arena));
+  EXPECT_EQ(&arena, bound[1].memoryResource());
+  EXPECT_TRUE(bound.isUniform());
+  EXPECT_EQ(std::vector<double>({2.5, -4.0}), bound.toVector<double>());
+  EXPECT_EQ(std::vector<label_t>({2, -4}), bound.toVector<label_t>());
+}
+
+TEST_F(VariantColumnTests, testMixedConversions)
+{
+  VariantColumn column;
+  column.push_back(Variant(1));
+  column.push_back(Variant(" 2.5 "));
+  column.push_back(Variant(std::uint64_t(3)));
+  column.push_back(Variant(true));
+  column.push_back(Variant("n/a"));
+  EXPECT_FALSE(column.isUniform());
+
+  std::vector<double> values(column.size());
+  double const nan = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_EQ(1u, column.convertInto(values.data(), nan));
+  EXPECT_EQ(2.5, values[1]);
+  EXPECT_EQ(1.0, values[3]);
+  EXPECT_TRUE(std::isnan(values[4]));
+  D_EXPECT_THROW(column.toVector<double>(), "invalid");
+
+  column.clear();
+  EXPECT_TRUE(column.empty());
+  EXPECT_FALSE(column.isUniform());
+  EXPECT_TRUE(column.toVector<double>().empty());
+}
+
+TEST_F(VariantColumnTests, testToDataset)
+{
+  VariantColumn column({Variant(1), Variant(2), Variant(3)});
+  Dataset ds = column.toDataset<double>();
+  EXPECT_EQ(Dataset::Type::FLOAT64, ds.getType());
+  EXPECT_EQ(3, ds.getRows());
+  EXPECT_EQ(1, ds.getCols());
+  EXPECT_EQ(2.0, ds.getValue<double>(1, 0));
+  EXPECT_EQ(Dataset::Type::EMPTY, VariantColumn().toDataset<double>().getType());
+}
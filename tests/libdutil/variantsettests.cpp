@@ -0,0 +1,78 @@
+#include "libd/libdutil/variantset.h"
+#include "tests/testbase.h"
+
+#include <limits>
+
+using namespace DUTIL;
+
+namespace {
+class VariantSetTests : public TestBase
+{};
+}  // namespace
+
+TEST_F(VariantSetTests, testInsertAndContains)
+{
+  VariantSet set;
+  EXPECT_TRUE(set.empty());
+  EXPECT_FALSE(set.contains(Variant(1)));
+
+  EXPECT_TRUE(set.insert(Variant(1)));
+  EXPECT_TRUE(set.insert(Variant("one")));
+  EXPECT_TRUE(set.insert(Variant(std::int64_t(1))));
+  EXPECT_FALSE(set.insert(Variant(1)));
+  EXPECT_FALSE(set.insert(Variant("one")));
+  EXPECT_EQ(3u, set.size());
+
+  EXPECT_TRUE(set.contains(Variant(std::int64_t(1))));
+  EXPECT_FALSE(set.contains(Variant(1.0)));
+
+  set.clear();
+  EXPECT_TRUE(set.empty());
+  EXPECT_FALSE(set.contains(Variant(1)));
+  EXPECT_TRUE(set.insert(Variant(1)));
+}
+
+TEST_F(VariantSetTests, testDuplicatesWhenTableIsFull)
+{
+  // 8 values fill the smallest index table up to its limit, duplicates are found before it grows
+  VariantSet set;
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_TRUE(set.insert(Variant(i)));
+  }
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_FALSE(set.insert(Variant(i)));
+  }
+  EXPECT_EQ(8u, set.size());
+  EXPECT_TRUE(set.insert(Variant(8)));
+  for (int i = 0; i < 9; ++i) {
+    EXPECT_TRUE(set.contains(Variant(i)));
+  }
+}
+
+TEST_F(VariantSetTests, testNanIsStoredOnce)
+{
+  double const nan = std::numeric_limits<double>::quiet_NaN();
+  VariantSet set;
+  EXPECT_TRUE(set.insert(Variant(nan)));
+  EXPECT_FALSE(set.insert(Variant(nan)));
+  EXPECT_FALSE(set.insert(Variant(-nan)));
+  EXPECT_TRUE(set.contains(Variant(nan)));
+  EXPECT_TRUE(set.insert(Variant(0.0)));
+  EXPECT_FALSE(set.insert(Variant(-0.0)));
+  EXPECT_EQ(2u, set.size());
+}
+
+TEST_F(VariantSetTests, testDeduplicationKeepsInsertionOrder)
+{
+  VariantSet set;
+  set.reserve(10);
+  std::vector<Variant> expected;
+  for (label_t i = 0; i < 1000; ++i) {
+    Variant v(i % 100);
+    if (i < 100)
+      expected.push_back(v);
+    EXPECT_EQ(i < 100, set.insert(v));
+  }
+  EXPECT_EQ(expected, set.values());
+  EXPECT_EQ(expected, std::vector<Variant>(set.begin(), set.end()));
+}
@@ -3,7 +3,11 @@
 #include "tests/libtesting/testdummy.h"
 #include "tests/testbase.h"
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <memory_resource>
+#include <unordered_map>
 
 using namespace DUTIL;
 using namespace DUTIL::VariantDetail;
@@ -163,9 +167,9 @@ TEST_F(VariantTests, testVariantConstructionWorksAsExpected)
     Variant var2{TestDummy::COLOR::GREEN};
 
     auto type = var.getType();
-    EXPECT_TRUE(type == Variant::Type::STRING);
+    EXPECT_TRUE(type == Variant::Type::ENUM);
     type = var2.getType();
-    EXPECT_TRUE(type == Variant::Type::STRING);
+    EXPECT_TRUE(type == Variant::Type::ENUM);
     EXPECT_EQ(var.toString(), "GREEN");
     EXPECT_EQ(var2.toString(), "GREEN");
   }
@@ -409,8 +413,271 @@ TEST_F(VariantTests, testConvertTo)
   v.convertTo(Variant::Type::STRING);
   ASSERT_TRUE(v.isString());
   result = v.getAs<std::string>().second;
-  Utility::trimZeros(result);
-  ASSERT_EQ("2.0", result);
+  ASSERT_EQ("1", result);
   v.convertTo(Variant::Type::MONOSTATE);
   ASSERT_TRUE(v.isMonostate());
 }
+
+TEST_F(VariantTests, testCompactLayout)
+{
+  ASSERT_EQ(16u, sizeof(Variant));
+
+  // strings up to the inline capacity and longer strings behave identically
+  std::string shortString(Variant::inlineStringCapacity, 'a');
+  std::string longString(Variant::inlineStringCapacity + 1, 'b');
+  Variant vShort(shortString);
+  Variant vLong(longString);
+  ASSERT_TRUE(vShort.isString());
+  ASSERT_TRUE(vLong.isString());
+  ASSERT_EQ(shortString, vShort.toString());
+  ASSERT_EQ(longString, vLong.toString());
+  ASSERT_EQ(Variant(std::string()).toString(), "");
+  ASSERT_NE(vShort, vLong);
+}
+
+TEST_F(VariantTests, testCopyAndMoveOfLongStrings)
+{
+  std::string str = "A string which is too long to be stored inline.";
+  Variant v1(str);
+  Variant v2(v1);
+  ASSERT_EQ(v1, v2);
+  ASSERT_EQ(str, v2.toString());
+
+  Variant v3(std::move(v2));
+  ASSERT_EQ(str, v3.toString());
+  ASSERT_TRUE(v2.isMonostate());
+
+  Variant v4(1.5);
+  v4 = v3;
+  ASSERT_EQ(str, v4.toString());
+  v4 = v4;
+  ASSERT_EQ(str, v4.toString());
+  v4 = 42;
+  ASSERT_EQ(42, v4.toLabel());
+  ASSERT_EQ(Variant::Type::LABEL, v4.getType());
+
+  v3 = Variant("short");
+  ASSERT_EQ("short", v3.toString());
+  v3 = std::move(v1);
+  ASSERT_EQ(str, v3.toString());
+}
+
+TEST_F(VariantTests, testLongStringsInMemoryResource)
+{
+  std::string str = "A string which is too long to be stored inline.";
+  std::pmr::monotonic_buffer_resource arena;
+  Variant v1(str, &arena);
+  EXPECT_EQ(&arena, v1.memoryResource());
+  EXPECT_EQ(&arena, Variant("short", &arena).memoryResource());
+  EXPECT_EQ(nullptr, Variant("short").memoryResource());
+  EXPECT_EQ(std::pmr::get_default_resource(), Variant(str).memoryResource());
+
+  // plain copies use the default resource, moves keep the heap buffer
+  Variant v2(v1);
+  EXPECT_EQ(std::pmr::get_default_resource(), v2.memoryResource());
+  Variant v3(std::move(v1), &arena);
+  EXPECT_EQ(&arena, v3.memoryResource());
+  EXPECT_TRUE(v1.isMonostate());
+
+  // moving into another resource copies the string
+  std::pmr::monotonic_buffer_resource other;
+  Variant v4(std::move(v3), &other);
+  EXPECT_EQ(&other, v4.memoryResource());
+  EXPECT_EQ(str, v4.toString());
+
+  // std::pmr containers hand their allocator on to the variants
+  std::pmr::vector<Variant> values(&arena);
+  values.push_back(v2);
+  values.emplace_back(str);
+  EXPECT_EQ(&arena, values[0].memoryResource());
+  EXPECT_EQ(&arena, values[1].memoryResource());
+  EXPECT_EQ(v2, values[0]);
+}
+
+TEST_F(VariantTests, testAssignmentKeepsMemoryResource)
+{
+  std::string str = "A string which is too long to be stored inline.";
+  alignas(std::max_align_t) char buffer[1024];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+  auto inArena = [&buffer](Variant const& v) {
+    auto const* chars = v.asStringView().data();
+    return chars >= buffer && chars < buffer + sizeof(buffer);
+  };
+
+  // assigned elements allocate from the container's arena, also for values of other resources
+  std::pmr::vector<Variant> values(3, &arena);
+  Variant plain(str);
+  values[0] = plain;
+  values[1] = Variant(str);
+  values[2] = 42;
+  EXPECT_EQ(&arena, values[0].memoryResource());
+  EXPECT_TRUE(inArena(values[0]));
+  EXPECT_TRUE(inArena(values[1]));
+  EXPECT_EQ(str, values[1].toString());
+  values[2] = str;
+  EXPECT_TRUE(inArena(values[2]));
+
+  // assigning an arena element to a plain variant copies it into the default resource
+  plain = values[0];
+  EXPECT_FALSE(inArena(plain));
+  Variant moved(42);
+  moved = std::move(values[1]);
+  EXPECT_FALSE(inArena(moved));
+  EXPECT_EQ(std::pmr::get_default_resource(), moved.memoryResource());
+  EXPECT_EQ(str, moved.toString());
+
+  // moving between elements of the same arena takes the value over
+  auto const* chars = values[0].asStringView().data();
+  values[1] = std::move(values[0]);
+  EXPECT_EQ(chars, values[1].asStringView().data());
+  EXPECT_TRUE(values[0].isMonostate());
+
+  // a bound variant keeps its resource when a value of another resource is moved in
+  std::pmr::monotonic_buffer_resource other;
+  Variant elsewhere(str, &other);
+  elsewhere = std::move(moved);
+  EXPECT_EQ(&other, elsewhere.memoryResource());
+  EXPECT_EQ(str, elsewhere.toString());
+}
+
+TEST_F(VariantTests, testTryGetAndAsStringView)
+{
+  Variant vDouble(2.5);
+  ASSERT_NE(nullptr, vDouble.tryGet<double>());
+  ASSERT_EQ(2.5, *vDouble.tryGet<double>());
+  // no conversion takes place
+  ASSERT_EQ(nullptr, vDouble.tryGet<label_t>());
+  ASSERT_EQ(nullptr, Variant().tryGet<bool>());
+
+  std::string str = "A string which is too long to be stored inline.";
+  Variant vString(str);
+  ASSERT_EQ(str, vString.asStringView());
+  ASSERT_EQ("short", Variant("short").asStringView());
+  D_EXPECT_THROW(vDouble.asStringView(), "does not hold a std::string");
+}
+
+TEST_F(VariantTests, testVisit)
+{
+  auto describe = [](Variant const& v) {
+    return v.visit(Overload{[](std::monostate) { return std::string("empty"); },
+                            [](std::string_view s) { return "string " + std::string(s); },
+                            [](double const& d) { return d > 1.0 ? std::string("large double") : std::string("double"); },
+                            [](auto const&) { return std::string("other"); }});
+  };
+  ASSERT_EQ("empty", describe(Variant()));
+  ASSERT_EQ("string abc", describe(Variant("abc")));
+  ASSERT_EQ("large double", describe(Variant(1.5)));
+  ASSERT_EQ("other", describe(Variant(7)));
+
+  // handlers receive references to the stored value itself
+  Variant v(std::int64_t(3));
+  v.visit([&v](auto const& value) {
+    using T = std::decay_t<decltype(value)>;
+    if constexpr (std::is_same_v<T, std::int64_t>) {
+      ASSERT_EQ(&value, v.tryGet<std::int64_t>());
+    }
+  });
+}
+
+TEST_F(VariantTests, testHashIsConsistentWithEquality)
+{
+  std::hash<Variant> hasher;
+  EXPECT_EQ(hasher(Variant(1.5)), hasher(Variant(1.5)));
+  EXPECT_EQ(hasher(Variant(0.0)), hasher(Variant(-0.0)));
+  EXPECT_EQ(hasher(Variant("A string which is too long to be stored inline.")),
+            hasher(Variant(std::string("A string which is too long to be stored inline."))));
+  EXPECT_EQ(hasher(Variant()), hasher(Variant()));
+  // equal values of different types are different variants
+  EXPECT_NE(hasher(Variant(1)), hasher(Variant(std::int64_t(1))));
+  EXPECT_NE(hasher(Variant(1)), hasher(Variant(2)));
+
+  // all NaNs are equal, whatever their sign and payload
+  double const nan = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_EQ(Variant(nan), Variant(nan));
+  EXPECT_EQ(Variant(nan), Variant(-nan));
+  EXPECT_EQ(Variant(nan), Variant(std::numeric_limits<double>::signaling_NaN()));
+  EXPECT_NE(Variant(nan), Variant(std::numeric_limits<double>::infinity()));
+  EXPECT_EQ(hasher(Variant(nan)), hasher(Variant(-nan)));
+  EXPECT_EQ(hasher(Variant(nan)), hasher(Variant(std::numeric_limits<double>::signaling_NaN())));
+
+  std::unordered_map<Variant, int> map;
+  map[Variant("a")] = 1;
+  map[Variant(2)] = 2;
+  map[Variant("a")] += 10;
+  EXPECT_EQ(2u, map.size());
+  EXPECT_EQ(11, map[Variant("a")]);
+}
+
+TEST_F(VariantTests, testTotalOrder)
+{
+  // ordered by type first
+  EXPECT_LT(Variant(), Variant(1));
+  EXPECT_LT(Variant(100), Variant(std::int64_t(1)));
+  EXPECT_LT(Variant(1.0), Variant("0"));
+
+  // ordered by value second
+  EXPECT_LT(Variant(-1), Variant(1));
+  EXPECT_LT(Variant("abc"), Variant("abd"));
+  EXPECT_LT(Variant("short"), Variant("short but longer than the inline capacity"));
+  EXPECT_GT(Variant(2.0), Variant(1.0));
+  EXPECT_LE(Variant(1.0), Variant(1.0));
+  EXPECT_GE(Variant(1.0), Variant(1.0));
+  EXPECT_FALSE(Variant(0.0) < Variant(-0.0));
+  EXPECT_FALSE(Variant(-0.0) < Variant(0.0));
+
+  // NaN is greater than any other double
+  double const nan = std::numeric_limits<double>::quiet_NaN();
+  double const inf = std::numeric_limits<double>::infinity();
+  EXPECT_LT(Variant(inf), Variant(nan));
+  EXPECT_FALSE(Variant(nan) < Variant(nan));
+  EXPECT_FALSE(Variant(nan) < Variant(-nan) || Variant(-nan) < Variant(nan));
+
+  std::vector<Variant> values{Variant("b"), Variant(3), Variant(), Variant(2.5), Variant("a"),
+                              Variant(1)};
+  std::sort(values.begin(), values.end());
+  std::vector<Variant> expected{Variant(), Variant(1), Variant(3), Variant(2.5), Variant("a"),
+                                Variant("b")};
+  EXPECT_EQ(expected, values);
+}
+
+TEST_F(VariantTests, testNamedEnumIsStoredByOrdinal)
+{
+  using namespace LIBD::TESTS;
+
+  Variant var{TestDummy::COLOR::BLUE};
+  EXPECT_TRUE(var.isEnum());
+  EXPECT_FALSE(var.isString());
+  EXPECT_EQ(var.enumTypeInfo(), &TestDummy::COLOR::getTypeInfo());
+  EXPECT_EQ(var.enumOrdinal(), 1u);
+  EXPECT_EQ(var.asStringView(), "BLUE");
+  EXPECT_EQ(var.getAs<std::string>().second, "BLUE");
+  EXPECT_EQ(Variant().enumTypeInfo(), nullptr);
+
+  // equality, order and hash use the name, enums equal strings holding their name
+  EXPECT_EQ(var, Variant(TestDummy::COLOR(TestDummy::COLOR::BLUE)));
+  EXPECT_NE(var, Variant(TestDummy::COLOR::GREEN));
+  EXPECT_EQ(var, Variant("BLUE"));
+  EXPECT_EQ(Variant("BLUE"), var);
+  EXPECT_NE(var, Variant("RED"));
+  EXPECT_NE(var, Variant(10));
+  EXPECT_LT(var, Variant(TestDummy::COLOR::GREEN));
+  EXPECT_LT(Variant("BLACK"), var);
+  EXPECT_LT(var, Variant("CYAN"));
+  EXPECT_GT(Variant(TestDummy::COLOR::RED), Variant(TestDummy::COLOR::GREEN));
+  EXPECT_FALSE(var < Variant("BLUE") || Variant("BLUE") < var);
+  EXPECT_LT(Variant(1.0), var);
+  EXPECT_EQ(var.hash(), Variant(TestDummy::COLOR::BLUE).hash());
+  EXPECT_EQ(var.hash(), Variant("BLUE").hash());
+
+  // regain the enum from the ordinal, from a string and from an empty string
+  EXPECT_EQ(TestDummy::COLOR(var), TestDummy::COLOR::BLUE);
+  EXPECT_EQ(TestDummy::COLOR(Variant(" GREEN ")), TestDummy::COLOR::GREEN);
+  EXPECT_EQ(TestDummy::COLOR(Variant("")), TestDummy::COLOR::RED);
+  D_EXPECT_THROW(TestDummy::WEEKDAY{var}, "is not registered as an enum value");
+  D_EXPECT_THROW(TestDummy::WEEKDAY{Variant(3)}, "does not hold a std::string value");
+
+  // converting into Type::ENUM is not possible without the enum type
+  Variant copy = var;
+  EXPECT_EQ(copy.convertTo(Variant::Type::ENUM), var);
+  EXPECT_EQ(copy.convertTo(Variant::Type::STRING), Variant("BLUE"));
+}
@@ -28,3 +28,13 @@ std::size_t TestBase::getNumberOfConcreteClassesForInterface(std::string const &
     auto range = DGLOBALS::getInterfaceMap()->equal_range(interface);
     return std::distance(range.first, range.second);
 }
+
+std::vector<double> TestBase::makeSeries(std::size_t rows, std::size_t cols, double offset, std::size_t period,
+                                         double step, double columnStep)
+{
+    std::vector<double> values(rows * cols);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        values[i] = offset + double((i * 7919) % period) * step + double(i % cols) * columnStep;
+    }
+    return values;
+}
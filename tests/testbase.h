@@ -4,6 +4,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <vector>
 
 class TestBase : public ::testing::Test
 {
@@ -20,6 +21,13 @@ class TestBase : public ::testing::Test
   static std::size_t getNumberOfRegisteredInterfaces() noexcept;
   static std::size_t getNumberOfConcreteClassesForInterface(std::string const& interface) noexcept;
 
+  /*! \brief Return rows * cols deterministic values that vary irregularly over rows and columns.
+     *
+     * Value i is offset + step * ((i * 7919) % period) + columnStep * (i % cols), e.g. to fill Datasets.
+     */
+  static std::vector<double> makeSeries(std::size_t rows, std::size_t cols, double offset, std::size_t period,
+                                        double step, double columnStep);
+
   protected:
   //! Read the given file into the result string.
   //static bool slurpFile(std::string const& fileName, std::string& result);